@@ -0,0 +1,101 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+#ifndef OPARI2_LIB_H
+#define OPARI2_LIB_H
+
+/** @file
+ *
+ *  @brief      C++ interface of libopari2, which instruments a source
+ *              file held in memory like the opari2 command does for a
+ *              file on disk.
+ *
+ *              Options are set with OPARI2_SetOption() and apply to
+ *              all following calls of OPARI2_Instrument() until
+ *              OPARI2_ResetOptions() is called. The library keeps
+ *              global state, so it must not be called from several
+ *              threads at once. Error messages are printed to stderr.
+ */
+
+#include <string>
+
+/**
+ * @brief Applies an opari2 command line option to all following
+ *        OPARI2_Instrument() calls.
+ *
+ * All options of the opari2 command are accepted except for the file
+ * arguments, --help, --version and --stats, e.g. "--nosrc",
+ * "--omp-tpd" or "--disable=omp:atomic". Options stay set until
+ * OPARI2_ResetOptions() is called.
+ *
+ * @param option  The option, including the leading dashes.
+ *
+ * @return 0 on success, 1 if the option or its value is invalid, 2 if
+ *         the option is unknown.
+ */
+int
+OPARI2_SetOption( const std::string& option );
+
+/**
+ * @brief Restores the default of all options, as if OPARI2_SetOption()
+ *        had never been called.
+ */
+void
+OPARI2_ResetOptions( void );
+
+/**
+ * @brief Instruments a source file held in memory.
+ *
+ * @param infile   Name of the source file. It is used in line
+ *                 directives, for the name of the include file and to
+ *                 determine the language if no language option is
+ *                 set. The file does not need to exist.
+ * @param source   Text of the source file.
+ * @param output   Receives the instrumented source.
+ * @param include  Receives the text of the include file, which the
+ *                 instrumented source includes as
+ *                 <basename of infile>.opari.inc.
+ * @param outfile  Name the instrumented source will be written to. Only
+ *                 its directory is used, for the include directive
+ *                 inserted into preprocessed files.
+ *
+ * @return 0 on success, 1 if the file could not be instrumented. In
+ *         that case an error message has been printed, @p output and
+ *         @p include are left unchanged and the options stay set. The
+ *         state of the failed file is discarded by the next call, so
+ *         the library can be used further.
+ */
+int
+OPARI2_Instrument( const std::string& infile,
+                   const std::string& source,
+                   std::string&       output,
+                   std::string&       include,
+                   const std::string& outfile = "" );
+
+#endif /* OPARI2_LIB_H */
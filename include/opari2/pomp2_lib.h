@@ -199,6 +199,21 @@ extern void
 POMP2_Implicit_barrier_exit( POMP2_Region_handle* pomp2_handle,
                              POMP2_Task_handle    pomp2_old_task );
 
+/** Called instead of POMP2_Implicit_barrier_enter() and
+    POMP2_Implicit_barrier_exit() by code instrumented with
+    --omp-barrier-timestamp. Only marks the arrival of the calling
+    thread at the implicit barrier of a construct; neither the time
+    spent in the barrier nor task ids are recorded. The arrival times
+    of all threads still give the load imbalance of the construct.
+    As no exit event follows the barrier, the adapter has to resume the
+    task that was current before a task executed in the barrier began
+    when that task ends, see POMP2_Task_end().
+
+    @param pomp2_handle   The handle of the region.
+ */
+extern void
+POMP2_Implicit_barrier_arrive( POMP2_Region_handle* pomp2_handle );
+
 
 /** Called before an flush.
 
@@ -465,7 +480,8 @@ extern void
 POMP2_Task_begin( POMP2_Region_handle* pomp2_handle,
                   POMP2_Task_handle    pomp2_task );
 
-/** \e OpenMP \e 3.0: Marks the end of the execution of a task.
+/** \e OpenMP \e 3.0: Marks the end of the execution of a task. The
+    adapter resumes the task that was current when the task began.
 
     @param pomp2_handle The region handle.
  */
@@ -563,6 +579,264 @@ extern void
 POMP2_Taskwait_end( POMP2_Region_handle* pomp2_handle,
                     POMP2_Task_handle    pomp2_old_task );
 
+/** \e OpenMP \e 4.5: Called before a taskloop region by the task
+    encountering the construct. The tasks generated for the loop
+    chunks are not instrumented individually.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Taskloop_enter( POMP2_Region_handle* pomp2_handle,
+                      const char           ctc_string[] );
+
+/** \e OpenMP \e 4.5: Called after a taskloop region, i.e. after the
+    implicit taskgroup of the construct unless nogroup is given.
+    @param pomp2_handle  The handle of the region.
+ */
+extern void
+POMP2_Taskloop_exit( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Called before a simd loop.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Simd_enter( POMP2_Region_handle* pomp2_handle,
+                  const char           ctc_string[] );
+
+/** \e OpenMP \e 4.0: Called after a simd loop.
+    @param pomp2_handle  The handle of the region.
+ */
+extern void
+POMP2_Simd_exit( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Called before a teams region.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Teams_enter( POMP2_Region_handle* pomp2_handle,
+                   const char           ctc_string[] );
+
+/** \e OpenMP \e 4.0: Called after a teams region.
+    @param pomp2_handle  The handle of the region.
+ */
+extern void
+POMP2_Teams_exit( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Called before a distribute loop.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Distribute_enter( POMP2_Region_handle* pomp2_handle,
+                        const char           ctc_string[] );
+
+/** \e OpenMP \e 4.0: Called after a distribute loop.
+    @param pomp2_handle  The handle of the region.
+ */
+extern void
+POMP2_Distribute_exit( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Called on the host before a target region. The
+    code executed on the device is not instrumented.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Target_enter( POMP2_Region_handle* pomp2_handle,
+                    const char           ctc_string[] );
+
+/** \e OpenMP \e 4.0: Called on the host after a target region.
+    @param pomp2_handle  The handle of the region.
+ */
+extern void
+POMP2_Target_exit( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Called before a taskgroup region. As the end of
+    a taskgroup is a scheduling point, the id of the current task is
+    saved in \e pomp2_old_task like for a taskwait.
+    @param pomp2_handle   The handle of the region.
+    @param pomp2_old_task Pointer to a "taskprivate" variable where
+                          the current task id is stored.
+    @param ctc_string     Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Taskgroup_enter( POMP2_Region_handle* pomp2_handle,
+                       POMP2_Task_handle*   pomp2_old_task,
+                       const char           ctc_string[] );
+
+/** \e OpenMP \e 4.0: Marks the start of the structured block of a
+    taskgroup region.
+    @param pomp2_handle The handle of the region.
+ */
+extern void
+POMP2_Taskgroup_begin( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Marks the end of the structured block of a
+    taskgroup region. The time until POMP2_Taskgroup_exit() is spent
+    waiting for the completion of the tasks of the taskgroup.
+    @param pomp2_handle The handle of the region.
+ */
+extern void
+POMP2_Taskgroup_end( POMP2_Region_handle* pomp2_handle );
+
+/** \e OpenMP \e 4.0: Called after a taskgroup region.
+    @param pomp2_handle   The handle of the region.
+    @param pomp2_old_task "Taskprivate" variable storing the id of the
+                          task the taskgroup is located in.
+ */
+extern void
+POMP2_Taskgroup_exit( POMP2_Region_handle* pomp2_handle,
+                      POMP2_Task_handle    pomp2_old_task );
+
+/** \e OpenMP \e 3.1: Called before a taskyield. The current task may
+    be suspended, so its id is saved like for a taskwait.
+    @param pomp2_handle   The handle of the region.
+    @param pomp2_old_task Pointer to a "taskprivate" variable where
+                          the current task id is stored.
+    @param ctc_string     Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Taskyield_begin( POMP2_Region_handle* pomp2_handle,
+                       POMP2_Task_handle*   pomp2_old_task,
+                       const char           ctc_string[] );
+
+/** \e OpenMP \e 3.1: Called after a taskyield.
+    @param pomp2_handle   The handle of the region.
+    @param pomp2_old_task "Taskprivate" variable storing the id of the
+                          task the taskyield is located in.
+ */
+extern void
+POMP2_Taskyield_end( POMP2_Region_handle* pomp2_handle,
+                     POMP2_Task_handle    pomp2_old_task );
+
+/** \e OpenMP \e 4.0: Called before a cancel directive. If
+    cancellation is activated, the thread continues at the end of the
+    cancelled region, so there is no matching event after the
+    directive.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Cancel_request( POMP2_Region_handle* pomp2_handle,
+                      const char           ctc_string[] );
+
+/** \e OpenMP \e 4.0: Called before a cancellation point directive. As
+    for POMP2_Cancel_request(), there is no matching event after the
+    directive.
+    @param pomp2_handle The handle of the region.
+    @param ctc_string   Initialization string. May be ignored if
+   \<pomp2_handle\> is already initialized.
+ */
+extern void
+POMP2_Cancellation_point_check( POMP2_Region_handle* pomp2_handle,
+                                const char           ctc_string[] );
+
+/** @name Events without compile time context
+ *
+ *  Variants of all events that take a CTC string, used by code
+ *  instrumented with --omp-ctc-at-init. The CTC string is only passed
+ *  to POMP2_Assign_handle(), so the handle is expected to be assigned
+ *  by POMP2_Init() before the first event occurs and does not need to
+ *  be checked on each call. The parameters are the same as for the
+ *  respective events without the @a ctc_string.
+ */
+/*@{*/
+extern void
+POMP2_Atomic_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Barrier_enter_no_ctc( POMP2_Region_handle* pomp2_handle,
+                            POMP2_Task_handle*   pomp2_old_task );
+
+extern void
+POMP2_Flush_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Critical_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_For_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Master_begin_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Parallel_fork_no_ctc( POMP2_Region_handle* pomp2_handle,
+                            int                  if_clause,
+                            int                  num_threads,
+                            POMP2_Task_handle*   pomp2_old_task );
+
+extern void
+POMP2_Section_begin_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Sections_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Single_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Workshare_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Ordered_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Task_create_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                                POMP2_Task_handle*   pomp2_new_task,
+                                POMP2_Task_handle*   pomp2_old_task,
+                                int                  pomp2_if );
+
+extern void
+POMP2_Untied_task_create_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                                       POMP2_Task_handle*   pomp2_new_task,
+                                       POMP2_Task_handle*   pomp2_old_task,
+                                       int                  pomp2_if );
+
+extern void
+POMP2_Taskwait_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                             POMP2_Task_handle*   pomp2_old_task );
+
+extern void
+POMP2_Taskloop_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Simd_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Teams_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Distribute_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Target_enter_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Taskgroup_enter_no_ctc( POMP2_Region_handle* pomp2_handle,
+                              POMP2_Task_handle*   pomp2_old_task );
+
+extern void
+POMP2_Taskyield_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                              POMP2_Task_handle*   pomp2_old_task );
+
+extern void
+POMP2_Cancel_request_no_ctc( POMP2_Region_handle* pomp2_handle );
+
+extern void
+POMP2_Cancellation_point_check_no_ctc( POMP2_Region_handle* pomp2_handle );
+/*@}*/
+
 /** Wraps the omp_get_max_threads function.
  *
  *  Needed for the instrumentation of parallel regions
@@ -625,6 +899,88 @@ POMP2_Unset_nest_lock( omp_nest_lock_t* s );
 extern int
 POMP2_Test_nest_lock( omp_nest_lock_t* s );
 
+/** Wraps the omp_set_num_threads function.
+ *  @param num_threads The requested number of threads.*/
+extern void
+POMP2_Set_num_threads( int num_threads );
+
+/** Wraps the omp_get_wtime function.
+ *  @return result of omp_get_wtime*/
+extern double
+POMP2_Get_wtime( void );
+
+/* The following runtime functions were introduced with OpenMP 4.5
+   and 5.0. If the OpenMP implementation does not provide them, the
+   wrapper names fall back to the original functions, so that code
+   instrumented by OPARI2 still compiles. */
+#if _OPENMP >= 201511
+
+/** \e OpenMP \e 4.5: Wraps the omp_init_lock_with_hint function.
+ *  @param s    The OpenMP lock to initialize.
+ *  @param hint The synchronization hint for the lock.*/
+extern void
+POMP2_Init_lock_with_hint( omp_lock_t*     s,
+                           omp_lock_hint_t hint );
+
+/** \e OpenMP \e 4.5: Wraps the omp_init_nest_lock_with_hint function.
+ *  @param s    The nested OpenMP lock to initialize.
+ *  @param hint The synchronization hint for the lock.*/
+extern void
+POMP2_Init_nest_lock_with_hint( omp_nest_lock_t* s,
+                                omp_lock_hint_t  hint );
+
+/** \e OpenMP \e 4.5: Wraps the omp_target_memcpy function.
+ *  @param dst            Destination address.
+ *  @param src            Source address.
+ *  @param length         Number of bytes to copy.
+ *  @param dst_offset     Offset in bytes into the destination.
+ *  @param src_offset     Offset in bytes into the source.
+ *  @param dst_device_num Device number of the destination.
+ *  @param src_device_num Device number of the source.
+ *  @return result of omp_target_memcpy*/
+extern int
+POMP2_Target_memcpy( void*       dst,
+                     const void* src,
+                     size_t      length,
+                     size_t      dst_offset,
+                     size_t      src_offset,
+                     int         dst_device_num,
+                     int         src_device_num );
+
+#else
+#define POMP2_Init_lock_with_hint omp_init_lock_with_hint
+#define POMP2_Init_nest_lock_with_hint omp_init_nest_lock_with_hint
+#define POMP2_Target_memcpy omp_target_memcpy
+#endif /* _OPENMP >= 201511 */
+
+#if _OPENMP >= 201811 || defined( __GOMP_DEFAULT_NULL_ALLOCATOR )
+
+#ifdef __cplusplus
+#define POMP2_DEFAULT_NULL_ALLOCATOR = omp_null_allocator
+#else
+#define POMP2_DEFAULT_NULL_ALLOCATOR
+#endif
+
+/** \e OpenMP \e 5.0: Wraps the omp_alloc function.
+ *  @param size      Number of bytes to allocate.
+ *  @param allocator The allocator to allocate from.
+ *  @return result of omp_alloc*/
+extern void*
+POMP2_Alloc( size_t                 size,
+             omp_allocator_handle_t allocator POMP2_DEFAULT_NULL_ALLOCATOR );
+
+/** \e OpenMP \e 5.0: Wraps the omp_free function.
+ *  @param ptr       The memory to release.
+ *  @param allocator The allocator \<ptr\> was allocated from.*/
+extern void
+POMP2_Free( void*                  ptr,
+            omp_allocator_handle_t allocator POMP2_DEFAULT_NULL_ALLOCATOR );
+
+#else
+#define POMP2_Alloc omp_alloc
+#define POMP2_Free omp_free
+#endif /* _OPENMP >= 201811 */
+
 #endif /* _OPENMP */
 
 #ifdef __cplusplus
@@ -66,6 +66,7 @@ static char* header =
     "#define POMP2_Atomic_exit_U	POMP2_ATOMIC_EXIT\n"
     "#define POMP2_Implicit_barrier_enter_U	POMP2_IMPLICIT_BARRIER_ENTER\n"
     "#define POMP2_Implicit_barrier_exit_U	POMP2_IMPLICIT_BARRIER_EXIT\n"
+    "#define POMP2_Implicit_barrier_arrive_U	POMP2_IMPLICIT_BARRIER_ARRIVE\n"
     "#define POMP2_Barrier_enter_U	POMP2_BARRIER_ENTER\n"
     "#define POMP2_Barrier_exit_U	POMP2_BARRIER_EXIT\n"
     "#define POMP2_Flush_enter_U	POMP2_FLUSH_ENTER\n"
@@ -111,6 +112,49 @@ static char* header =
     "#define POMP2_Taskwait_end_U       POMP2_TASKWAIT_END\n"
     "#define POMP2_Workshare_enter_U	POMP2_WORKSHARE_ENTER\n"
     "#define POMP2_Workshare_exit_U	POMP2_WORKSHARE_EXIT\n"
+    "#define POMP2_Taskloop_enter_U	POMP2_TASKLOOP_ENTER\n"
+    "#define POMP2_Taskloop_exit_U	POMP2_TASKLOOP_EXIT\n"
+    "#define POMP2_Simd_enter_U	POMP2_SIMD_ENTER\n"
+    "#define POMP2_Simd_exit_U	POMP2_SIMD_EXIT\n"
+    "#define POMP2_Teams_enter_U	POMP2_TEAMS_ENTER\n"
+    "#define POMP2_Teams_exit_U	POMP2_TEAMS_EXIT\n"
+    "#define POMP2_Distribute_enter_U	POMP2_DISTRIBUTE_ENTER\n"
+    "#define POMP2_Distribute_exit_U	POMP2_DISTRIBUTE_EXIT\n"
+    "#define POMP2_Target_enter_U	POMP2_TARGET_ENTER\n"
+    "#define POMP2_Target_exit_U	POMP2_TARGET_EXIT\n"
+    "#define POMP2_Taskgroup_enter_U	POMP2_TASKGROUP_ENTER\n"
+    "#define POMP2_Taskgroup_begin_U	POMP2_TASKGROUP_BEGIN\n"
+    "#define POMP2_Taskgroup_end_U	POMP2_TASKGROUP_END\n"
+    "#define POMP2_Taskgroup_exit_U	POMP2_TASKGROUP_EXIT\n"
+    "#define POMP2_Taskyield_begin_U	POMP2_TASKYIELD_BEGIN\n"
+    "#define POMP2_Taskyield_end_U	POMP2_TASKYIELD_END\n"
+    "#define POMP2_Cancel_request_U	POMP2_CANCEL_REQUEST\n"
+    "#define POMP2_Cancellation_point_check_U	POMP2_CANCELLATION_POINT_CHECK\n"
+
+    "#define POMP2_Atomic_enter_no_ctc_U	POMP2_ATOMIC_ENTER_NO_CTC\n"
+    "#define POMP2_Barrier_enter_no_ctc_U	POMP2_BARRIER_ENTER_NO_CTC\n"
+    "#define POMP2_Flush_enter_no_ctc_U	POMP2_FLUSH_ENTER_NO_CTC\n"
+    "#define POMP2_Critical_enter_no_ctc_U	POMP2_CRITICAL_ENTER_NO_CTC\n"
+    "#define POMP2_Do_enter_no_ctc_U	POMP2_DO_ENTER_NO_CTC\n"
+    "#define POMP2_Master_begin_no_ctc_U	POMP2_MASTER_BEGIN_NO_CTC\n"
+    "#define POMP2_Parallel_fork_no_ctc_U	POMP2_PARALLEL_FORK_NO_CTC\n"
+    "#define POMP2_Section_begin_no_ctc_U	POMP2_SECTION_BEGIN_NO_CTC\n"
+    "#define POMP2_Sections_enter_no_ctc_U	POMP2_SECTIONS_ENTER_NO_CTC\n"
+    "#define POMP2_Single_enter_no_ctc_U	POMP2_SINGLE_ENTER_NO_CTC\n"
+    "#define POMP2_Workshare_enter_no_ctc_U	POMP2_WORKSHARE_ENTER_NO_CTC\n"
+    "#define POMP2_Ordered_enter_no_ctc_U	POMP2_ORDERED_ENTER_NO_CTC\n"
+    "#define POMP2_Task_create_begin_no_ctc_U	POMP2_TASK_CREATE_BEGIN_NO_CTC\n"
+    "#define POMP2_Untied_task_create_begin_no_ctc_U	POMP2_UNTIED_TASK_CREATE_BEGIN_NO_CTC\n"
+    "#define POMP2_Taskwait_begin_no_ctc_U	POMP2_TASKWAIT_BEGIN_NO_CTC\n"
+    "#define POMP2_Taskloop_enter_no_ctc_U	POMP2_TASKLOOP_ENTER_NO_CTC\n"
+    "#define POMP2_Simd_enter_no_ctc_U	POMP2_SIMD_ENTER_NO_CTC\n"
+    "#define POMP2_Teams_enter_no_ctc_U	POMP2_TEAMS_ENTER_NO_CTC\n"
+    "#define POMP2_Distribute_enter_no_ctc_U	POMP2_DISTRIBUTE_ENTER_NO_CTC\n"
+    "#define POMP2_Target_enter_no_ctc_U	POMP2_TARGET_ENTER_NO_CTC\n"
+    "#define POMP2_Taskgroup_enter_no_ctc_U	POMP2_TASKGROUP_ENTER_NO_CTC\n"
+    "#define POMP2_Taskyield_begin_no_ctc_U	POMP2_TASKYIELD_BEGIN_NO_CTC\n"
+    "#define POMP2_Cancel_request_no_ctc_U	POMP2_CANCEL_REQUEST_NO_CTC\n"
+    "#define POMP2_Cancellation_point_check_no_ctc_U	POMP2_CANCELLATION_POINT_CHECK_NO_CTC\n"
 
     "#define POMP2_Begin_U		POMP2_BEGIN\n"
     "#define POMP2_End_U		POMP2_END\n"
@@ -126,6 +170,9 @@ static char* header =
     "#define POMP2_Set_nest_lock_U	POMP2_SET_NEST_LOCK\n"
     "#define POMP2_Unset_nest_lock_U	POMP2_UNSET_NEST_LOCK\n"
     "#define POMP2_Test_nest_lock_U	POMP2_TEST_NEST_LOCK\n"
+    "#define POMP2_Init_lock_with_hint_U	POMP2_INIT_LOCK_WITH_HINT\n"
+    "#define POMP2_Init_nest_lock_with_hint_U	POMP2_INIT_NEST_LOCK_WITH_HINT\n"
+    "#define POMP2_Set_num_threads_U	POMP2_SET_NUM_THREADS\n"
     "#define POMP2_Assign_handle_U	POMP2_ASSIGN_HANDLE\n"
     "#define POMP2_USER_Assign_handle_U	POMP2_USER_ASSIGN_HANDLE\n"
     "#define omp_init_lock_U		OMP_INIT_LOCK\n"
@@ -147,6 +194,7 @@ static char* header =
     "#define POMP2_Atomic_exit_L	pomp2_atomic_exit\n"
     "#define POMP2_Implicit_barrier_enter_L	pomp2_implicit_barrier_enter\n"
     "#define POMP2_Implicit_barrier_exit_L	pomp2_implicit_barrier_exit\n"
+    "#define POMP2_Implicit_barrier_arrive_L	pomp2_implicit_barrier_arrive\n"
     "#define POMP2_Barrier_enter_L	pomp2_barrier_enter\n"
     "#define POMP2_Barrier_exit_L	pomp2_barrier_exit\n"
     "#define POMP2_Flush_enter_L	pomp2_flush_enter\n"
@@ -192,6 +240,49 @@ static char* header =
     "#define POMP2_Taskwait_end_L       pomp2_taskwait_end\n"
     "#define POMP2_Workshare_enter_L	pomp2_workshare_enter\n"
     "#define POMP2_Workshare_exit_L	pomp2_workshare_exit\n"
+    "#define POMP2_Taskloop_enter_L	pomp2_taskloop_enter\n"
+    "#define POMP2_Taskloop_exit_L	pomp2_taskloop_exit\n"
+    "#define POMP2_Simd_enter_L	pomp2_simd_enter\n"
+    "#define POMP2_Simd_exit_L	pomp2_simd_exit\n"
+    "#define POMP2_Teams_enter_L	pomp2_teams_enter\n"
+    "#define POMP2_Teams_exit_L	pomp2_teams_exit\n"
+    "#define POMP2_Distribute_enter_L	pomp2_distribute_enter\n"
+    "#define POMP2_Distribute_exit_L	pomp2_distribute_exit\n"
+    "#define POMP2_Target_enter_L	pomp2_target_enter\n"
+    "#define POMP2_Target_exit_L	pomp2_target_exit\n"
+    "#define POMP2_Taskgroup_enter_L	pomp2_taskgroup_enter\n"
+    "#define POMP2_Taskgroup_begin_L	pomp2_taskgroup_begin\n"
+    "#define POMP2_Taskgroup_end_L	pomp2_taskgroup_end\n"
+    "#define POMP2_Taskgroup_exit_L	pomp2_taskgroup_exit\n"
+    "#define POMP2_Taskyield_begin_L	pomp2_taskyield_begin\n"
+    "#define POMP2_Taskyield_end_L	pomp2_taskyield_end\n"
+    "#define POMP2_Cancel_request_L	pomp2_cancel_request\n"
+    "#define POMP2_Cancellation_point_check_L	pomp2_cancellation_point_check\n"
+
+    "#define POMP2_Atomic_enter_no_ctc_L	pomp2_atomic_enter_no_ctc\n"
+    "#define POMP2_Barrier_enter_no_ctc_L	pomp2_barrier_enter_no_ctc\n"
+    "#define POMP2_Flush_enter_no_ctc_L	pomp2_flush_enter_no_ctc\n"
+    "#define POMP2_Critical_enter_no_ctc_L	pomp2_critical_enter_no_ctc\n"
+    "#define POMP2_Do_enter_no_ctc_L	pomp2_do_enter_no_ctc\n"
+    "#define POMP2_Master_begin_no_ctc_L	pomp2_master_begin_no_ctc\n"
+    "#define POMP2_Parallel_fork_no_ctc_L	pomp2_parallel_fork_no_ctc\n"
+    "#define POMP2_Section_begin_no_ctc_L	pomp2_section_begin_no_ctc\n"
+    "#define POMP2_Sections_enter_no_ctc_L	pomp2_sections_enter_no_ctc\n"
+    "#define POMP2_Single_enter_no_ctc_L	pomp2_single_enter_no_ctc\n"
+    "#define POMP2_Workshare_enter_no_ctc_L	pomp2_workshare_enter_no_ctc\n"
+    "#define POMP2_Ordered_enter_no_ctc_L	pomp2_ordered_enter_no_ctc\n"
+    "#define POMP2_Task_create_begin_no_ctc_L	pomp2_task_create_begin_no_ctc\n"
+    "#define POMP2_Untied_task_create_begin_no_ctc_L	pomp2_untied_task_create_begin_no_ctc\n"
+    "#define POMP2_Taskwait_begin_no_ctc_L	pomp2_taskwait_begin_no_ctc\n"
+    "#define POMP2_Taskloop_enter_no_ctc_L	pomp2_taskloop_enter_no_ctc\n"
+    "#define POMP2_Simd_enter_no_ctc_L	pomp2_simd_enter_no_ctc\n"
+    "#define POMP2_Teams_enter_no_ctc_L	pomp2_teams_enter_no_ctc\n"
+    "#define POMP2_Distribute_enter_no_ctc_L	pomp2_distribute_enter_no_ctc\n"
+    "#define POMP2_Target_enter_no_ctc_L	pomp2_target_enter_no_ctc\n"
+    "#define POMP2_Taskgroup_enter_no_ctc_L	pomp2_taskgroup_enter_no_ctc\n"
+    "#define POMP2_Taskyield_begin_no_ctc_L	pomp2_taskyield_begin_no_ctc\n"
+    "#define POMP2_Cancel_request_no_ctc_L	pomp2_cancel_request_no_ctc\n"
+    "#define POMP2_Cancellation_point_check_no_ctc_L	pomp2_cancellation_point_check_no_ctc\n"
 
     "#define POMP2_Begin_L		pomp2_begin\n"
     "#define POMP2_End_L		pomp2_end\n"
@@ -207,6 +298,9 @@ static char* header =
     "#define POMP2_Set_nest_lock_L	pomp2_set_nest_lock\n"
     "#define POMP2_Unset_nest_lock_L	pomp2_unset_nest_lock\n"
     "#define POMP2_Test_nest_lock_L	pomp2_test_nest_lock\n"
+    "#define POMP2_Init_lock_with_hint_L	pomp2_init_lock_with_hint\n"
+    "#define POMP2_Init_nest_lock_with_hint_L	pomp2_init_nest_lock_with_hint\n"
+    "#define POMP2_Set_num_threads_L	pomp2_set_num_threads\n"
     "#define POMP2_Assign_handle_L	pomp2_assign_handle\n"
     "#define POMP2_USER_Assign_handle_L	pomp2_user_assign_handle\n"
     "#define omp_init_lock_L		omp_init_lock\n"
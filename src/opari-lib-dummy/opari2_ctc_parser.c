@@ -112,6 +112,7 @@ OPARI2_CTC_error( CTCData*       obj,
         case CTC_ERROR_Inconsistent_line_numbers:
             printf( "Warning: line numbers not valid. Expected startLineNo1 <= startLineNo2 <= endLineNo1 <= endLineNo2 \n" );
             abort = false;
+        /* fall through */
         case CTC_ERROR_SCL_error:
             printf( "Error parsing source code location, "
                     "expecting \"filename:lineNo1:lineNo2\".\n" );
@@ -194,9 +195,6 @@ OPARI2_CTC_freeAndReset( char** freeMe )
     }
 }
 
-static CTCToken
-getCTCTokenFromString( char* token );
-
 static void
 assignSourceCodeLocation( CTCData*  obj,
                           char**    fileName,
@@ -472,7 +470,7 @@ OPARI2_CTC_string2Enum( const OPARI2_CTCMapType* map,
                         const size_t             n_elements,
                         const char*              string )
 {
-    int i;
+    size_t i;
     for ( i = 0; i < n_elements; ++i )
     {
         if ( strcmp( map[ i ].mString, string ) == 0 )
@@ -490,7 +488,7 @@ OPARI2_CTC_enum2String( const OPARI2_CTCMapType* map,
                         const size_t             n_elements,
                         int                      e_in )
 {
-    int i;
+    size_t i;
     for ( i = 0; i < n_elements; ++i )
     {
         if ( e_in == map[ i ].mEnum )
@@ -73,6 +73,10 @@ void FSUB(POMP2_Implicit_barrier_exit)( POMP2_Region_handle* regionHandle,
   POMP2_Implicit_barrier_exit( regionHandle, *pomp2_old_task );
 }
 
+void FSUB(POMP2_Implicit_barrier_arrive)( POMP2_Region_handle* regionHandle ) {
+  POMP2_Implicit_barrier_arrive( regionHandle );
+}
+
 void FSUB(POMP2_Barrier_enter)( POMP2_Region_handle* regionHandle,
                                 POMP2_Task_handle*   pomp2_old_task,
                                 char*                ctc_string) {
@@ -119,6 +123,8 @@ void FSUB(POMP2_Do_exit)(POMP2_Region_handle* regionHandle ) {
 void FSUB(POMP2_Parallel_begin)( POMP2_Region_handle* regionHandle,
                                  POMP2_Task_handle*   newTask,
                                  char*                ctc_string ){
+  ( void )newTask;
+  ( void )ctc_string;
   POMP2_Parallel_begin(regionHandle);
 }
 
@@ -139,6 +145,7 @@ void FSUB(POMP2_Parallel_fork)(POMP2_Region_handle* regionHandle,
                                int*                 num_threads,
                                POMP2_Task_handle*   pomp2_old_task,
                                char*                ctc_string) {
+  ( void )ctc_string;
   POMP2_Parallel_fork(regionHandle, *if_clause, *num_threads, pomp2_old_task, "dummy");
 }
 
@@ -258,6 +265,196 @@ void FSUB(POMP2_Workshare_exit)(POMP2_Region_handle* regionHandle ) {
    POMP2_Workshare_exit(regionHandle );
 }
 
+void FSUB(POMP2_Taskloop_enter)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Taskloop_enter(regionHandle, ctc_string);
+}
+
+void FSUB(POMP2_Taskloop_exit)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Taskloop_exit(regionHandle );
+}
+
+void FSUB(POMP2_Simd_enter)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Simd_enter(regionHandle, ctc_string);
+}
+
+void FSUB(POMP2_Simd_exit)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Simd_exit(regionHandle );
+}
+
+void FSUB(POMP2_Teams_enter)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Teams_enter(regionHandle, ctc_string);
+}
+
+void FSUB(POMP2_Teams_exit)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Teams_exit(regionHandle );
+}
+
+void FSUB(POMP2_Distribute_enter)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Distribute_enter(regionHandle, ctc_string);
+}
+
+void FSUB(POMP2_Distribute_exit)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Distribute_exit(regionHandle );
+}
+
+void FSUB(POMP2_Target_enter)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Target_enter(regionHandle, ctc_string);
+}
+
+void FSUB(POMP2_Target_exit)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Target_exit(regionHandle );
+}
+
+void FSUB(POMP2_Taskgroup_enter)(POMP2_Region_handle* regionHandle,
+                                 POMP2_Task_handle*   pomp2_old_task,
+                                 char*                ctc_string ){
+  POMP2_Taskgroup_enter(regionHandle, pomp2_old_task, ctc_string );
+}
+
+void FSUB(POMP2_Taskgroup_begin)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Taskgroup_begin(regionHandle );
+}
+
+void FSUB(POMP2_Taskgroup_end)(POMP2_Region_handle* regionHandle ) {
+   POMP2_Taskgroup_end(regionHandle );
+}
+
+void FSUB(POMP2_Taskgroup_exit)(POMP2_Region_handle* regionHandle,
+                                POMP2_Task_handle*   pomp2_old_task ){
+  POMP2_Taskgroup_exit(regionHandle, *pomp2_old_task);
+}
+
+void FSUB(POMP2_Taskyield_begin)(POMP2_Region_handle* regionHandle,
+                                 POMP2_Task_handle*   pomp2_old_task,
+                                 char*                ctc_string ){
+  POMP2_Taskyield_begin(regionHandle, pomp2_old_task, ctc_string );
+}
+
+void FSUB(POMP2_Taskyield_end)(POMP2_Region_handle* regionHandle,
+                               POMP2_Task_handle*   pomp2_old_task ){
+  POMP2_Taskyield_end(regionHandle, *pomp2_old_task);
+}
+
+void FSUB(POMP2_Cancel_request)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Cancel_request(regionHandle, ctc_string);
+}
+
+void FSUB(POMP2_Cancellation_point_check)(POMP2_Region_handle* regionHandle, char* ctc_string) {
+   POMP2_Cancellation_point_check(regionHandle, ctc_string);
+}
+
+/*
+ * Events without compile time context, see --omp-ctc-at-init
+ */
+void FSUB(POMP2_Atomic_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Atomic_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Barrier_enter_no_ctc)( POMP2_Region_handle* regionHandle,
+                                       POMP2_Task_handle*   pomp2_old_task) {
+  POMP2_Barrier_enter_no_ctc( regionHandle, pomp2_old_task );
+}
+
+void FSUB(POMP2_Flush_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+  POMP2_Flush_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Critical_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Critical_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Do_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_For_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Master_begin_no_ctc)(POMP2_Region_handle* regionHandle) {
+  POMP2_Master_begin_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Parallel_fork_no_ctc)(POMP2_Region_handle* regionHandle,
+                                      int*                 if_clause,
+                                      int*                 num_threads,
+                                      POMP2_Task_handle*   pomp2_old_task) {
+  POMP2_Parallel_fork_no_ctc(regionHandle, *if_clause, *num_threads, pomp2_old_task);
+}
+
+void FSUB(POMP2_Section_begin_no_ctc)(POMP2_Region_handle* regionHandle) {
+  POMP2_Section_begin_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Sections_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Sections_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Single_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Single_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Workshare_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Workshare_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Ordered_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Ordered_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Task_create_begin_no_ctc)(POMP2_Region_handle* regionHandle,
+                                          POMP2_Task_handle*   pomp2_new_task,
+                                          POMP2_Task_handle*   pomp2_old_task,
+                                          int*                 pomp2_if){
+  POMP2_Task_create_begin_no_ctc(regionHandle, pomp2_new_task, pomp2_old_task, *pomp2_if);
+}
+
+void FSUB(POMP2_Untied_task_create_begin_no_ctc)(POMP2_Region_handle* regionHandle,
+                                                 POMP2_Task_handle*   pomp2_new_task,
+                                                 POMP2_Task_handle*   pomp2_old_task,
+                                                 int*                 pomp2_if){
+  POMP2_Task_create_begin_no_ctc(regionHandle, pomp2_new_task, pomp2_old_task, *pomp2_if);
+}
+
+void FSUB(POMP2_Taskwait_begin_no_ctc)(POMP2_Region_handle* regionHandle,
+                                       POMP2_Task_handle*   pomp2_old_task){
+  POMP2_Taskwait_begin_no_ctc(regionHandle, pomp2_old_task);
+}
+
+void FSUB(POMP2_Taskloop_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Taskloop_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Simd_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Simd_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Teams_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Teams_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Distribute_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Distribute_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Target_enter_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Target_enter_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Taskgroup_enter_no_ctc)(POMP2_Region_handle* regionHandle,
+                                        POMP2_Task_handle*   pomp2_old_task){
+  POMP2_Taskgroup_enter_no_ctc(regionHandle, pomp2_old_task);
+}
+
+void FSUB(POMP2_Taskyield_begin_no_ctc)(POMP2_Region_handle* regionHandle,
+                                        POMP2_Task_handle*   pomp2_old_task){
+  POMP2_Taskyield_begin_no_ctc(regionHandle, pomp2_old_task);
+}
+
+void FSUB(POMP2_Cancel_request_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Cancel_request_no_ctc(regionHandle);
+}
+
+void FSUB(POMP2_Cancellation_point_check_no_ctc)(POMP2_Region_handle* regionHandle) {
+   POMP2_Cancellation_point_check_no_ctc(regionHandle);
+}
+
 void FSUB(POMP2_Assign_handle)(POMP2_Region_handle* regionHandle, char* ctc_string, int ctc_string_len) {
   char *str;
   str=(char*) malloc((ctc_string_len+1)*sizeof(char));
@@ -54,6 +54,10 @@
 #include "pomp2_fwrapper_def.h"
 
 extern int pomp2_tracing;
+extern int pomp2_lock_profiling;
+extern void pomp2_lock_profile_acquire( const void* lock, int contended, double wait_start );
+extern void pomp2_lock_profile_failed_test( const void* lock );
+extern void pomp2_lock_profile_release( const void* lock );
 
 /* *INDENT-OFF*  */
 void FSUB(POMP2_Finalize)() {
@@ -112,6 +116,15 @@ void FSUB(POMP2_Set_lock)(omp_lock_t *s) {
   if ( pomp2_tracing ) {
     fprintf(stderr, "%3d: set lock\n", omp_get_thread_num());
   }
+  if ( pomp2_lock_profiling ) {
+    double start     = omp_get_wtime();
+    int    contended = !CALLFSUB(omp_test_lock)(s);
+    if ( contended ) {
+      CALLFSUB(omp_set_lock)(s);
+    }
+    pomp2_lock_profile_acquire(s, contended, start);
+    return;
+  }
   CALLFSUB(omp_set_lock)(s);
 }
 
@@ -119,14 +132,26 @@ void FSUB(POMP2_Unset_lock)(omp_lock_t *s) {
   if ( pomp2_tracing ) {
     fprintf(stderr, "%3d: unset lock\n", omp_get_thread_num());
   }
+  if ( pomp2_lock_profiling ) {
+    pomp2_lock_profile_release(s);
+  }
   CALLFSUB(omp_unset_lock)(s);
 }
 
 int  FSUB(POMP2_Test_lock)(omp_lock_t *s) {
+  int result;
   if ( pomp2_tracing ) {
     fprintf(stderr, "%3d: test lock\n", omp_get_thread_num());
   }
-  return CALLFSUB(omp_test_lock)(s);
+  result = CALLFSUB(omp_test_lock)(s);
+  if ( pomp2_lock_profiling ) {
+    if ( result ) {
+      pomp2_lock_profile_acquire(s, 0, 0.0);
+    } else {
+      pomp2_lock_profile_failed_test(s);
+    }
+  }
+  return result;
 }
 
 #ifndef __osf__
@@ -148,6 +173,15 @@ void FSUB(POMP2_Set_nest_lock)(omp_nest_lock_t *s) {
   if ( pomp2_tracing ) {
     fprintf(stderr, "%3d: set nestlock\n", omp_get_thread_num());
   }
+  if ( pomp2_lock_profiling ) {
+    double start     = omp_get_wtime();
+    int    contended = !CALLFSUB(omp_test_nest_lock)(s);
+    if ( contended ) {
+      CALLFSUB(omp_set_nest_lock)(s);
+    }
+    pomp2_lock_profile_acquire(s, contended, start);
+    return;
+  }
   CALLFSUB(omp_set_nest_lock)(s);
 }
 
@@ -155,13 +189,49 @@ void FSUB(POMP2_Unset_nest_lock)(omp_nest_lock_t *s) {
   if ( pomp2_tracing ) {
     fprintf(stderr, "%3d: unset nestlock\n", omp_get_thread_num());
   }
+  if ( pomp2_lock_profiling ) {
+    pomp2_lock_profile_release(s);
+  }
   CALLFSUB(omp_unset_nest_lock)(s);
 }
 
 int  FSUB(POMP2_Test_nest_lock)(omp_nest_lock_t *s) {
+  int result;
   if ( pomp2_tracing ) {
     fprintf(stderr, "%3d: test nestlock\n", omp_get_thread_num());
   }
-  return CALLFSUB(omp_test_nest_lock)(s);
+  result = CALLFSUB(omp_test_nest_lock)(s);
+  if ( pomp2_lock_profiling ) {
+    if ( result ) {
+      pomp2_lock_profile_acquire(s, 0, 0.0);
+    } else {
+      pomp2_lock_profile_failed_test(s);
+    }
+  }
+  return result;
+}
+#endif
+
+void FSUB(POMP2_Set_num_threads)(int *num_threads) {
+  if ( pomp2_tracing ) {
+    fprintf(stderr, "%3d: set num threads (%d)\n", omp_get_thread_num(), *num_threads);
+  }
+  omp_set_num_threads(*num_threads);
+}
+
+/* Lock hints are advisory, the dummy library only reports them. */
+void FSUB(POMP2_Init_lock_with_hint)(omp_lock_t *s, int *hint) {
+  if ( pomp2_tracing ) {
+    fprintf(stderr, "%3d: init lock with hint (%d)\n", omp_get_thread_num(), *hint);
+  }
+  CALLFSUB(omp_init_lock)(s);
+}
+
+#ifndef __osf__
+void FSUB(POMP2_Init_nest_lock_with_hint)(omp_nest_lock_t *s, int *hint) {
+  if ( pomp2_tracing ) {
+    fprintf(stderr, "%3d: init nestlock with hint (%d)\n", omp_get_thread_num(), *hint);
+  }
+  CALLFSUB(omp_init_nest_lock)(s);
 }
 #endif
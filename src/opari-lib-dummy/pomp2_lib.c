@@ -41,7 +41,17 @@
  *  @file       pomp2_lib.c
  *
  *  @brief      Dummy implementation of all POMP2 Functions. These functions
- *              only print out messages and do not measure anything.*/
+ *              only print out messages. Simple profiles can be enabled
+ *              by environment variables:
+ *              - POMP2_LOCK_PROFILING: lock contention per OpenMP lock
+ *              - POMP2_CRITICAL_PROFILING: wait and hold times per
+ *                named critical section and thread
+ *              - POMP2_TASK_PROFILING: scheduling latency and
+ *                granularity of explicit tasks
+ *              - POMP2_PARALLEL_PROFILING: fork and join latency and
+ *                arrival skew per parallel region and team size
+ *              - POMP2_LOOP_PROFILING: load imbalance and idle time of
+ *                worksharing loops per schedule type*/
 
 #include <config.h>
 #include <opari2/pomp2_lib.h>
@@ -56,6 +66,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <limits.h>
 
 /** @name Functions generated by the instrumenter */
 /*@{*/
@@ -90,7 +101,7 @@ typedef struct
 {
     /** region type of construct */
     char*  rtype;
-    /** critical or user region name */
+    /** critical or user region name, cancelled construct */
     char*  name;
     /** sections only: number of sections */
     int    num_sections;
@@ -110,6 +121,12 @@ typedef struct
     int    end_line_2;
     /** region id*/
     size_t id;
+    /** critical only: index of the critical name*/
+    int    critical_id;
+    /** set for worksharing loops*/
+    int    is_loop;
+    /** loops only: schedule type*/
+    POMP2_Schedule_type schedule;
 } my_pomp2_region;
 
 /** Id of the currently executing task*/
@@ -126,6 +143,68 @@ POMP2_Get_new_task_handle(void)
     return ( ( POMP2_Task_handle )omp_get_thread_num() << 32 ) + pomp2_task_counter++;
 }
 
+/** A task begun on this thread and the task it suspended */
+typedef struct
+{
+    POMP2_Task_handle task;
+    POMP2_Task_handle suspended;
+} pomp2_task_frame;
+
+/** Stack of the tasks executing on this thread. The end of a task
+ *  resumes the task it suspended, as no event restores the current task
+ *  after an implicit barrier instrumented with
+ *  POMP2_Implicit_barrier_arrive(). */
+static pomp2_task_frame* pomp2_task_frames      = NULL;
+static size_t            pomp2_task_frames_used = 0;
+static size_t            pomp2_task_frames_size = 0;
+#pragma omp threadprivate(pomp2_task_frames, pomp2_task_frames_used, pomp2_task_frames_size)
+
+/** Makes @a task the current task and remembers the suspended one */
+static void
+push_task_frame( POMP2_Task_handle task )
+{
+    if ( pomp2_task_frames_used == pomp2_task_frames_size )
+    {
+        size_t            size   = pomp2_task_frames_size ? 2 * pomp2_task_frames_size : 16;
+        pomp2_task_frame* frames = realloc( pomp2_task_frames, size * sizeof( pomp2_task_frame ) );
+
+        if ( frames )
+        {
+            pomp2_task_frames      = frames;
+            pomp2_task_frames_size = size;
+        }
+    }
+    if ( pomp2_task_frames_used < pomp2_task_frames_size )
+    {
+        pomp2_task_frames[ pomp2_task_frames_used ].task      = task;
+        pomp2_task_frames[ pomp2_task_frames_used ].suspended = pomp2_current_task;
+        pomp2_task_frames_used++;
+    }
+    pomp2_current_task = task;
+}
+
+/** Resumes the task suspended by the current task. An untied task that
+ *  ends on another thread than it began on finds no frame and leaves the
+ *  current task unchanged. */
+static void
+pop_task_frame( void )
+{
+    if ( pomp2_task_frames_used > 0 &&
+         pomp2_task_frames[ pomp2_task_frames_used - 1 ].task == pomp2_current_task )
+    {
+        pomp2_task_frames_used--;
+        pomp2_current_task = pomp2_task_frames[ pomp2_task_frames_used ].suspended;
+    }
+}
+
+/** Called directly by Fortran code instrumented with
+ *  --fortran-bind-c, otherwise through the Fortran wrapper. */
+int
+POMP2_Lib_get_max_threads( void )
+{
+    return omp_get_max_threads();
+}
+
 static void
 free_my_pomp2_region_member( char** member )
 {
@@ -157,6 +236,33 @@ assignString( char**      destination,
     strcpy( *destination, source );
 }
 
+/** Names of all critical sections, "" for unnamed ones */
+static char** pomp2_critical_names;
+/** Number of distinct critical section names */
+static int    pomp2_num_critical_names = 0;
+
+/** Returns the index of a critical name. Regions are assigned serially
+ *  by POMP2_Init(), so no synchronization is needed.
+ *  @param name The name of the critical section or NULL if unnamed. */
+static int
+get_critical_id( const char* name )
+{
+    int i;
+
+    if ( !name )
+    {
+        name = "";
+    }
+    for ( i = 0; i < pomp2_num_critical_names; ++i )
+    {
+        if ( strcmp( pomp2_critical_names[ i ], name ) == 0 )
+        {
+            return i;
+        }
+    }
+    assignString( &pomp2_critical_names[ pomp2_num_critical_names ], name );
+    return pomp2_num_critical_names++;
+}
 
 static void
 initDummyRegionFromPOMP2RegionInfo(
@@ -181,6 +287,31 @@ initDummyRegionFromPOMP2RegionInfo(
         assignString( &pomp2_region->name,
                       pomp2RegionInfo->mCriticalName );
     }
+    if ( pomp2RegionInfo->mRegionType == POMP2_Critical )
+    {
+        pomp2_region->critical_id = get_critical_id( pomp2_region->name );
+    }
+    else if ( pomp2RegionInfo->mCancelConstruct )
+    {
+        assignString( &pomp2_region->name,
+                      pomp2RegionInfo->mCancelConstruct );
+    }
+    switch ( pomp2RegionInfo->mRegionType )
+    {
+        case POMP2_Do:
+        case POMP2_For:
+        case POMP2_Parallel_do:
+        case POMP2_Parallel_for:
+        case POMP2_Do_simd:
+        case POMP2_For_simd:
+        case POMP2_Parallel_do_simd:
+        case POMP2_Parallel_for_simd:
+            pomp2_region->is_loop  = 1;
+            pomp2_region->schedule = pomp2RegionInfo->mScheduleType;
+            break;
+        default:
+            break;
+    }
 
     pomp2_region->num_sections = pomp2RegionInfo->mNumSections;
 }
@@ -218,157 +349,2080 @@ initDummyRegionFromPOMP2UserRegionInfo(
 int              pomp2_tracing = 0;
 my_pomp2_region* my_pomp2_regions;
 
+/** Set once POMP2_Init() has assigned all region handles */
+static volatile int pomp2_handles_assigned = 0;
+
+/** Events without CTC string only check this single flag instead of
+ *  their handle, as the handle is assigned by POMP2_Init(). */
+static void
+ensure_handles_assigned( void )
+{
+    if ( !pomp2_handles_assigned )
+    {
+#pragma omp critical
+        POMP2_Init();
+    }
+}
+
 /*
- * C pomp2 function library
+ * Lock contention profiling
  */
 
+/** Set by POMP2_Init() if the environment variable POMP2_LOCK_PROFILING
+ *  is set to a value other than 0. The lock wrappers then first try to
+ *  acquire a lock with omp_test_lock and time the blocking acquisition
+ *  only if this fails. */
+int pomp2_lock_profiling = 0;
+
+/** Number of locks that can be profiled, must be a power of two */
+#define POMP2_LOCK_PROFILE_SIZE 1024
+
+/** @brief Statistics of a single lock. All fields except lock and
+ *  failed_tests are only modified by the thread holding the lock. */
+typedef struct
+{
+    /** address of the omp_lock_t or omp_nest_lock_t, 0 if unused */
+    const void* lock;
+    /** set once the slot has been claimed by a thread */
+    int         claimed;
+    /** number of acquisitions */
+    long        acquisitions;
+    /** number of acquisitions that had to wait */
+    long        contended;
+    /** number of unsuccessful omp_test_lock calls */
+    long        failed_tests;
+    /** total time spent waiting for the lock */
+    double      wait_time;
+    /** maximum time the lock was held */
+    double      max_hold_time;
+    /** time of the current acquisition */
+    double      hold_start;
+    /** nesting depth of the current acquisition */
+    int         depth;
+    /** thread that acquired the lock last */
+    int         owner;
+} pomp2_lock_profile;
+
+static pomp2_lock_profile pomp2_lock_profiles[ POMP2_LOCK_PROFILE_SIZE ];
+
+/** Number of locks not profiled because the table was full */
+static long pomp2_lock_profiles_dropped = 0;
+
+/** Looks up the statistics of a lock and creates them on first use.
+ *  Slots are claimed with an atomic swap and never released, so no
+ *  thread has to wait for another one except for the time until a
+ *  newly claimed slot gets its key.
+ *  @return the statistics or NULL if the table is full. */
+static pomp2_lock_profile*
+get_lock_profile( const void* lock )
+{
+    size_t      start = ( ( ( uintptr_t )lock >> 3 ) * 2654435761u ) & ( POMP2_LOCK_PROFILE_SIZE - 1 );
+    size_t      i     = start;
+    const void* key;
+    int         claimed;
+
+    do
+    {
+        pomp2_lock_profile* profile = &pomp2_lock_profiles[ i ];
+
+#pragma omp atomic read
+        key = profile->lock;
+        if ( key == lock )
+        {
+            return profile;
+        }
+        if ( key == NULL )
+        {
+#pragma omp atomic capture
+            {
+                claimed = profile->claimed;
+                profile->claimed = 1;
+            }
+            if ( !claimed )
+            {
+                profile->owner = -1;
+#pragma omp atomic write
+                profile->lock = lock;
+                return profile;
+            }
+            /* another thread claimed the slot, wait for its key */
+            do
+            {
+#pragma omp atomic read
+                key = profile->lock;
+            }
+            while ( key == NULL );
+            if ( key == lock )
+            {
+                return profile;
+            }
+        }
+        i = ( i + 1 ) & ( POMP2_LOCK_PROFILE_SIZE - 1 );
+    }
+    while ( i != start );
 
+#pragma omp atomic
+    pomp2_lock_profiles_dropped++;
+    return NULL;
+}
 
+/** Records the acquisition of a lock. Must be called by the thread
+ *  holding the lock.
+ *  @param lock       The acquired lock.
+ *  @param contended  Non-zero if the thread had to wait for the lock.
+ *  @param wait_start Time when the thread started to wait. */
 void
-POMP2_Finalize(void)
+pomp2_lock_profile_acquire( const void* lock,
+                            int         contended,
+                            double      wait_start )
 {
-    static int   pomp2_finalize_called = 0;
-    size_t       i;
-    const size_t nRegions = POMP2_Get_num_regions();
+    pomp2_lock_profile* profile = get_lock_profile( lock );
+    double              now     = omp_get_wtime();
 
-    if ( my_pomp2_regions )
+    if ( !profile )
     {
-        for ( i = 0; i < nRegions; ++i )
-        {
-            free_my_pomp2_region_members( &my_pomp2_regions[ i ] );
-        }
-        free( my_pomp2_regions );
-        my_pomp2_regions = 0;
+        return;
+    }
+    profile->acquisitions++;
+    if ( contended )
+    {
+        profile->contended++;
+        profile->wait_time += now - wait_start;
+    }
+    if ( profile->depth++ == 0 )
+    {
+        profile->hold_start = now;
+        profile->owner      = omp_get_thread_num();
     }
+}
 
-    if ( !pomp2_finalize_called )
+/** Records an unsuccessful omp_test_lock call.
+ *  @param lock The tested lock. */
+void
+pomp2_lock_profile_failed_test( const void* lock )
+{
+    pomp2_lock_profile* profile = get_lock_profile( lock );
+
+    if ( profile )
     {
-        pomp2_finalize_called = 1;
-        fprintf( stderr, "  0: finalize\n" );
+#pragma omp atomic
+        profile->failed_tests++;
     }
 }
 
+/** Records the release of a lock. Must be called before the lock is
+ *  released.
+ *  @param lock The lock to release. */
 void
-POMP2_Init(void)
+pomp2_lock_profile_release( const void* lock )
 {
-    static int pomp2_init_called = 0;
+    pomp2_lock_profile* profile = get_lock_profile( lock );
+    double              hold_time;
 
-    if ( !pomp2_init_called )
+    /* the lock may have been acquired before profiling was enabled */
+    if ( !profile || profile->depth == 0 )
     {
-        pomp2_init_called = 1;
+        return;
+    }
+    if ( --profile->depth == 0 )
+    {
+        hold_time = omp_get_wtime() - profile->hold_start;
+        if ( hold_time > profile->max_hold_time )
+        {
+            profile->max_hold_time = hold_time;
+        }
+    }
+}
 
-        atexit( POMP2_Finalize );
-        fprintf( stderr, "  0: init\n" );
+static void
+print_lock_profiles( void )
+{
+    size_t i;
 
-        int n_pomp2_regions = POMP2_Get_num_regions() + POMP2_USER_Get_num_regions();
-        int n_pomp2_user_regions = POMP2_USER_Get_num_regions();
+    fprintf( stderr, "  0: lock profile\n" );
+    for ( i = 0; i < POMP2_LOCK_PROFILE_SIZE; ++i )
+    {
+        const pomp2_lock_profile* profile = &pomp2_lock_profiles[ i ];
 
-        my_pomp2_regions = calloc( n_pomp2_regions + n_pomp2_user_regions,
-                                   sizeof( my_pomp2_region ) );
+        if ( profile->lock == NULL || profile->acquisitions == 0 )
+        {
+            continue;
+        }
+        fprintf( stderr, "  0:   lock %p: %ld acquisitions, %ld contended (%.1f%%), "
+                 "%ld failed tests, wait %g s, max hold %g s, owner %d\n",
+                 profile->lock, profile->acquisitions, profile->contended,
+                 100.0 * profile->contended / profile->acquisitions,
+                 profile->failed_tests, profile->wait_time,
+                 profile->max_hold_time, profile->owner );
+    }
+    if ( pomp2_lock_profiles_dropped )
+    {
+        fprintf( stderr, "  0:   %ld lock lookups dropped, increase POMP2_LOCK_PROFILE_SIZE\n",
+                 pomp2_lock_profiles_dropped );
+    }
+}
 
-        if ( n_pomp2_regions > 0 )
-          {
-            POMP2_Init_regions();
-          }
+/*
+ * Time histograms
+ */
 
-        if ( n_pomp2_regions > 0 )
-          {
-            POMP2_USER_Init_regions();
-          }
+/** Number of bins of a time histogram. Bin 0 counts durations below
+ *  1 us, bin i durations below 2^i us, the last bin all longer ones. */
+#define POMP2_HISTOGRAM_BINS 24
+
+/** @brief Histogram of durations with logarithmic bins */
+typedef struct
+{
+    long bins[ POMP2_HISTOGRAM_BINS ];
+} pomp2_histogram;
 
+static void
+histogram_add( pomp2_histogram* histogram,
+               double           seconds )
+{
+    double limit = 1.0e-6;
+    int    bin   = 0;
 
-        pomp2_tracing = 1;
+    while ( bin < POMP2_HISTOGRAM_BINS - 1 && seconds >= limit )
+    {
+        limit *= 2.0;
+        ++bin;
     }
+    histogram->bins[ bin ]++;
 }
 
-void
-POMP2_Off(void)
+static void
+histogram_merge( pomp2_histogram*       histogram,
+                 const pomp2_histogram* other )
 {
-    pomp2_tracing = 0;
+    int bin;
+
+    for ( bin = 0; bin < POMP2_HISTOGRAM_BINS; ++bin )
+    {
+        histogram->bins[ bin ] += other->bins[ bin ];
+    }
 }
 
-void
-POMP2_On(void)
+/** Prints all non-empty bins of a histogram on a single line */
+static void
+histogram_print( const char*            label,
+                 const pomp2_histogram* histogram )
 {
-    pomp2_tracing = 1;
+    int bin;
+
+    fprintf( stderr, "  0:     %s histogram (us):", label );
+    for ( bin = 0; bin < POMP2_HISTOGRAM_BINS; ++bin )
+    {
+        if ( histogram->bins[ bin ] == 0 )
+        {
+            continue;
+        }
+        if ( bin == POMP2_HISTOGRAM_BINS - 1 )
+        {
+            fprintf( stderr, " >=%ld:%ld", 1L << ( bin - 1 ), histogram->bins[ bin ] );
+        }
+        else
+        {
+            fprintf( stderr, " <%ld:%ld", 1L << bin, histogram->bins[ bin ] );
+        }
+    }
+    fprintf( stderr, "\n" );
 }
 
-void
-POMP2_Begin( POMP2_Region_handle* pomp2_handle,
-             const char           ctc_string[]  )
+/** Returns the number of threads per team for which profiles keep
+ *  separate statistics */
+static int
+get_profile_threads( void )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    int threads = omp_get_max_threads();
+
+    if ( omp_get_num_procs() > threads )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        threads = omp_get_num_procs();
     }
-    my_pomp2_region* region = *pomp2_handle;
-    if ( pomp2_tracing )
+    return threads;
+}
+
+/*
+ * Critical section profiling
+ */
+
+/** Set by POMP2_Init() if the environment variable
+ *  POMP2_CRITICAL_PROFILING is set to a value other than 0. */
+static int pomp2_critical_profiling = 0;
+
+/** Maximum nesting depth of critical sections that is profiled */
+#define POMP2_CRITICAL_NESTING 16
+
+/** @brief Wait and hold times of one thread in one critical section.
+ *  Only modified inside the critical section, so critical sections
+ *  with the same name never update it concurrently. */
+typedef struct
+{
+    /** number of executions */
+    long            count;
+    /** total time between enter and begin */
+    double          wait_time;
+    /** maximum time between enter and begin */
+    double          max_wait_time;
+    /** total time between begin and end */
+    double          hold_time;
+    /** maximum time between begin and end */
+    double          max_hold_time;
+    pomp2_histogram wait_histogram;
+    pomp2_histogram hold_histogram;
+} pomp2_critical_profile;
+
+/** Profiles indexed by critical id and thread. Threads with a number
+ *  of at least pomp2_critical_threads share the last slot. */
+static pomp2_critical_profile* pomp2_critical_profiles;
+static int                     pomp2_critical_threads;
+
+/** Enter and begin times of the critical sections the thread is in */
+static double pomp2_critical_enter_time[ POMP2_CRITICAL_NESTING ];
+static double pomp2_critical_begin_time[ POMP2_CRITICAL_NESTING ];
+static int    pomp2_critical_depth = 0;
+#pragma omp threadprivate(pomp2_critical_enter_time, pomp2_critical_begin_time, pomp2_critical_depth)
+
+static void
+init_critical_profiles( void )
+{
+    pomp2_critical_threads  = get_profile_threads();
+    pomp2_critical_profiles = calloc( ( size_t )pomp2_num_critical_names * ( pomp2_critical_threads + 1 ),
+                                      sizeof( pomp2_critical_profile ) );
+    if ( !pomp2_critical_profiles )
     {
-        fprintf( stderr, "%3d: begin region %s\n",
-                 omp_get_thread_num(), region->name );
+        pomp2_critical_profiling = 0;
     }
 }
 
-void
-POMP2_End( POMP2_Region_handle* pomp2_handle )
+static pomp2_critical_profile*
+get_critical_profile( const my_pomp2_region* region )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    int thread = omp_get_thread_num();
+
+    if ( thread >= pomp2_critical_threads )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        thread = pomp2_critical_threads;
     }
-    my_pomp2_region* region = *pomp2_handle;
-    if ( pomp2_tracing )
+    return &pomp2_critical_profiles[ region->critical_id * ( pomp2_critical_threads + 1 ) + thread ];
+}
+
+static void
+critical_profile_enter( void )
+{
+    if ( pomp2_critical_depth < POMP2_CRITICAL_NESTING )
     {
-        fprintf( stderr, "%3d: end   region %s\n",
-                 omp_get_thread_num(), region->name );
+        pomp2_critical_enter_time[ pomp2_critical_depth ] = omp_get_wtime();
     }
+    pomp2_critical_depth++;
 }
 
-void
-POMP2_Assign_handle( POMP2_Region_handle* pomp2_handle,
-                     const char           ctc_string[] )
+static void
+critical_profile_begin( const my_pomp2_region* region )
 {
-    static size_t count = 0;
-    assert( count < POMP2_Get_num_regions() );
+    int                     depth   = pomp2_critical_depth - 1;
+    pomp2_critical_profile* profile = get_critical_profile( region );
+    double                  now     = omp_get_wtime();
+    double                  wait_time;
 
-    POMP2_Region_info pomp2RegionInfo;
-    ctcString2RegionInfo( ctc_string, &pomp2RegionInfo );
+    if ( depth < 0 || depth >= POMP2_CRITICAL_NESTING )
+    {
+        return;
+    }
+    wait_time                           = now - pomp2_critical_enter_time[ depth ];
+    pomp2_critical_begin_time[ depth ] = now;
+    profile->count++;
+    profile->wait_time += wait_time;
+    if ( wait_time > profile->max_wait_time )
+    {
+        profile->max_wait_time = wait_time;
+    }
+    histogram_add( &profile->wait_histogram, wait_time );
+}
 
-    initDummyRegionFromPOMP2RegionInfo( &my_pomp2_regions[ count ], &pomp2RegionInfo );
-    my_pomp2_regions[ count ].id = count;
+static void
+critical_profile_end( const my_pomp2_region* region )
+{
+    int                     depth   = pomp2_critical_depth - 1;
+    pomp2_critical_profile* profile = get_critical_profile( region );
+    double                  hold_time;
 
-    *pomp2_handle = &my_pomp2_regions[ count ];
+    if ( depth < 0 || depth >= POMP2_CRITICAL_NESTING )
+    {
+        return;
+    }
+    hold_time           = omp_get_wtime() - pomp2_critical_begin_time[ depth ];
+    profile->hold_time += hold_time;
+    if ( hold_time > profile->max_hold_time )
+    {
+        profile->max_hold_time = hold_time;
+    }
+    histogram_add( &profile->hold_histogram, hold_time );
+}
 
-    freePOMP2RegionInfoMembers( &pomp2RegionInfo );
-    ++count;
+static void
+critical_profile_exit( void )
+{
+    if ( pomp2_critical_depth > 0 )
+    {
+        pomp2_critical_depth--;
+    }
 }
 
-void
-POMP2_USER_Assign_handle( POMP2_USER_Region_handle* pomp2_handle,
-                          const char                ctc_string[] )
+static void
+print_critical_profiles( void )
 {
-    static size_t count = 0;
-    assert( count < POMP2_Get_num_regions() );
+    int i, thread;
 
-    POMP2_USER_Region_info pomp2RegionInfo;
-    ctcString2UserRegionInfo( ctc_string, &pomp2RegionInfo );
+    fprintf( stderr, "  0: critical profile\n" );
+    for ( i = 0; i < pomp2_num_critical_names; ++i )
+    {
+        pomp2_histogram wait_histogram = { { 0 } };
+        pomp2_histogram hold_histogram = { { 0 } };
+        long            count          = 0;
 
-    initDummyRegionFromPOMP2UserRegionInfo( &my_pomp2_regions[ count ], &pomp2RegionInfo );
-    my_pomp2_regions[ count ].id = count;
+        for ( thread = 0; thread <= pomp2_critical_threads; ++thread )
+        {
+            const pomp2_critical_profile* profile =
+                &pomp2_critical_profiles[ i * ( pomp2_critical_threads + 1 ) + thread ];
+
+            if ( profile->count == 0 )
+            {
+                continue;
+            }
+            if ( count == 0 )
+            {
+                fprintf( stderr, "  0:   critical %s\n",
+                         *pomp2_critical_names[ i ] ? pomp2_critical_names[ i ] : "(unnamed)" );
+            }
+            fprintf( stderr, "  0:     thread %s%d: %ld executions, wait %g s (max %g s), hold %g s (max %g s)\n",
+                     thread == pomp2_critical_threads ? ">=" : "", thread,
+                     profile->count, profile->wait_time, profile->max_wait_time,
+                     profile->hold_time, profile->max_hold_time );
+            count += profile->count;
+            histogram_merge( &wait_histogram, &profile->wait_histogram );
+            histogram_merge( &hold_histogram, &profile->hold_histogram );
+        }
+        if ( count > 0 )
+        {
+            histogram_print( "wait", &wait_histogram );
+            histogram_print( "hold", &hold_histogram );
+        }
+    }
+}
 
-    *pomp2_handle = &my_pomp2_regions[ count ];
+/*
+ * Task profiling
+ */
 
-    freePOMP2UserRegionInfoMembers( &pomp2RegionInfo );
-    ++count;
+/** Set by POMP2_Init() if the environment variable POMP2_TASK_PROFILING
+ *  is set to a value other than 0. Task handles then identify a task
+ *  record in the pool of the creating thread. */
+static int pomp2_task_profiling = 0;
+
+/** Number of records allocated at once */
+#define POMP2_TASK_CHUNK_SIZE 1024
+/** Maximum number of chunks per thread */
+#define POMP2_TASK_CHUNKS 1024
+/** Maximum number of threads with a task pool */
+#define POMP2_TASK_POOLS 1024
+/** Number of pending records checked for completion before a new
+ *  record is allocated */
+#define POMP2_TASK_SCAN 8
+/** Marks task handles without a record */
+#define POMP2_TASK_UNTRACKED ( ( POMP2_Task_handle )1 << 62 )
+
+/** @brief Life cycle of one explicit task */
+typedef struct pomp2_task_record
+{
+    /** time of POMP2_Task_create_begin */
+    double                    create_time;
+    /** time of POMP2_Task_begin */
+    double                    begin_time;
+    /** time of POMP2_Task_end */
+    double                    end_time;
+    /** thread that executed the task */
+    int                       thread;
+    /** set by the executing thread once end_time is valid */
+    int                       done;
+    /** index of the record in its pool */
+    uint32_t                  index;
+    /** next free or pending record */
+    struct pomp2_task_record* next;
+} pomp2_task_record;
+
+/** @brief Task records of one creating thread. Records are only
+ *  allocated and recycled by the owning thread. Executing threads
+ *  just mark them as done, so no locks are needed. */
+typedef struct
+{
+    /** records, indexed by the lower 32 bits of the task handle */
+    pomp2_task_record* chunks[ POMP2_TASK_CHUNKS ];
+    /** number of records allocated so far */
+    uint32_t           num_records;
+    /** records available for new tasks */
+    pomp2_task_record* free_records;
+    /** records of created tasks in creation order */
+    pomp2_task_record* pending_head;
+    pomp2_task_record* pending_tail;
+    /** index of the pool, upper bits of the task handle */
+    int                id;
+    /** thread number of the owner */
+    int                thread;
+    /** number of completed tasks */
+    long               tasks;
+    /** number of completed tasks executed by another thread */
+    long               migrated;
+    /** number of tasks created without record */
+    long               untracked;
+    /** time from creation to begin */
+    pomp2_histogram    latency_histogram;
+    /** time from begin to end */
+    pomp2_histogram    runtime_histogram;
+} pomp2_task_pool;
+
+static pomp2_task_pool* pomp2_task_pools[ POMP2_TASK_POOLS ];
+static int              pomp2_num_task_pools = 0;
+
+/** Task pool of the current thread */
+static pomp2_task_pool* pomp2_my_task_pool = NULL;
+#pragma omp threadprivate(pomp2_my_task_pool)
+
+static pomp2_task_pool*
+get_task_pool( void )
+{
+    int id;
+
+    if ( pomp2_my_task_pool )
+    {
+        return pomp2_my_task_pool;
+    }
+#pragma omp atomic capture
+    id = pomp2_num_task_pools++;
+    if ( id >= POMP2_TASK_POOLS )
+    {
+        return NULL;
+    }
+    pomp2_my_task_pool = calloc( 1, sizeof( pomp2_task_pool ) );
+    if ( pomp2_my_task_pool )
+    {
+        pomp2_my_task_pool->id     = id;
+        pomp2_my_task_pool->thread = omp_get_thread_num();
+    }
+#pragma omp flush
+#pragma omp atomic write
+    pomp2_task_pools[ id ] = pomp2_my_task_pool;
+    return pomp2_my_task_pool;
 }
 
-void
-POMP2_Atomic_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+static pomp2_task_record*
+get_task_record( POMP2_Task_handle task )
+{
+    pomp2_task_pool* pool;
+    uint32_t         index;
+
+    if ( task & POMP2_TASK_UNTRACKED )
+    {
+        return NULL;
+    }
+    pool  = pomp2_task_pools[ task >> 32 ];
+    index = ( uint32_t )task;
+    return &pool->chunks[ index / POMP2_TASK_CHUNK_SIZE ][ index % POMP2_TASK_CHUNK_SIZE ];
+}
+
+/** Adds a completed task to the statistics of its pool and recycles
+ *  its record. Only called by the owner of the pool. */
+static void
+collect_task_record( pomp2_task_pool*   pool,
+                     pomp2_task_record* record )
+{
+    pool->tasks++;
+    if ( record->thread != pool->thread )
+    {
+        pool->migrated++;
+    }
+    histogram_add( &pool->latency_histogram, record->begin_time - record->create_time );
+    histogram_add( &pool->runtime_histogram, record->end_time - record->begin_time );
+    record->next       = pool->free_records;
+    pool->free_records = record;
+}
+
+/** Recycles the records of completed tasks among the oldest pending ones */
+static void
+collect_task_records( pomp2_task_pool* pool,
+                      int              max_records )
+{
+    pomp2_task_record* prev   = NULL;
+    pomp2_task_record* record = pool->pending_head;
+    int                done;
+
+    while ( record && max_records-- > 0 )
+    {
+        pomp2_task_record* next = record->next;
+
+#pragma omp atomic read
+        done = record->done;
+        if ( done )
+        {
+#pragma omp flush
+            if ( prev )
+            {
+                prev->next = next;
+            }
+            else
+            {
+                pool->pending_head = next;
+            }
+            if ( pool->pending_tail == record )
+            {
+                pool->pending_tail = prev;
+            }
+            collect_task_record( pool, record );
+        }
+        else
+        {
+            prev = record;
+        }
+        record = next;
+    }
+}
+
+/** Creates the handle of a new explicit task together with its record */
+static POMP2_Task_handle
+task_profile_create( void )
+{
+    pomp2_task_pool*   pool = get_task_pool();
+    pomp2_task_record* record;
+
+    if ( !pool )
+    {
+        return POMP2_Get_new_task_handle() | POMP2_TASK_UNTRACKED;
+    }
+    collect_task_records( pool, POMP2_TASK_SCAN );
+    record = pool->free_records;
+    if ( record )
+    {
+        pool->free_records = record->next;
+    }
+    else
+    {
+        uint32_t chunk = pool->num_records / POMP2_TASK_CHUNK_SIZE;
+        uint32_t i;
+
+        if ( pool->num_records % POMP2_TASK_CHUNK_SIZE == 0 )
+        {
+            if ( chunk >= POMP2_TASK_CHUNKS ||
+                 !( pool->chunks[ chunk ] = calloc( POMP2_TASK_CHUNK_SIZE, sizeof( pomp2_task_record ) ) ) )
+            {
+                pool->untracked++;
+                return POMP2_Get_new_task_handle() | POMP2_TASK_UNTRACKED;
+            }
+            for ( i = 0; i < POMP2_TASK_CHUNK_SIZE; ++i )
+            {
+                pool->chunks[ chunk ][ i ].index = pool->num_records + i;
+            }
+        }
+        record = &pool->chunks[ chunk ][ pool->num_records % POMP2_TASK_CHUNK_SIZE ];
+        pool->num_records++;
+    }
+
+    record->create_time = omp_get_wtime();
+    record->done        = 0;
+    record->next        = NULL;
+    if ( pool->pending_tail )
+    {
+        pool->pending_tail->next = record;
+    }
+    else
+    {
+        pool->pending_head = record;
+    }
+    pool->pending_tail = record;
+
+    return ( ( POMP2_Task_handle )pool->id << 32 ) + record->index;
+}
+
+static void
+task_profile_begin( POMP2_Task_handle task )
+{
+    pomp2_task_record* record = get_task_record( task );
+
+    if ( record )
+    {
+        record->begin_time = omp_get_wtime();
+        record->thread     = omp_get_thread_num();
+    }
+}
+
+static void
+task_profile_end( POMP2_Task_handle task )
+{
+    pomp2_task_record* record = get_task_record( task );
+
+    if ( record )
+    {
+        record->end_time = omp_get_wtime();
+#pragma omp flush
+#pragma omp atomic write
+        record->done = 1;
+    }
+}
+
+/** Returns a new handle for an explicit task */
+static POMP2_Task_handle
+get_new_explicit_task_handle( void )
+{
+    if ( pomp2_task_profiling )
+    {
+        return task_profile_create();
+    }
+    return POMP2_Get_new_task_handle();
+}
+
+static void
+print_task_profiles( void )
+{
+    pomp2_histogram latency_histogram = { { 0 } };
+    pomp2_histogram runtime_histogram = { { 0 } };
+    long            tasks             = 0;
+    long            migrated          = 0;
+    long            untracked         = 0;
+    long            unfinished        = 0;
+    uint32_t        records           = 0;
+    int             i;
+
+    for ( i = 0; i < pomp2_num_task_pools && i < POMP2_TASK_POOLS; ++i )
+    {
+        pomp2_task_pool*   pool = pomp2_task_pools[ i ];
+        pomp2_task_record* record;
+
+        if ( !pool )
+        {
+            continue;
+        }
+        collect_task_records( pool, INT_MAX );
+        for ( record = pool->pending_head; record; record = record->next )
+        {
+            unfinished++;
+        }
+        tasks     += pool->tasks;
+        migrated  += pool->migrated;
+        untracked += pool->untracked;
+        records   += pool->num_records;
+        histogram_merge( &latency_histogram, &pool->latency_histogram );
+        histogram_merge( &runtime_histogram, &pool->runtime_histogram );
+    }
+
+    fprintf( stderr, "  0: task profile\n" );
+    fprintf( stderr, "  0:   %ld tasks, %ld executed by another thread, %ld unfinished, %ld untracked, %" PRIu32 " records\n",
+             tasks, migrated, unfinished, untracked, records );
+    if ( tasks > 0 )
+    {
+        histogram_print( "scheduling latency", &latency_histogram );
+        histogram_print( "granularity", &runtime_histogram );
+    }
+}
+
+/*
+ * Fork/join profiling
+ */
+
+/** Set by POMP2_Init() if the environment variable
+ *  POMP2_PARALLEL_PROFILING is set to a value other than 0. Only
+ *  parallel regions forked outside of any other parallel region are
+ *  profiled. */
+static int pomp2_parallel_profiling = 0;
+
+/** @brief Fork/join statistics of one parallel region for one team size */
+typedef struct pomp2_parallel_profile
+{
+    /** number of threads in the team */
+    int                            team_size;
+    /** number of executions */
+    long                           count;
+    /** total and maximum time from fork to the first begin */
+    double                         fork_time;
+    double                         max_fork_time;
+    /** total and maximum time from the last end to join */
+    double                         join_time;
+    double                         max_join_time;
+    /** total and maximum time between the first and the last begin */
+    double                         skew;
+    double                         max_skew;
+    /** total time from fork to join */
+    double                         total_time;
+    struct pomp2_parallel_profile* next;
+} pomp2_parallel_profile;
+
+/** Profiles per region id, only modified by the initial thread */
+static pomp2_parallel_profile** pomp2_parallel_profiles;
+
+/** Number of nested parallel regions that were not profiled */
+static long pomp2_parallel_nested = 0;
+
+/** State of the currently active outermost parallel region. It is
+ *  written by the initial thread before the fork and after the join;
+ *  each team member only writes its own begin and end time. */
+static double  pomp2_parallel_fork_time;
+static double* pomp2_parallel_begin_times;
+static double* pomp2_parallel_end_times;
+static int     pomp2_parallel_capacity = 0;
+static int     pomp2_parallel_team_size;
+
+static void
+parallel_profile_fork( int num_threads )
+{
+    if ( omp_get_level() > 0 )
+    {
+#pragma omp atomic
+        pomp2_parallel_nested++;
+        return;
+    }
+    if ( num_threads < 1 )
+    {
+        num_threads = 1;
+    }
+    if ( num_threads > pomp2_parallel_capacity )
+    {
+        double* begin_times = realloc( pomp2_parallel_begin_times, num_threads * sizeof( double ) );
+        double* end_times   = realloc( pomp2_parallel_end_times, num_threads * sizeof( double ) );
+
+        if ( begin_times )
+        {
+            pomp2_parallel_begin_times = begin_times;
+        }
+        if ( end_times )
+        {
+            pomp2_parallel_end_times = end_times;
+        }
+        if ( !begin_times || !end_times )
+        {
+            return;
+        }
+        pomp2_parallel_capacity = num_threads;
+    }
+    pomp2_parallel_team_size = 0;
+    pomp2_parallel_fork_time = omp_get_wtime();
+}
+
+static void
+parallel_profile_begin( void )
+{
+    int thread = omp_get_thread_num();
+
+    if ( omp_get_level() != 1 || thread >= pomp2_parallel_capacity )
+    {
+        return;
+    }
+    pomp2_parallel_begin_times[ thread ] = omp_get_wtime();
+    if ( thread == 0 )
+    {
+        pomp2_parallel_team_size = omp_get_num_threads();
+    }
+}
+
+static void
+parallel_profile_end( void )
+{
+    int thread = omp_get_thread_num();
+
+    if ( omp_get_level() != 1 || thread >= pomp2_parallel_capacity )
+    {
+        return;
+    }
+    pomp2_parallel_end_times[ thread ] = omp_get_wtime();
+}
+
+static void
+parallel_profile_join( const my_pomp2_region* region )
+{
+    double                  join_time = omp_get_wtime();
+    double                  first_begin, last_begin, last_end;
+    pomp2_parallel_profile* profile;
+    int                     team_size = pomp2_parallel_team_size;
+    int                     i;
+
+    if ( omp_get_level() > 0 || team_size < 1 || team_size > pomp2_parallel_capacity )
+    {
+        return;
+    }
+
+    first_begin = last_begin = pomp2_parallel_begin_times[ 0 ];
+    last_end    = pomp2_parallel_end_times[ 0 ];
+    for ( i = 1; i < team_size; ++i )
+    {
+        if ( pomp2_parallel_begin_times[ i ] < first_begin )
+        {
+            first_begin = pomp2_parallel_begin_times[ i ];
+        }
+        if ( pomp2_parallel_begin_times[ i ] > last_begin )
+        {
+            last_begin = pomp2_parallel_begin_times[ i ];
+        }
+        if ( pomp2_parallel_end_times[ i ] > last_end )
+        {
+            last_end = pomp2_parallel_end_times[ i ];
+        }
+    }
+
+    for ( profile = pomp2_parallel_profiles[ region->id ];
+          profile && profile->team_size != team_size;
+          profile = profile->next )
+    {
+    }
+    if ( !profile )
+    {
+        profile = calloc( 1, sizeof( pomp2_parallel_profile ) );
+        if ( !profile )
+        {
+            return;
+        }
+        profile->team_size                  = team_size;
+        profile->next                       = pomp2_parallel_profiles[ region->id ];
+        pomp2_parallel_profiles[ region->id ] = profile;
+    }
+
+    profile->count++;
+    profile->fork_time += first_begin - pomp2_parallel_fork_time;
+    if ( first_begin - pomp2_parallel_fork_time > profile->max_fork_time )
+    {
+        profile->max_fork_time = first_begin - pomp2_parallel_fork_time;
+    }
+    profile->join_time += join_time - last_end;
+    if ( join_time - last_end > profile->max_join_time )
+    {
+        profile->max_join_time = join_time - last_end;
+    }
+    profile->skew += last_begin - first_begin;
+    if ( last_begin - first_begin > profile->max_skew )
+    {
+        profile->max_skew = last_begin - first_begin;
+    }
+    profile->total_time += join_time - pomp2_parallel_fork_time;
+    pomp2_parallel_team_size = 0;
+}
+
+static void
+print_parallel_profiles( void )
+{
+    const size_t nRegions = POMP2_Get_num_regions();
+    size_t       i;
+
+    fprintf( stderr, "  0: parallel profile\n" );
+    for ( i = 0; i < nRegions; ++i )
+    {
+        pomp2_parallel_profile* profile;
+
+        for ( profile = pomp2_parallel_profiles[ i ]; profile; profile = profile->next )
+        {
+            double overhead = profile->fork_time + profile->join_time;
+
+            fprintf( stderr, "  0:   parallel %s:%d, %d threads: %ld executions, "
+                     "fork %g s (max %g s), join %g s (max %g s), arrival skew %g s (max %g s), "
+                     "fork/join overhead %.1f%%\n",
+                     my_pomp2_regions[ i ].start_file_name, my_pomp2_regions[ i ].start_line_1,
+                     profile->team_size, profile->count,
+                     profile->fork_time / profile->count, profile->max_fork_time,
+                     profile->join_time / profile->count, profile->max_join_time,
+                     profile->skew / profile->count, profile->max_skew,
+                     profile->total_time > 0 ? 100.0 * overhead / profile->total_time : 0.0 );
+        }
+    }
+    if ( pomp2_parallel_nested )
+    {
+        fprintf( stderr, "  0:   %ld nested parallel regions not profiled\n",
+                 pomp2_parallel_nested );
+    }
+}
+
+/*
+ * Loop imbalance profiling
+ */
+
+/** Set by POMP2_Init() if the environment variable POMP2_LOOP_PROFILING
+ *  is set to a value other than 0. Only worksharing loops with an
+ *  implicit barrier in outermost parallel regions are profiled. */
+static int pomp2_loop_profiling = 0;
+
+/** @brief Imbalance statistics of one worksharing loop */
+typedef struct
+{
+    /** number of profiled executions */
+    long    instances;
+    /** sum over all executions of the maximum work time of a thread */
+    double  max_work;
+    /** sum over all executions of the mean work time of the threads */
+    double  mean_work;
+    /** worst ratio of maximum and mean work time of a single execution */
+    double  worst_imbalance;
+    /** work and barrier time per thread, only modified by that thread */
+    double* work_time;
+    double* wait_time;
+} pomp2_loop_profile;
+
+/** Profiles per region id, NULL for regions that are no loops. The
+ *  per-thread arrays hold pomp2_loop_threads entries; they are only
+ *  enlarged by the initial thread before an outermost fork. */
+static pomp2_loop_profile** pomp2_loop_profiles;
+static size_t               pomp2_loop_regions;
+static int                  pomp2_loop_threads;
+
+/** Work times of the last two loop executions, indexed by thread. The
+ *  master evaluates one execution right after its barrier, while the
+ *  other threads can at most reach the barrier of the next one. */
+static double* pomp2_loop_work_times[ 2 ];
+
+/** State of the loop the current thread is in */
+static const my_pomp2_region* pomp2_loop_region = NULL;
+static double                 pomp2_loop_enter_time;
+static double                 pomp2_loop_barrier_time;
+/** Number of loop barriers in the current parallel region. All threads
+ *  of a team encounter worksharing loops in the same order. */
+static long                   pomp2_loop_barriers = 0;
+#pragma omp threadprivate(pomp2_loop_region, pomp2_loop_enter_time, pomp2_loop_barrier_time, pomp2_loop_barriers)
+
+/** Enlarges a per-thread array from pomp2_loop_threads to @a threads
+ *  zero-initialized entries, returns 0 if out of memory */
+static int
+grow_loop_times( double** times,
+                 int      threads )
+{
+    double* new_times = realloc( *times, threads * sizeof( double ) );
+
+    if ( !new_times )
+    {
+        return 0;
+    }
+    memset( new_times + pomp2_loop_threads, 0,
+            ( threads - pomp2_loop_threads ) * sizeof( double ) );
+    *times = new_times;
+    return 1;
+}
+
+/** Makes room for teams of @a threads threads, disables loop profiling
+ *  if out of memory */
+static void
+grow_loop_profiles( int threads )
+{
+    size_t i;
+
+    if ( !grow_loop_times( &pomp2_loop_work_times[ 0 ], threads )
+         || !grow_loop_times( &pomp2_loop_work_times[ 1 ], threads ) )
+    {
+        pomp2_loop_profiling = 0;
+        return;
+    }
+    for ( i = 0; i < pomp2_loop_regions; ++i )
+    {
+        pomp2_loop_profile* profile = pomp2_loop_profiles[ i ];
+
+        if ( profile && ( !grow_loop_times( &profile->work_time, threads )
+                          || !grow_loop_times( &profile->wait_time, threads ) ) )
+        {
+            pomp2_loop_profiling = 0;
+            return;
+        }
+    }
+    pomp2_loop_threads = threads;
+}
+
+static void
+init_loop_profiles( size_t n_regions )
+{
+    size_t i;
+
+    pomp2_loop_profiles = calloc( n_regions + 1, sizeof( pomp2_loop_profile* ) );
+    if ( !pomp2_loop_profiles )
+    {
+        pomp2_loop_profiling = 0;
+        return;
+    }
+    pomp2_loop_regions = n_regions;
+    for ( i = 0; i < n_regions; ++i )
+    {
+        if ( my_pomp2_regions[ i ].is_loop )
+        {
+            pomp2_loop_profiles[ i ] = calloc( 1, sizeof( pomp2_loop_profile ) );
+            if ( !pomp2_loop_profiles[ i ] )
+            {
+                pomp2_loop_profiling = 0;
+                return;
+            }
+        }
+    }
+    grow_loop_profiles( get_profile_threads() );
+}
+
+static void
+loop_profile_fork( int num_threads )
+{
+    if ( omp_get_level() == 0 && num_threads > pomp2_loop_threads )
+    {
+        grow_loop_profiles( num_threads );
+    }
+}
+
+static void
+loop_profile_parallel_begin( void )
+{
+    if ( omp_get_level() == 1 )
+    {
+        pomp2_loop_barriers = 0;
+    }
+}
+
+static void
+loop_profile_enter( const my_pomp2_region* region )
+{
+    if ( region->is_loop && omp_get_level() == 1 )
+    {
+        pomp2_loop_region     = region;
+        pomp2_loop_enter_time = omp_get_wtime();
+    }
+}
+
+static void
+loop_profile_barrier_enter( const my_pomp2_region* region )
+{
+    int    thread = omp_get_thread_num();
+    double work_time;
+
+    if ( region != pomp2_loop_region )
+    {
+        return;
+    }
+    pomp2_loop_barrier_time = omp_get_wtime();
+    work_time               = pomp2_loop_barrier_time - pomp2_loop_enter_time;
+    if ( thread < pomp2_loop_threads )
+    {
+        pomp2_loop_work_times[ pomp2_loop_barriers & 1 ][ thread ] = work_time;
+        pomp2_loop_profiles[ region->id ]->work_time[ thread ]     += work_time;
+    }
+}
+
+static void
+loop_profile_barrier_exit( const my_pomp2_region* region )
+{
+    int                 thread    = omp_get_thread_num();
+    int                 team_size = omp_get_num_threads();
+    pomp2_loop_profile* profile;
+    const double*       work_times;
+    double              max_work  = 0.0;
+    double              sum_work  = 0.0;
+    int                 i;
+
+    if ( region != pomp2_loop_region )
+    {
+        return;
+    }
+    profile    = pomp2_loop_profiles[ region->id ];
+    work_times = pomp2_loop_work_times[ pomp2_loop_barriers++ & 1 ];
+    if ( thread < pomp2_loop_threads )
+    {
+        profile->wait_time[ thread ] += omp_get_wtime() - pomp2_loop_barrier_time;
+    }
+    if ( thread != 0 || team_size > pomp2_loop_threads )
+    {
+        return;
+    }
+
+    for ( i = 0; i < team_size; ++i )
+    {
+        sum_work += work_times[ i ];
+        if ( work_times[ i ] > max_work )
+        {
+            max_work = work_times[ i ];
+        }
+    }
+    profile->instances++;
+    profile->max_work  += max_work;
+    profile->mean_work += sum_work / team_size;
+    if ( sum_work > 0 && max_work * team_size / sum_work > profile->worst_imbalance )
+    {
+        profile->worst_imbalance = max_work * team_size / sum_work;
+    }
+}
+
+static void
+loop_profile_exit( const my_pomp2_region* region )
+{
+    if ( region == pomp2_loop_region )
+    {
+        pomp2_loop_region = NULL;
+    }
+}
+
+static void
+print_loop_profiles( void )
+{
+    const size_t nRegions = POMP2_Get_num_regions();
+    /* totals per schedule type */
+    double       max_work[ POMP2_Auto + 1 ]  = { 0 };
+    double       mean_work[ POMP2_Auto + 1 ] = { 0 };
+    double       work[ POMP2_Auto + 1 ]      = { 0 };
+    double       wait[ POMP2_Auto + 1 ]      = { 0 };
+    size_t       i;
+    int          thread, schedule;
+
+    fprintf( stderr, "  0: loop profile\n" );
+    for ( i = 0; i < nRegions; ++i )
+    {
+        const pomp2_loop_profile* profile   = pomp2_loop_profiles[ i ];
+        double                    work_time = 0.0;
+        double                    wait_time = 0.0;
+
+        if ( !profile || profile->instances == 0 )
+        {
+            continue;
+        }
+        for ( thread = 0; thread < pomp2_loop_threads; ++thread )
+        {
+            work_time += profile->work_time[ thread ];
+            wait_time += profile->wait_time[ thread ];
+        }
+        schedule               = my_pomp2_regions[ i ].schedule;
+        max_work[ schedule ]  += profile->max_work;
+        mean_work[ schedule ] += profile->mean_work;
+        work[ schedule ]      += work_time;
+        wait[ schedule ]      += wait_time;
+        fprintf( stderr, "  0:   %s %s:%d, schedule %s: %ld executions, "
+                 "imbalance %.2f (worst %.2f), idle %.1f%%\n",
+                 my_pomp2_regions[ i ].rtype,
+                 my_pomp2_regions[ i ].start_file_name, my_pomp2_regions[ i ].start_line_1,
+                 pomp2ScheduleType2String( my_pomp2_regions[ i ].schedule ),
+                 profile->instances,
+                 profile->mean_work > 0 ? profile->max_work / profile->mean_work : 1.0,
+                 profile->worst_imbalance,
+                 work_time + wait_time > 0 ? 100.0 * wait_time / ( work_time + wait_time ) : 0.0 );
+    }
+    for ( schedule = POMP2_No_schedule; schedule <= POMP2_Auto; ++schedule )
+    {
+        if ( mean_work[ schedule ] > 0 )
+        {
+            fprintf( stderr, "  0:   schedule %s: imbalance %.2f, idle %.1f%%\n",
+                     pomp2ScheduleType2String( ( POMP2_Schedule_type )schedule ),
+                     max_work[ schedule ] / mean_work[ schedule ],
+                     100.0 * wait[ schedule ] / ( work[ schedule ] + wait[ schedule ] ) );
+        }
+    }
+
+    for ( i = 0; i < pomp2_loop_regions; ++i )
+    {
+        if ( pomp2_loop_profiles[ i ] )
+        {
+            free( pomp2_loop_profiles[ i ]->work_time );
+            free( pomp2_loop_profiles[ i ]->wait_time );
+            free( pomp2_loop_profiles[ i ] );
+        }
+    }
+    free( pomp2_loop_profiles );
+    free( pomp2_loop_work_times[ 0 ] );
+    free( pomp2_loop_work_times[ 1 ] );
+}
+
+/** Checks whether an environment variable is set to a value other than 0 */
+static int
+env_enabled( const char* name )
+{
+    const char* value = getenv( name );
+
+    return value && *value && strcmp( value, "0" ) != 0;
+}
+
+/*
+ * C pomp2 function library
+ */
+
+
+
+void
+POMP2_Finalize(void)
+{
+    static int   pomp2_finalize_called = 0;
+    size_t       i;
+    const size_t nRegions = POMP2_Get_num_regions();
+
+    if ( !pomp2_finalize_called )
+    {
+        pomp2_finalize_called = 1;
+        if ( pomp2_lock_profiling )
+        {
+            print_lock_profiles();
+        }
+        if ( pomp2_critical_profiling )
+        {
+            pomp2_critical_profiling = 0;
+            print_critical_profiles();
+            free( pomp2_critical_profiles );
+        }
+        if ( pomp2_task_profiling )
+        {
+            print_task_profiles();
+        }
+        if ( pomp2_parallel_profiling )
+        {
+            pomp2_parallel_profiling = 0;
+            print_parallel_profiles();
+        }
+        if ( pomp2_loop_profiling )
+        {
+            pomp2_loop_profiling = 0;
+            print_loop_profiles();
+        }
+        fprintf( stderr, "  0: finalize\n" );
+    }
+
+    /* the profiles printed above refer to the regions */
+    if ( my_pomp2_regions )
+    {
+        for ( i = 0; i < nRegions; ++i )
+        {
+            free_my_pomp2_region_members( &my_pomp2_regions[ i ] );
+        }
+        free( my_pomp2_regions );
+        my_pomp2_regions = 0;
+    }
+}
+
+void
+POMP2_Init(void)
+{
+    static int pomp2_init_called = 0;
+
+    if ( !pomp2_init_called )
+    {
+        pomp2_init_called = 1;
+
+        atexit( POMP2_Finalize );
+        fprintf( stderr, "  0: init\n" );
+
+        int n_pomp2_regions = POMP2_Get_num_regions() + POMP2_USER_Get_num_regions();
+        int n_pomp2_user_regions = POMP2_USER_Get_num_regions();
+
+        my_pomp2_regions = calloc( n_pomp2_regions + n_pomp2_user_regions,
+                                   sizeof( my_pomp2_region ) );
+        pomp2_critical_names = calloc( n_pomp2_regions + 1, sizeof( char* ) );
+
+        if ( n_pomp2_regions > 0 )
+          {
+            POMP2_Init_regions();
+          }
+
+        if ( n_pomp2_regions > 0 )
+          {
+            POMP2_USER_Init_regions();
+          }
+
+
+        pomp2_lock_profiling     = env_enabled( "POMP2_LOCK_PROFILING" );
+        pomp2_critical_profiling = env_enabled( "POMP2_CRITICAL_PROFILING" );
+        pomp2_task_profiling     = env_enabled( "POMP2_TASK_PROFILING" );
+        pomp2_parallel_profiling = env_enabled( "POMP2_PARALLEL_PROFILING" );
+        pomp2_loop_profiling     = env_enabled( "POMP2_LOOP_PROFILING" );
+        if ( pomp2_parallel_profiling )
+        {
+            pomp2_parallel_profiles = calloc( n_pomp2_regions + 1, sizeof( pomp2_parallel_profile* ) );
+            if ( !pomp2_parallel_profiles )
+            {
+                pomp2_parallel_profiling = 0;
+            }
+        }
+        if ( pomp2_critical_profiling )
+        {
+            init_critical_profiles();
+        }
+        if ( pomp2_loop_profiling )
+        {
+            init_loop_profiles( POMP2_Get_num_regions() );
+        }
+
+        pomp2_tracing = 1;
+        pomp2_handles_assigned = 1;
+    }
+}
+
+void
+POMP2_Off(void)
+{
+    pomp2_tracing = 0;
+}
+
+void
+POMP2_On(void)
+{
+    pomp2_tracing = 1;
+}
+
+void
+POMP2_Begin( POMP2_Region_handle* pomp2_handle,
+             const char           ctc_string[]  )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: begin region %s\n",
+                 omp_get_thread_num(), region->name );
+    }
+}
+
+void
+POMP2_End( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end   region %s\n",
+                 omp_get_thread_num(), region->name );
+    }
+}
+
+void
+POMP2_Assign_handle( POMP2_Region_handle* pomp2_handle,
+                     const char           ctc_string[] )
+{
+    static size_t count = 0;
+    assert( count < POMP2_Get_num_regions() );
+
+    POMP2_Region_info pomp2RegionInfo;
+    ctcString2RegionInfo( ctc_string, &pomp2RegionInfo );
+
+    initDummyRegionFromPOMP2RegionInfo( &my_pomp2_regions[ count ], &pomp2RegionInfo );
+    my_pomp2_regions[ count ].id = count;
+
+    *pomp2_handle = &my_pomp2_regions[ count ];
+
+    freePOMP2RegionInfoMembers( &pomp2RegionInfo );
+    ++count;
+}
+
+void
+POMP2_USER_Assign_handle( POMP2_USER_Region_handle* pomp2_handle,
+                          const char                ctc_string[] )
+{
+    static size_t count = 0;
+    assert( count < POMP2_Get_num_regions() );
+
+    POMP2_USER_Region_info pomp2RegionInfo;
+    ctcString2UserRegionInfo( ctc_string, &pomp2RegionInfo );
+
+    initDummyRegionFromPOMP2UserRegionInfo( &my_pomp2_regions[ count ], &pomp2RegionInfo );
+    my_pomp2_regions[ count ].id = count;
+
+    *pomp2_handle = &my_pomp2_regions[ count ];
+
+    freePOMP2UserRegionInfoMembers( &pomp2RegionInfo );
+    ++count;
+}
+
+void
+POMP2_Atomic_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: enter atomic\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Atomic_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  atomic\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Implicit_barrier_enter( POMP2_Region_handle* pomp2_handle,
+                              POMP2_Task_handle*   pomp2_old_task )
+{
+  POMP2_Barrier_enter( pomp2_handle, pomp2_old_task, "" );
+  if ( pomp2_loop_profiling )
+  {
+      loop_profile_barrier_enter( *pomp2_handle );
+  }
+}
+
+extern void
+POMP2_Implicit_barrier_exit( POMP2_Region_handle* pomp2_handle,
+                             POMP2_Task_handle    pomp2_old_task )
+{
+  pomp2_current_task = pomp2_old_task;
+  POMP2_Barrier_exit( pomp2_handle, pomp2_old_task );
+  if ( pomp2_loop_profiling )
+  {
+      loop_profile_barrier_exit( *pomp2_handle );
+  }
+}
+
+void
+POMP2_Implicit_barrier_arrive( POMP2_Region_handle* pomp2_handle )
+{
+    ensure_handles_assigned();
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: arrive implicit barrier of %s\n",
+                 omp_get_thread_num(), region->rtype );
+    }
+}
+
+
+void
+POMP2_Barrier_enter( POMP2_Region_handle* pomp2_handle,
+                     POMP2_Task_handle*   pomp2_old_task,
+                     const char           ctc_string[] )
+{
+    ( void )ctc_string;
+    *pomp2_old_task = pomp2_current_task;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle );
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        if ( region->rtype[ 0 ] == 'b' )
+        {
+            fprintf( stderr, "%3d: enter barrier\n", omp_get_thread_num() );
+        }
+        else
+        {
+            fprintf( stderr, "%3d: enter implicit barrier of %s\n",
+                     omp_get_thread_num(), region->rtype );
+        }
+    }
+}
+
+void
+POMP2_Barrier_exit( POMP2_Region_handle* pomp2_handle,
+                    POMP2_Task_handle    pomp2_old_task )
+{
+    pomp2_current_task = pomp2_old_task;
+
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        if ( region->rtype[ 0 ] == 'b' )
+        {
+            fprintf( stderr, "%3d: exit  barrier\n", omp_get_thread_num() );
+        }
+        else
+        {
+            fprintf( stderr, "%3d: exit  implicit barrier of %s\n",
+                     omp_get_thread_num(), region->rtype );
+        }
+    }
+}
+
+void
+POMP2_Flush_enter( POMP2_Region_handle* pomp2_handle,
+		   const char           ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: enter flush\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Flush_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  flush\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Critical_begin( POMP2_Region_handle* pomp2_handle )
+{
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: begin critical %s\n",
+                 omp_get_thread_num(), region->rtype );
+    }
+    if ( pomp2_critical_profiling )
+    {
+        critical_profile_begin( region );
+    }
+}
+
+void
+POMP2_Critical_end( POMP2_Region_handle* pomp2_handle )
+{
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end   critical %s\n",
+                 omp_get_thread_num(), region->name );
+    }
+    if ( pomp2_critical_profiling )
+    {
+        critical_profile_end( region );
+    }
+}
+
+void
+POMP2_Critical_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: enter critical %s\n",
+                 omp_get_thread_num(), region->name );
+    }
+    if ( pomp2_critical_profiling )
+    {
+        critical_profile_enter();
+    }
+}
+
+void
+POMP2_Critical_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  critical %s\n",
+                 omp_get_thread_num(), region->name );
+    }
+    if ( pomp2_critical_profiling )
+    {
+        critical_profile_exit();
+    }
+}
+
+void
+POMP2_For_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: enter for\n", omp_get_thread_num() );
+    }
+    if ( pomp2_loop_profiling )
+    {
+        loop_profile_enter( *pomp2_handle );
+    }
+}
+
+void
+POMP2_For_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  for\n", omp_get_thread_num() );
+    }
+    if ( pomp2_loop_profiling )
+    {
+        loop_profile_exit( *pomp2_handle );
+    }
+}
+
+void
+POMP2_Master_begin( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: begin master\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Master_end( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end   master\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Parallel_begin( POMP2_Region_handle* pomp2_handle)
+{
+    pomp2_current_task = POMP2_Get_new_task_handle();
+
+
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+      fprintf( stderr, "%3d: begin parallel\n", omp_get_thread_num() );
+    }
+    if ( pomp2_parallel_profiling )
+    {
+        parallel_profile_begin();
+    }
+    if ( pomp2_loop_profiling )
+    {
+        loop_profile_parallel_begin();
+    }
+}
+
+void
+POMP2_Parallel_end( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end   parallel\n", omp_get_thread_num() );
+    }
+    if ( pomp2_parallel_profiling )
+    {
+        parallel_profile_end();
+    }
+}
+
+void
+POMP2_Parallel_fork( POMP2_Region_handle* pomp2_handle,
+                     int                  if_clause,
+                     int                  num_threads,
+                     POMP2_Task_handle*   pomp2_old_task,
+                     const char           ctc_string[] )
+{
+    ( void )if_clause;
+    ( void )ctc_string;
+    *pomp2_old_task = pomp2_current_task;
+
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: fork  parallel\n", omp_get_thread_num() );
+    }
+    if ( pomp2_parallel_profiling )
+    {
+        parallel_profile_fork( num_threads );
+    }
+    if ( pomp2_loop_profiling )
+    {
+        loop_profile_fork( num_threads );
+    }
+}
+
+void
+POMP2_Parallel_join( POMP2_Region_handle* pomp2_handle,
+                     POMP2_Task_handle    pomp2_old_task )
+{
+    pomp2_current_task = pomp2_old_task;
+
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: join  parallel\n", omp_get_thread_num() );
+    }
+    if ( pomp2_parallel_profiling )
+    {
+        parallel_profile_join( *pomp2_handle );
+    }
+}
+
+void
+POMP2_Section_begin( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: begin section\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Section_end( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end   section\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Sections_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        my_pomp2_region* region = *pomp2_handle;
+        fprintf( stderr, "%3d: enter sections (%d)\n", omp_get_thread_num(), region->num_sections );
+    }
+}
+
+void
+POMP2_Sections_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  sections\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Single_begin( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: begin single\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Single_end( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end   single\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Single_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: enter single\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Single_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  single\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Workshare_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+{
+    ( void )ctc_string;
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: enter workshare\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Workshare_exit( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  workshare\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Ordered_begin( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: begin ordered\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Ordered_end( POMP2_Region_handle* pomp2_handle )
+{
+#pragma omp critical
+    if ( *pomp2_handle == NULL )
+    {
+        POMP2_Init();
+        assert( *pomp2_handle ); // check awk script output
+    }
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: end ordered\n", omp_get_thread_num() );
+    }
+}
+
+void
+POMP2_Ordered_enter( POMP2_Region_handle* pomp2_handle,
+                    const char           ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
@@ -377,12 +2431,12 @@ POMP2_Atomic_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: enter atomic\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter ordered\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Atomic_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Ordered_exit( POMP2_Region_handle* pomp2_handle )
 {
 #pragma omp critical
     if ( *pomp2_handle == NULL )
@@ -392,99 +2446,170 @@ POMP2_Atomic_exit( POMP2_Region_handle* pomp2_handle )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit  atomic\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: exit ordered\n", omp_get_thread_num() );
     }
 }
 
+
 void
-POMP2_Implicit_barrier_enter( POMP2_Region_handle* pomp2_handle,
-                              POMP2_Task_handle*   pomp2_old_task )
+POMP2_Task_create_begin( POMP2_Region_handle* pomp2_handle,
+                         POMP2_Task_handle*   pomp2_new_task,
+                         POMP2_Task_handle*   pomp2_old_task,
+                         int                  pomp2_if,
+                         const char           ctc_string[])
 {
-  POMP2_Barrier_enter( pomp2_handle, pomp2_old_task, "" );
+    ( void )pomp2_handle;
+    ( void )pomp2_if;
+    ( void )ctc_string;
+    *pomp2_old_task = pomp2_current_task;
+    *pomp2_new_task = get_new_explicit_task_handle();
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: task create begin\n", omp_get_thread_num() );
+    }
 }
 
-extern void
-POMP2_Implicit_barrier_exit( POMP2_Region_handle* pomp2_handle,
-                             POMP2_Task_handle    pomp2_old_task )
+void
+POMP2_Task_create_end( POMP2_Region_handle* pomp2_handle,
+                       POMP2_Task_handle    pomp2_old_task )
 {
-  pomp2_current_task = pomp2_old_task;
-  POMP2_Barrier_exit( pomp2_handle, pomp2_old_task );
+    ( void )pomp2_handle;
+    pomp2_current_task = pomp2_old_task;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: task create end\n", omp_get_thread_num() );
+    }
 }
 
+void
+POMP2_Task_begin( POMP2_Region_handle* pomp2_handle,
+                  POMP2_Task_handle    pomp2_task )
+{
+    ( void )pomp2_handle;
+    push_task_frame( pomp2_task );
+
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: task begin\n", omp_get_thread_num() );
+    }
+    if ( pomp2_task_profiling )
+    {
+        task_profile_begin( pomp2_task );
+    }
+}
 
 void
-POMP2_Barrier_enter( POMP2_Region_handle* pomp2_handle,
-                     POMP2_Task_handle*   pomp2_old_task,
-                     const char           ctc_string[] )
+POMP2_Task_end( POMP2_Region_handle* pomp2_handle )
 {
-    *pomp2_old_task = pomp2_current_task;
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ( void )pomp2_handle;
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle );
+        fprintf( stderr, "%3d: task end\n", omp_get_thread_num());
     }
-    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_task_profiling )
+    {
+        task_profile_end( pomp2_current_task );
+    }
+    pop_task_frame();
+}
+
+void
+POMP2_Untied_task_create_begin( POMP2_Region_handle* pomp2_handle,
+                                POMP2_Task_handle*   pomp2_new_task,
+                                POMP2_Task_handle*   pomp2_old_task,
+                                int                  pomp2_if,
+                                const char           ctc_string[] )
+{
+    ( void )pomp2_handle;
+    ( void )pomp2_if;
+    ( void )ctc_string;
+    *pomp2_new_task = get_new_explicit_task_handle();
+    *pomp2_old_task = pomp2_current_task;
+
     if ( pomp2_tracing )
     {
-        if ( region->rtype[ 0 ] == 'b' )
-        {
-            fprintf( stderr, "%3d: enter barrier\n", omp_get_thread_num() );
-        }
-        else
-        {
-            fprintf( stderr, "%3d: enter implicit barrier of %s\n",
-                     omp_get_thread_num(), region->rtype );
-        }
+        fprintf( stderr, "%3d: create  untied task\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:         suspend task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
 void
-POMP2_Barrier_exit( POMP2_Region_handle* pomp2_handle,
-                    POMP2_Task_handle    pomp2_old_task )
+POMP2_Untied_task_create_end( POMP2_Region_handle* pomp2_handle,
+                              POMP2_Task_handle    pomp2_old_task )
 {
+    ( void )pomp2_handle;
     pomp2_current_task = pomp2_old_task;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: created  untied task\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:          resume task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+    }
+}
 
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+void
+POMP2_Untied_task_begin( POMP2_Region_handle* pomp2_handle,
+                         POMP2_Task_handle    pomp2_task )
+{
+    ( void )pomp2_handle;
+    push_task_frame( pomp2_task );
+
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: start  untied task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
-    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_task_profiling )
+    {
+        task_profile_begin( pomp2_task );
+    }
+}
+
+void
+POMP2_Untied_task_end( POMP2_Region_handle* pomp2_handle )
+{
+    ( void )pomp2_handle;
     if ( pomp2_tracing )
     {
-        if ( region->rtype[ 0 ] == 'b' )
-        {
-            fprintf( stderr, "%3d: exit  barrier\n", omp_get_thread_num() );
-        }
-        else
-        {
-            fprintf( stderr, "%3d: exit  implicit barrier of %s\n",
-                     omp_get_thread_num(), region->rtype );
-        }
+        fprintf( stderr, "%3d: end  untied task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+    }
+    if ( pomp2_task_profiling )
+    {
+        task_profile_end( pomp2_current_task );
     }
+    pop_task_frame();
 }
 
 void
-POMP2_Flush_enter( POMP2_Region_handle* pomp2_handle,
-		   const char           ctc_string[] )
+POMP2_Taskwait_begin( POMP2_Region_handle* pomp2_handle,
+                      POMP2_Task_handle*   pomp2_old_task,
+                      const char           ctc_string[] )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ( void )pomp2_handle;
+    ( void )ctc_string;
+    *pomp2_old_task = pomp2_current_task;
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: begin  taskwait\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:  suspend task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
+}
+
+void
+POMP2_Taskwait_end( POMP2_Region_handle* pomp2_handle,
+                    POMP2_Task_handle    pomp2_old_task )
+{
+    ( void )pomp2_handle;
+    pomp2_current_task = pomp2_old_task;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: enter flush\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: end  taskwait\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: resume task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
 void
-POMP2_Flush_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Taskloop_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
@@ -493,44 +2618,43 @@ POMP2_Flush_exit( POMP2_Region_handle* pomp2_handle )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit  flush\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter taskloop\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Critical_begin( POMP2_Region_handle* pomp2_handle )
+POMP2_Taskloop_exit( POMP2_Region_handle* pomp2_handle )
 {
+#pragma omp critical
     if ( *pomp2_handle == NULL )
     {
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
-    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: begin critical %s\n",
-                 omp_get_thread_num(), region->rtype );
+        fprintf( stderr, "%3d: exit  taskloop\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Critical_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Simd_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
 {
+    ( void )ctc_string;
+#pragma omp critical
     if ( *pomp2_handle == NULL )
     {
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
-    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end   critical %s\n",
-                 omp_get_thread_num(), region->name );
+        fprintf( stderr, "%3d: enter simd\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Critical_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Simd_exit( POMP2_Region_handle* pomp2_handle )
 {
 #pragma omp critical
     if ( *pomp2_handle == NULL )
@@ -538,33 +2662,30 @@ POMP2_Critical_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[]
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
-    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: enter critical %s\n",
-                 omp_get_thread_num(), region->name );
+        fprintf( stderr, "%3d: exit  simd\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Critical_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Teams_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
-    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit  critical %s\n",
-                 omp_get_thread_num(), region->name );
+        fprintf( stderr, "%3d: enter teams\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_For_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Teams_exit( POMP2_Region_handle* pomp2_handle )
 {
 #pragma omp critical
     if ( *pomp2_handle == NULL )
@@ -574,13 +2695,14 @@ POMP2_For_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: enter for\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: exit  teams\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_For_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Distribute_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
@@ -589,12 +2711,12 @@ POMP2_For_exit( POMP2_Region_handle* pomp2_handle )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit  for\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter distribute\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Master_begin( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Distribute_exit( POMP2_Region_handle* pomp2_handle )
 {
 #pragma omp critical
     if ( *pomp2_handle == NULL )
@@ -604,13 +2726,14 @@ POMP2_Master_begin( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: begin master\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: exit  distribute\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Master_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Target_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
@@ -619,16 +2742,13 @@ POMP2_Master_end( POMP2_Region_handle* pomp2_handle )
     }
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end   master\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter target\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Parallel_begin( POMP2_Region_handle* pomp2_handle)
+POMP2_Target_exit( POMP2_Region_handle* pomp2_handle )
 {
-    pomp2_current_task = POMP2_Get_new_task_handle();
-
-
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
@@ -637,255 +2757,290 @@ POMP2_Parallel_begin( POMP2_Region_handle* pomp2_handle)
     }
     if ( pomp2_tracing )
     {
-      fprintf( stderr, "%3d: begin parallel\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: exit  target\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Parallel_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Taskgroup_enter( POMP2_Region_handle* pomp2_handle,
+                       POMP2_Task_handle*   pomp2_old_task,
+                       const char           ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
+    *pomp2_old_task = pomp2_current_task;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end   parallel\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter taskgroup\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Parallel_fork( POMP2_Region_handle* pomp2_handle,
-                     int                  if_clause,
-                     int                  num_threads,
-                     POMP2_Task_handle*   pomp2_old_task,
-                     const char           ctc_string[] )
+POMP2_Taskgroup_begin( POMP2_Region_handle* pomp2_handle )
 {
-    *pomp2_old_task = pomp2_current_task;
-
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ( void )pomp2_handle;
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: begin taskgroup\n", omp_get_thread_num() );
     }
+}
+
+void
+POMP2_Taskgroup_end( POMP2_Region_handle* pomp2_handle )
+{
+    ( void )pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: fork  parallel\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: end   taskgroup\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:  suspend task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
 void
-POMP2_Parallel_join( POMP2_Region_handle* pomp2_handle,
-                     POMP2_Task_handle    pomp2_old_task )
+POMP2_Taskgroup_exit( POMP2_Region_handle* pomp2_handle,
+                      POMP2_Task_handle    pomp2_old_task )
 {
+    ( void )pomp2_handle;
     pomp2_current_task = pomp2_old_task;
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: exit  taskgroup\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: resume task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+    }
+}
 
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+void
+POMP2_Taskyield_begin( POMP2_Region_handle* pomp2_handle,
+                       POMP2_Task_handle*   pomp2_old_task,
+                       const char           ctc_string[] )
+{
+    ( void )pomp2_handle;
+    ( void )ctc_string;
+    *pomp2_old_task = pomp2_current_task;
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: begin  taskyield\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:  suspend task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
+}
+
+void
+POMP2_Taskyield_end( POMP2_Region_handle* pomp2_handle,
+                     POMP2_Task_handle    pomp2_old_task )
+{
+    ( void )pomp2_handle;
+    pomp2_current_task = pomp2_old_task;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: join  parallel\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: end  taskyield\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: resume task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
 void
-POMP2_Section_begin( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Cancel_request( POMP2_Region_handle* pomp2_handle,
+                      const char           ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
+    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: begin section\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: cancel %s\n",
+                 omp_get_thread_num(), region->name );
     }
 }
 
 void
-POMP2_Section_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Cancellation_point_check( POMP2_Region_handle* pomp2_handle,
+                                const char           ctc_string[] )
 {
+    ( void )ctc_string;
 #pragma omp critical
     if ( *pomp2_handle == NULL )
     {
         POMP2_Init();
         assert( *pomp2_handle ); // check awk script output
     }
+    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end   section\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: cancellation point %s\n",
+                 omp_get_thread_num(), region->name );
     }
 }
 
+/*
+ * Events without compile time context, see --omp-ctc-at-init
+ */
+
 void
-POMP2_Sections_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Atomic_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: enter atomic\n", omp_get_thread_num() );
     }
+}
+
+void
+POMP2_Barrier_enter_no_ctc( POMP2_Region_handle* pomp2_handle,
+                            POMP2_Task_handle*   pomp2_old_task )
+{
+    *pomp2_old_task = pomp2_current_task;
+    ensure_handles_assigned();
+    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        my_pomp2_region* region = *pomp2_handle;
-        fprintf( stderr, "%3d: enter sections (%d)\n", omp_get_thread_num(), region->num_sections );
+        if ( region->rtype[ 0 ] == 'b' )
+        {
+            fprintf( stderr, "%3d: enter barrier\n", omp_get_thread_num() );
+        }
+        else
+        {
+            fprintf( stderr, "%3d: enter implicit barrier of %s\n",
+                     omp_get_thread_num(), region->rtype );
+        }
     }
 }
 
 void
-POMP2_Sections_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Flush_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit  sections\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter flush\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Single_begin( POMP2_Region_handle* pomp2_handle )
+POMP2_Critical_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ensure_handles_assigned();
+    my_pomp2_region* region = *pomp2_handle;
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: enter critical %s\n",
+                 omp_get_thread_num(), region->name );
     }
-    if ( pomp2_tracing )
+    if ( pomp2_critical_profiling )
     {
-        fprintf( stderr, "%3d: begin single\n", omp_get_thread_num() );
+        critical_profile_enter();
     }
 }
 
 void
-POMP2_Single_end( POMP2_Region_handle* pomp2_handle )
+POMP2_For_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ensure_handles_assigned();
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: enter for\n", omp_get_thread_num() );
     }
-    if ( pomp2_tracing )
+    if ( pomp2_loop_profiling )
     {
-        fprintf( stderr, "%3d: end   single\n", omp_get_thread_num() );
+        loop_profile_enter( *pomp2_handle );
     }
 }
 
 void
-POMP2_Single_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Master_begin_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: enter single\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: begin master\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Single_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Parallel_fork_no_ctc( POMP2_Region_handle* pomp2_handle,
+                            int                  if_clause,
+                            int                  num_threads,
+                            POMP2_Task_handle*   pomp2_old_task )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ( void )pomp2_handle;
+    ( void )if_clause;
+    *pomp2_old_task = pomp2_current_task;
+    ensure_handles_assigned();
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: fork  parallel\n", omp_get_thread_num() );
     }
-    if ( pomp2_tracing )
+    if ( pomp2_parallel_profiling )
     {
-        fprintf( stderr, "%3d: exit  single\n", omp_get_thread_num() );
+        parallel_profile_fork( num_threads );
+    }
+    if ( pomp2_loop_profiling )
+    {
+        loop_profile_fork( num_threads );
     }
 }
 
 void
-POMP2_Workshare_enter( POMP2_Region_handle* pomp2_handle, const char ctc_string[] )
+POMP2_Section_begin_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: enter workshare\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: begin section\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Workshare_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Sections_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit  workshare\n", omp_get_thread_num() );
+        my_pomp2_region* region = *pomp2_handle;
+        fprintf( stderr, "%3d: enter sections (%d)\n", omp_get_thread_num(), region->num_sections );
     }
 }
 
 void
-POMP2_Ordered_begin( POMP2_Region_handle* pomp2_handle )
+POMP2_Single_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: begin ordered\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter single\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Ordered_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Workshare_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end ordered\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter workshare\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Ordered_enter( POMP2_Region_handle* pomp2_handle,
-                    const char           ctc_string[] )
+POMP2_Ordered_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
-    {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
-    }
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
         fprintf( stderr, "%3d: enter ordered\n", omp_get_thread_num() );
@@ -893,140 +3048,154 @@ POMP2_Ordered_enter( POMP2_Region_handle* pomp2_handle,
 }
 
 void
-POMP2_Ordered_exit( POMP2_Region_handle* pomp2_handle )
+POMP2_Task_create_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                                POMP2_Task_handle*   pomp2_new_task,
+                                POMP2_Task_handle*   pomp2_old_task,
+                                int                  pomp2_if )
 {
-#pragma omp critical
-    if ( *pomp2_handle == NULL )
+    ( void )pomp2_handle;
+    ( void )pomp2_if;
+    *pomp2_old_task = pomp2_current_task;
+    *pomp2_new_task = get_new_explicit_task_handle();
+    if ( pomp2_tracing )
     {
-        POMP2_Init();
-        assert( *pomp2_handle ); // check awk script output
+        fprintf( stderr, "%3d: task create begin\n", omp_get_thread_num() );
     }
+}
+
+void
+POMP2_Untied_task_create_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                                       POMP2_Task_handle*   pomp2_new_task,
+                                       POMP2_Task_handle*   pomp2_old_task,
+                                       int                  pomp2_if )
+{
+    ( void )pomp2_handle;
+    ( void )pomp2_if;
+    *pomp2_new_task = get_new_explicit_task_handle();
+    *pomp2_old_task = pomp2_current_task;
+
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: exit ordered\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: create  untied task\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:         suspend task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
-
 void
-POMP2_Task_create_begin( POMP2_Region_handle* pomp2_handle,
-                         POMP2_Task_handle*   pomp2_new_task,
-                         POMP2_Task_handle*   pomp2_old_task,
-                         int                  pomp2_if,
-                         const char           ctc_string[])
+POMP2_Taskwait_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                             POMP2_Task_handle*   pomp2_old_task )
 {
+    ( void )pomp2_handle;
     *pomp2_old_task = pomp2_current_task;
-    *pomp2_new_task = POMP2_Get_new_task_handle();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: task create begin\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: begin  taskwait\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:  suspend task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
 void
-POMP2_Task_create_end( POMP2_Region_handle* pomp2_handle,
-                       POMP2_Task_handle    pomp2_old_task )
+POMP2_Taskloop_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-    pomp2_current_task = pomp2_old_task;
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: task create end\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter taskloop\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Task_begin( POMP2_Region_handle* pomp2_handle,
-                  POMP2_Task_handle    pomp2_task )
+POMP2_Simd_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-    pomp2_current_task = pomp2_task;
-
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: task begin\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d: enter simd\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Task_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Teams_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: task end\n", omp_get_thread_num());
+        fprintf( stderr, "%3d: enter teams\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Untied_task_create_begin( POMP2_Region_handle* pomp2_handle,
-                                POMP2_Task_handle*   pomp2_new_task,
-                                POMP2_Task_handle*   pomp2_old_task,
-                                int                  pomp2_if,
-                                const char           ctc_string[] )
+POMP2_Distribute_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-    *pomp2_new_task = POMP2_Get_new_task_handle();
-    *pomp2_old_task = pomp2_current_task;
-
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: create  untied task\n", omp_get_thread_num() );
-        fprintf( stderr, "%3d:         suspend task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+        fprintf( stderr, "%3d: enter distribute\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Untied_task_create_end( POMP2_Region_handle* pomp2_handle,
-                              POMP2_Task_handle    pomp2_old_task )
+POMP2_Target_enter_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-    pomp2_current_task = pomp2_old_task;
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: created  untied task\n", omp_get_thread_num() );
-        fprintf( stderr, "%3d:          resume task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+        fprintf( stderr, "%3d: enter target\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Untied_task_begin( POMP2_Region_handle* pomp2_handle,
-                         POMP2_Task_handle    pomp2_parent_task )
+POMP2_Taskgroup_enter_no_ctc( POMP2_Region_handle* pomp2_handle,
+                              POMP2_Task_handle*   pomp2_old_task )
 {
-    pomp2_current_task = POMP2_Get_new_task_handle();
-
+    ( void )pomp2_handle;
+    ensure_handles_assigned();
+    *pomp2_old_task = pomp2_current_task;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: start  untied task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+        fprintf( stderr, "%3d: enter taskgroup\n", omp_get_thread_num() );
     }
 }
 
 void
-POMP2_Untied_task_end( POMP2_Region_handle* pomp2_handle )
+POMP2_Taskyield_begin_no_ctc( POMP2_Region_handle* pomp2_handle,
+                              POMP2_Task_handle*   pomp2_old_task )
 {
+    ( void )pomp2_handle;
+    *pomp2_old_task = pomp2_current_task;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end  untied task %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+        fprintf( stderr, "%3d: begin  taskyield\n", omp_get_thread_num() );
+        fprintf( stderr, "%3d:  suspend task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
     }
 }
 
 void
-POMP2_Taskwait_begin( POMP2_Region_handle* pomp2_handle,
-                      POMP2_Task_handle*   pomp2_old_task,
-                      const char           ctc_string[] )
+POMP2_Cancel_request_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-    *pomp2_old_task = pomp2_current_task;
+    ensure_handles_assigned();
+    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: begin  taskwait\n", omp_get_thread_num() );
-        fprintf( stderr, "%3d:  suspend task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+        fprintf( stderr, "%3d: cancel %s\n",
+                 omp_get_thread_num(), region->name );
     }
 }
 
 void
-POMP2_Taskwait_end( POMP2_Region_handle* pomp2_handle,
-                    POMP2_Task_handle    pomp2_old_task )
+POMP2_Cancellation_point_check_no_ctc( POMP2_Region_handle* pomp2_handle )
 {
-    pomp2_current_task = pomp2_old_task;
+    ensure_handles_assigned();
+    my_pomp2_region* region = *pomp2_handle;
     if ( pomp2_tracing )
     {
-        fprintf( stderr, "%3d: end  taskwait\n", omp_get_thread_num() );
-        fprintf( stderr, "%3d: resume task: %" PRIu64 "\n", omp_get_thread_num(), pomp2_current_task );
+        fprintf( stderr, "%3d: cancellation point %s\n",
+                 omp_get_thread_num(), region->name );
     }
 }
 
@@ -1063,6 +3232,17 @@ POMP2_Set_lock( omp_lock_t* s )
     {
         fprintf( stderr, "%3d: set lock\n", omp_get_thread_num() );
     }
+    if ( pomp2_lock_profiling )
+    {
+        double start     = omp_get_wtime();
+        int    contended = !omp_test_lock( s );
+        if ( contended )
+        {
+            omp_set_lock( s );
+        }
+        pomp2_lock_profile_acquire( s, contended, start );
+        return;
+    }
     omp_set_lock( s );
 }
 
@@ -1073,17 +3253,35 @@ POMP2_Unset_lock( omp_lock_t* s )
     {
         fprintf( stderr, "%3d: unset lock\n", omp_get_thread_num() );
     }
+    if ( pomp2_lock_profiling )
+    {
+        pomp2_lock_profile_release( s );
+    }
     omp_unset_lock( s );
 }
 
 int
 POMP2_Test_lock( omp_lock_t* s )
 {
+    int result;
+
     if ( pomp2_tracing )
     {
         fprintf( stderr, "%3d: test lock\n", omp_get_thread_num() );
     }
-    return omp_test_lock( s );
+    result = omp_test_lock( s );
+    if ( pomp2_lock_profiling )
+    {
+        if ( result )
+        {
+            pomp2_lock_profile_acquire( s, 0, 0.0 );
+        }
+        else
+        {
+            pomp2_lock_profile_failed_test( s );
+        }
+    }
+    return result;
 }
 
 void
@@ -1113,6 +3311,17 @@ POMP2_Set_nest_lock( omp_nest_lock_t* s )
     {
         fprintf( stderr, "%3d: set nestlock\n", omp_get_thread_num() );
     }
+    if ( pomp2_lock_profiling )
+    {
+        double start     = omp_get_wtime();
+        int    contended = !omp_test_nest_lock( s );
+        if ( contended )
+        {
+            omp_set_nest_lock( s );
+        }
+        pomp2_lock_profile_acquire( s, contended, start );
+        return;
+    }
     omp_set_nest_lock( s );
 }
 
@@ -1123,15 +3332,141 @@ POMP2_Unset_nest_lock( omp_nest_lock_t* s )
     {
         fprintf( stderr, "%3d: unset nestlock\n", omp_get_thread_num() );
     }
+    if ( pomp2_lock_profiling )
+    {
+        pomp2_lock_profile_release( s );
+    }
     omp_unset_nest_lock( s );
 }
 
 int
 POMP2_Test_nest_lock( omp_nest_lock_t* s )
 {
+    int result;
+
     if ( pomp2_tracing )
     {
         fprintf( stderr, "%3d: test nestlock\n", omp_get_thread_num() );
     }
-    return omp_test_nest_lock( s );
+    result = omp_test_nest_lock( s );
+    if ( pomp2_lock_profiling )
+    {
+        if ( result )
+        {
+            pomp2_lock_profile_acquire( s, 0, 0.0 );
+        }
+        else
+        {
+            pomp2_lock_profile_failed_test( s );
+        }
+    }
+    return result;
+}
+
+void
+POMP2_Set_num_threads( int num_threads )
+{
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: set num threads (%d)\n", omp_get_thread_num(), num_threads );
+    }
+    omp_set_num_threads( num_threads );
+}
+
+double
+POMP2_Get_wtime( void )
+{
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: get wtime\n", omp_get_thread_num() );
+    }
+    return omp_get_wtime();
+}
+
+#if _OPENMP >= 201511
+/* Lock hints are advisory and not every OpenMP runtime provides the
+   *_with_hint functions (e.g., GNU libgomp), so the dummy library
+   only reports the hint. */
+void
+POMP2_Init_lock_with_hint( omp_lock_t*     s,
+                           omp_lock_hint_t hint )
+{
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: init lock with hint (%d)\n", omp_get_thread_num(), ( int )hint );
+    }
+    omp_init_lock( s );
+}
+
+void
+POMP2_Init_nest_lock_with_hint( omp_nest_lock_t* s,
+                                omp_lock_hint_t  hint )
+{
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: init nestlock with hint (%d)\n", omp_get_thread_num(), ( int )hint );
+    }
+    omp_init_nest_lock( s );
+}
+
+int
+POMP2_Target_memcpy( void*       dst,
+                     const void* src,
+                     size_t      length,
+                     size_t      dst_offset,
+                     size_t      src_offset,
+                     int         dst_device_num,
+                     int         src_device_num )
+{
+    double start;
+    int    result;
+
+    if ( !pomp2_tracing )
+    {
+        return omp_target_memcpy( dst, src, length, dst_offset, src_offset,
+                                  dst_device_num, src_device_num );
+    }
+
+    start  = omp_get_wtime();
+    result = omp_target_memcpy( dst, src, length, dst_offset, src_offset,
+                                dst_device_num, src_device_num );
+    fprintf( stderr, "%3d: target memcpy (%zu bytes, device %d -> %d) took %g s\n",
+             omp_get_thread_num(), length, src_device_num, dst_device_num,
+             omp_get_wtime() - start );
+    return result;
+}
+#endif /* _OPENMP >= 201511 */
+
+#if _OPENMP >= 201811 || defined( __GOMP_DEFAULT_NULL_ALLOCATOR )
+void*
+POMP2_Alloc( size_t                 size,
+             omp_allocator_handle_t allocator )
+{
+    double start;
+    void*  result;
+
+    if ( !pomp2_tracing )
+    {
+        return omp_alloc( size, allocator );
+    }
+
+    start  = omp_get_wtime();
+    result = omp_alloc( size, allocator );
+    fprintf( stderr, "%3d: alloc (%zu bytes, allocator %" PRIuPTR ") took %g s\n",
+             omp_get_thread_num(), size, ( uintptr_t )allocator,
+             omp_get_wtime() - start );
+    return result;
+}
+
+void
+POMP2_Free( void*                  ptr,
+            omp_allocator_handle_t allocator )
+{
+    if ( pomp2_tracing )
+    {
+        fprintf( stderr, "%3d: free (allocator %" PRIuPTR ")\n",
+                 omp_get_thread_num(), ( uintptr_t )allocator );
+    }
+    omp_free( ptr, allocator );
 }
+#endif /* _OPENMP >= 201811 */
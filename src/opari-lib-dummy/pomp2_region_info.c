@@ -109,6 +109,9 @@ initOpenmpRegionInfo( POMP2_Region_info* obj )
     obj->mNumSections     = 0;
     obj->mCriticalName    = 0;
     obj->mUserGroupName   = 0;
+    obj->mHasDepend       = false;
+    obj->mNumDepend       = 0;
+    obj->mCancelConstruct = 0;
 }
 
 static void
@@ -186,6 +189,15 @@ checkCTCTokenAndAssignRegionInfoValues( int      ctctoken,
         case CTC_OMP_User_group_name:
             OPARI2_CTC_assignString( &regionInfo->mUserGroupName, value );
             return true;
+        case CTC_OMP_Has_depend:
+            OPARI2_CTC_assignHasClause( obj, &regionInfo->mHasDepend, value );
+            return true;
+        case CTC_OMP_Num_depend:
+            OPARI2_CTC_assignUnsigned( obj, &regionInfo->mNumDepend, value );
+            return true;
+        case CTC_OMP_Cancel_construct:
+            OPARI2_CTC_assignString( &regionInfo->mCancelConstruct, value );
+            return true;
     }
 
     return false;
@@ -198,22 +210,35 @@ static const OPARI2_CTCMapType regionTypesMap[] =
 {
     { "atomic",            POMP2_Atomic             },
     { "barrier",           POMP2_Barrier            },
+    { "cancel",            POMP2_Cancel             },
+    { "cancellationpoint", POMP2_Cancellation_point },
     { "critical",          POMP2_Critical           },
+    { "distribute",        POMP2_Distribute         },
     { "do",                POMP2_Do                 },
+    { "dosimd",            POMP2_Do_simd            },
     { "flush",             POMP2_Flush              },
     { "for",               POMP2_For                },
+    { "forsimd",           POMP2_For_simd           },
     { "master",            POMP2_Master             },
     { "ordered",           POMP2_Ordered            },
     { "parallel",          POMP2_Parallel           },
     { "paralleldo",        POMP2_Parallel_do        },
+    { "paralleldosimd",    POMP2_Parallel_do_simd   },
     { "parallelfor",       POMP2_Parallel_for       },
+    { "parallelforsimd",   POMP2_Parallel_for_simd  },
     { "parallelsections",  POMP2_Parallel_sections  },
     { "parallelworkshare", POMP2_Parallel_workshare },
     { "sections",          POMP2_Sections           },
+    { "simd",              POMP2_Simd               },
     { "single",            POMP2_Single             },
+    { "target",            POMP2_Target             },
     { "task",              POMP2_Task               },
+    { "taskgroup",         POMP2_Taskgroup          },
+    { "taskloop",          POMP2_Taskloop           },
     { "taskuntied",        POMP2_Taskuntied         },
     { "taskwait",          POMP2_Taskwait           },
+    { "taskyield",         POMP2_Taskyield          },
+    { "teams",             POMP2_Teams              },
     { "workshare",         POMP2_Workshare          }
 };
 
@@ -252,11 +277,11 @@ pomp2RegionType2String( POMP2_Region_type regionType )
 /** @brief map with schedule types*/
 static const OPARI2_CTCMapType scheduleTypesMap[] =
 {
-    { "auto",    POMP2_Auto    },
-    { "dynamic", POMP2_Dynamic },
-    { "guided",  POMP2_Guided  },
-    { "runtime", POMP2_Runtime },
-    { "static",  POMP2_Static  }
+    { "auto",              POMP2_Auto               },
+    { "dynamic",           POMP2_Dynamic            },
+    { "guided",            POMP2_Guided             },
+    { "runtime",           POMP2_Runtime            },
+    { "static",            POMP2_Static             }
 };
 
 /** @brief returns a string of the schedule type*/
@@ -307,10 +332,10 @@ assignScheduleType( CTCData*       obj,
 /** @brief map with defaultSharing types*/
 static const OPARI2_CTCMapType defaultSharingTypesMap[] =
 {
-    { "none",         POMP2_None         },
-    { "shared",       POMP2_Shared       },
-    { "private",      POMP2_Private      },
-    { "firstprivate", POMP2_Firstprivate }
+    { "none",              POMP2_None               },
+    { "shared",            POMP2_Shared             },
+    { "private",           POMP2_Private            },
+    { "firstprivate",      POMP2_Firstprivate       }
 };
 
 /** @brief returns a string of the defaultSharing type*/
@@ -361,7 +386,6 @@ assignDefaultSharingType( CTCData*       obj,
 static void
 checkOMPConsistency( CTCData* obj )
 {
-    bool               requiredAttributesFound;
     POMP2_Region_info* regionInfo = ( POMP2_Region_info* )obj->mRegionInfo;
 
     OPARI2_CTC_checkConsistency( obj );
@@ -379,11 +403,15 @@ checkOMPConsistency( CTCData* obj )
         return;
     }
 
-/* A barrier, taskwait and flush does not have an end line number, since it
- * is not associated to a region.*/
+/* A barrier, taskwait, taskyield, cancel, cancellation point and flush
+ * does not have an end line number, since it is not associated to a
+ * region.*/
     if ( obj->mRegionInfo->mStartLine2 > obj->mRegionInfo->mEndLine1 &&
          regionInfo->mRegionType != POMP2_Barrier &&
          regionInfo->mRegionType != POMP2_Taskwait &&
+         regionInfo->mRegionType != POMP2_Taskyield &&
+         regionInfo->mRegionType != POMP2_Cancel &&
+         regionInfo->mRegionType != POMP2_Cancellation_point &&
          regionInfo->mRegionType != POMP2_Flush )
     {
         OPARI2_CTC_error( obj, CTC_ERROR_Inconsistent_line_numbers, 0 );
@@ -398,4 +426,5 @@ freePOMP2RegionInfoMembers( POMP2_Region_info* regionInfo )
 {
     OPARI2_CTC_freeAndReset( &regionInfo->mCriticalName );
     OPARI2_CTC_freeAndReset( &regionInfo->mUserGroupName );
+    OPARI2_CTC_freeAndReset( &regionInfo->mCancelConstruct );
 }
@@ -79,7 +79,21 @@ typedef enum /* POMP2_Region_type */
     POMP2_Task,
     POMP2_Taskuntied,
     POMP2_Taskwait,
-    POMP2_Workshare
+    POMP2_Workshare,
+    /* OpenMP 4.x constructs, appended to keep the values above stable */
+    POMP2_Distribute,
+    POMP2_Do_simd,
+    POMP2_For_simd,
+    POMP2_Parallel_do_simd,
+    POMP2_Parallel_for_simd,
+    POMP2_Simd,
+    POMP2_Target,
+    POMP2_Taskloop,
+    POMP2_Teams,
+    POMP2_Cancel,
+    POMP2_Cancellation_point,
+    POMP2_Taskgroup,
+    POMP2_Taskyield
 } POMP2_Region_type;
 
 /** converts regionType into a string
@@ -183,6 +197,12 @@ typedef struct
     unsigned                  mNumSections;
     /** name of a named critical region*/
     char*                     mCriticalName;
+    /**true if a depend clause is present*/
+    bool                      mHasDepend;
+    /** number of list items in all depend clauses of a task*/
+    unsigned                  mNumDepend;
+    /** construct type of a cancel or cancellation point directive*/
+    char*                     mCancelConstruct;
     //@}
 } POMP2_Region_info;
 
@@ -205,14 +225,19 @@ typedef struct
     CTC_OMP_Has_if,             \
     CTC_OMP_Has_collapse,       \
     CTC_OMP_Has_num_threads,    \
-    CTC_OMP_Has_untied
+    CTC_OMP_Has_untied,         \
+    CTC_OMP_Has_depend,         \
+    CTC_OMP_Num_depend,         \
+    CTC_OMP_Cancel_construct
 
 #define CTC_OPENMP_TOKEN_MAP_ENTRIES                  \
+    { "cancelConstruct", CTC_OMP_Cancel_construct }, \
     { "criticalName",    CTC_OMP_Critical_name }, \
     { "hasCollapse",     CTC_OMP_Has_collapse }, \
     { "hasCopyIn",       CTC_OMP_Has_copy_in }, \
     { "hasCopyPrivate",  CTC_OMP_Has_copy_private }, \
     { "hasDefault",      CTC_OMP_Has_defaultSharing }, \
+    { "hasDepend",       CTC_OMP_Has_depend }, \
     { "hasFirstPrivate", CTC_OMP_Has_first_private }, \
     { "hasIf",           CTC_OMP_Has_if }, \
     { "hasLastPrivate",  CTC_OMP_Has_last_private }, \
@@ -223,6 +248,7 @@ typedef struct
     { "hasSchedule",     CTC_OMP_Has_schedule }, \
     { "hasShared",       CTC_OMP_Has_shared }, \
     { "hasUntied",       CTC_OMP_Has_untied }, \
+    { "numDepend",       CTC_OMP_Num_depend }, \
     { "numSections",     CTC_OMP_Num_sections }, \
     { "userGroupName",   CTC_OMP_User_group_name }
 
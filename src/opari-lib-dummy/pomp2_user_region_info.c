@@ -122,7 +122,7 @@ assignUserRegionType( CTCData*    obj,
                                                           OPARI2_CTC_MAP_SIZE( userRegionTypesMap ),
                                                           value );
 
-    if ( regionInfo->mRegionType == POMP2_No_type )
+    if ( regionInfo->mRegionType == POMP2_USER_no_type )
     {
         OPARI2_CTC_error( obj, CTC_ERROR_Unknown_region_type, value );
     }
@@ -146,7 +146,6 @@ pomp2UserRegionType2String( POMP2_USER_Region_type regionType )
 static void
 checkUSERConsistency( CTCData* obj )
 {
-    bool                    requiredAttributesFound;
     POMP2_USER_Region_info* regionInfo = ( POMP2_USER_Region_info* )obj->mRegionInfo;
 
     OPARI2_CTC_checkConsistency( obj );
@@ -62,6 +62,14 @@ OPARI2_DirectiveOffload::SetName( string name_str )
     m_name = name_str;
 }
 
+void
+OPARI2_DirectiveOffload::ResetRegions( void )
+{
+    s_init_handle_calls.str( "" );
+    s_init_handle_calls.clear();
+    s_num_regions = 0;
+}
+
 int OPARI2_DirectiveOffload::         s_num_regions = 0;
 stringstream OPARI2_DirectiveOffload::s_init_handle_calls;
 string OPARI2_DirectiveOffload::      s_paradigm_prefix = "POFLD";
@@ -72,6 +72,10 @@ public:
     virtual void
     GenerateDescr( ostream& os );
 
+    /** @brief Forget the regions of the previous file */
+    static void
+    ResetRegions( void );
+
 private:
     static string       s_paradigm_prefix;
     static stringstream s_init_handle_calls;
@@ -23,6 +23,9 @@
 #include "opari2_directive.h"
 #include "opari2_directive_manager.h"
 
+namespace opari2
+{
+
 void
 h_offload_target( OPARI2_Directive* d,
                   ostream&          os )
@@ -57,3 +60,5 @@ h_end_offload_declspec( OPARI2_Directive* d,
     // maintain stack
     DirectiveStackPop();
 }
+
+} /* namespace opari2 */
@@ -28,6 +28,8 @@ using std::ostream;
 #include "opari2.h"
 #include "opari2_directive.h"
 
+namespace opari2
+{
 
 void
 h_offload_target( OPARI2_Directive* d,
@@ -45,4 +47,6 @@ void
 h_end_offload_declspec( OPARI2_Directive* d,
                         ostream&          os );
 
+} /* namespace opari2 */
+
 #endif
@@ -41,50 +41,53 @@
  *  @file		opari2.cc
  *
  *  @brief This File containes the opari main function. It is used to
- *              handle input arguments and open input and output
- *              files. Afterwards the C or Fortran parsers are used,
- *              depending on the file type or provided arguments. */
+ *              handle input arguments and to read and write files.
+ *              The instrumentation itself is done by libopari2, see
+ *              opari2_lib.cc, the server mode is in opari2_server.cc. */
 
 #include <config.h>
 #include <fstream>
 using std::ifstream;
 using std::ofstream;
-#include <sstream>
-using std::stringstream;
 #include <iostream>
 using std::cout;
 using std::cerr;
 #include <cstdio>
-using std::sprintf;
 using std::remove;
+using std::rename;
 #include <cstring>
 using std::string;
 using std::strcmp;
-using std::strrchr;
-using std::strncpy;
+using std::strncmp;
 using std::strcat;
 using std::strlen;
-#include <cstdlib>
-using std::exit;
+using std::strchr;
 #include <string>
-#include <assert.h>
+#include <vector>
+using std::vector;
 #include <unistd.h>
-#include <sys/time.h>
-#include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+
+#include <opari2/opari2_lib.h>
 
 #include "opari2.h"
 #include "opari2_directive_manager.h"
-#include "openmp/opari2_directive_openmp.h"
-#include "opari2_parser_c.h"
-#include "opari2_parser_f.h"
+#include "opari2_server.h"
 
+using namespace opari2;
 
-#define DEPRECATED_ON
 
+/* name of the output file, removed on errors */
+static string outfile;
 
-/* cmd line options */
-OPARI2_Option_t opt;
+/* set by --write-if-changed */
+static bool write_if_changed = false;
+
+/* dependency file requested by -MD or -MF, with phony targets for -MP */
+static bool   write_dependencies = false;
+static string depfile;
+static bool   phony_targets = false;
 
 void
 print_usage_information( char* prog, std::ostream& output )
@@ -95,365 +98,296 @@ print_usage_information( char* prog, std::ostream& output )
     output << prog << "\n\n" << usage << std::endl;
 }
 
-void
-cleanup_and_exit( void )
+/**
+ * @brief Remove the output file after an error.
+ *
+ * @return The exit status of the command.
+ */
+static int
+remove_outfile( void )
 {
-    if ( !opt.outfile.empty() )
+    if ( !outfile.empty() )
     {
-        remove( opt.outfile.c_str() );
+        remove( outfile.c_str() );
     }
 
-    exit( 1 );
-}
-
-void
-print_deprecated_msg( const string old_form, const string new_form )
-{
-#ifdef DEPRECATED_ON
-    cerr << "Warning: Option \"" << old_form << "\" is deprecated.\n\
-Please use \"" << new_form << "\" for future compatibility.\n";
-#endif
+    return 1;
 }
 
 /**
- * @brief Disable directive entry in the directive_table.
- *
- * Currently supported option:
- * --disable=xx,xx,...
- *  Here xx can possibly be an openmp/pomp directive name, openmp/pomp
- *  group name, or a paradigm type name.
+ * @brief Write text to the file name.
  *
- * Not supported anymore:
- *  -disable xx,xx,...
+ * With --write-if-changed the text goes to a temporary file in the
+ * same directory, which then replaces name, unless name already holds
+ * this text. An unchanged file thus keeps its timestamp, and readers
+ * never see a partly written file.
  *
- * Current --help output (27.03.2014):
- * [--disable=paradigm[:directive|group[:inner],...][+paradigm...]
- *   [OPTIONAL] Disable the instrumentation of whole paradigms, or
- *   specific directives or groups of directives of a paradigm.
- *   Furthermore it gives the possibility to suppress the insertion of
- *   instrumentation functions inside code regions, i.e. only the
- *   surrounding instrumentation is inserted.  *
+ * @return false on errors.
  */
-bool
-set_disabled( const string& constructs )
+static bool
+write_file( const string& name,
+            const string& text )
 {
-    typedef std::pair<char*, bool> dir_and_inner_t;
-
-    char str[ constructs.length() + 1 ];
-    std::strcpy( &str[ 0 ], constructs.c_str() );
-
-    std::vector<char*> paradigms;
-    char*              paradigm = strtok( &str[ 0 ], "+" );
+    if ( !write_if_changed )
+    {
+        ofstream file( name.c_str() );
+        file << text;
+        file.close();
+        return !file.fail();
+    }
 
-    while ( paradigm != NULL )
+    struct stat status;
+    if ( stat( name.c_str(), &status ) == 0 &&
+         static_cast< string::size_type >( status.st_size ) == text.size() )
     {
-        paradigms.push_back( paradigm );
-        paradigm = strtok( NULL, "+" );
+        ifstream old( name.c_str() );
+        string   old_text( ( std::istreambuf_iterator<char>( old ) ),
+                           std::istreambuf_iterator<char>() );
+        if ( old && old_text == text )
+        {
+            return true;
+        }
     }
 
-    for ( vector<char*>::iterator it = paradigms.begin(); it != paradigms.end(); ++it )
+    string       tmp_name = name + ".XXXXXX";
+    vector<char> tmp( tmp_name.begin(), tmp_name.end() );
+    tmp.push_back( '\0' );
+    int fd = mkstemp( &tmp[ 0 ] );
+    if ( fd < 0 )
     {
-        paradigm = strtok( *it, ",:" );
+        return false;
+    }
 
-        dir_and_inner_t               directive;
-        std::vector<dir_and_inner_t > directives;
+    /* mkstemp() creates the file with mode 0600 */
+    mode_t mask = umask( 0 );
+    umask( mask );
+    bool success = fchmod( fd, 0666 & ~mask ) == 0;
 
-        directive.first  = strtok( NULL, "," );
-        directive.second = false;
-        while ( directive.first != NULL )
+    string::size_type done = 0;
+    while ( success && done < text.size() )
+    {
+        ssize_t n = write( fd, text.data() + done, text.size() - done );
+        if ( n <= 0 )
+        {
+            success = false;
+        }
+        else
         {
-            directives.push_back( directive );
-            directive.second = false;
-            directive.first  = strtok( NULL, "," );
+            done += n;
         }
+    }
+    success = close( fd ) == 0 && success;
+
+    if ( !success || rename( &tmp[ 0 ], name.c_str() ) != 0 )
+    {
+        remove( &tmp[ 0 ] );
+        return false;
+    }
+    return true;
+}
 
-        for ( vector<dir_and_inner_t>::iterator it = directives.begin(); it != directives.end(); ++it )
+/**
+ * @brief Escape a file name for a make rule.
+ */
+static string
+make_escape( const string& name )
+{
+    string escaped;
+    for ( string::size_type i = 0; i < name.size(); ++i )
+    {
+        if ( name[ i ] == ' ' || name[ i ] == '#' )
         {
-            if ( strchr( it->first, ':' ) )
-            {
-                it->first = strtok( it->first, ":" );
-                char* inner = strtok( NULL, ":" );
-                if ( strcmp( inner, "inner" ) == 0 )
-                {
-                    it->second = true;
-                }
-                else
-                {
-                    cerr << "Error, unknown identifier " <<  inner << std::endl;
-                    return false;
-                }
-            }
+            escaped += '\\';
+        }
+        else if ( name[ i ] == '$' )
+        {
+            escaped += '$';
         }
+        escaped += name[ i ];
+    }
+    return escaped;
+}
 
-        if ( directives.empty() )
+/**
+ * @brief Write a make rule for the output and the include file to the
+ *        dependency file.
+ *
+ * They depend on the input file, the files named in its line markers,
+ * e.g. the headers of a preprocessed file, and the opari2 program.
+ *
+ * @return false on errors.
+ */
+static bool
+write_depfile( const char* prog )
+{
+    vector<string> deps( 1, opt.infile );
+    for ( set<string>::iterator it = opt.dependencies.begin(); it != opt.dependencies.end(); ++it )
+    {
+        if ( *it != opt.infile )
         {
-            if ( !DisableParadigmDirectiveOrGroup( paradigm, "", false ) )
-            {
-                return false;
-            }
+            deps.push_back( *it );
         }
-        else
+    }
+
+    char    exe[ 4096 ];
+    ssize_t length = readlink( "/proc/self/exe", exe, sizeof( exe ) - 1 );
+    if ( length > 0 )
+    {
+        deps.push_back( string( exe, length ) );
+    }
+    else if ( strchr( prog, '/' ) )
+    {
+        deps.push_back( prog );
+    }
+
+    stringstream rule;
+    if ( !outfile.empty() )
+    {
+        rule << make_escape( outfile ) << " ";
+    }
+    rule << make_escape( opt.incfile ) << ":";
+    for ( vector<string>::iterator it = deps.begin(); it != deps.end(); ++it )
+    {
+        rule << " \\\n " << make_escape( *it );
+    }
+    rule << "\n";
+
+    /* keep make going when a header has been removed */
+    if ( phony_targets )
+    {
+        for ( vector<string>::iterator it = deps.begin() + 1; it != deps.end(); ++it )
         {
-            for ( vector<dir_and_inner_t>::iterator it = directives.begin(); it != directives.end(); ++it )
-            {
-                if ( !DisableParadigmDirectiveOrGroup( paradigm, it->first, it->second ) )
-                {
-                    return false;
-                }
-            }
+            rule << "\n" << make_escape( *it ) << ":\n";
         }
     }
 
-    return true;
+    return write_file( depfile, rule.str() );
 }
 
 /**
- * @brief Parse and handle cmd line options.
+ * @brief Print the timers and counters of this run to stderr.
  *
- * First hanlde global options,
- * then handle paradigm-specific options.
+ * One "name value" pair per line, so the report is easy to parse.
  */
 void
-process_cmd_line( int argc, char* argv[] )
+print_stats( double total )
+{
+    static const char* phase_names[ OPARI2_NUM_PHASES ] =
+    {
+        "read_input", "scan_lines", "build_directives",
+        "run_handlers", "write_output", "finalize"
+    };
+
+    std::ios_base::fmtflags flags = cerr.flags();
+    cerr << "opari2 statistics for " << opt.infile << "\n";
+    cerr.setf( std::ios_base::fixed, std::ios_base::floatfield );
+    cerr.precision( 6 );
+    for ( int i = 0; i < OPARI2_NUM_PHASES; i++ )
+    {
+        cerr << "  time_" << phase_names[ i ] << " " << opari2_stats.time[ i ] << "\n";
+    }
+    cerr << "  time_total " << total << "\n";
+    cerr << "  lines " << opari2_stats.lines << "\n";
+    for ( int i = OPARI2_PT_OMP; i <= OPARI2_PT_TMSE; i++ )
+    {
+        cerr << "  directives_" << paradigm_type_to_string( ( OPARI2_ParadigmType_t )i )
+             << " " << opari2_stats.directives[ i ] << "\n";
+    }
+    cerr << "  regions " << opari2_stats.regions << std::endl;
+    cerr.flags( flags );
+}
+
+/**
+ * @brief Parse and handle cmd line options.
+ *
+ * Options of the instrumentation are passed to OPARI2_SetOption(),
+ * the remaining arguments name the input and output file, which are
+ * opened here. The input file is not opened if read_input is false,
+ * the output file not with --write-if-changed, see write_file().
+ *
+ * @return false if the command is done, e.g. on errors, with its exit
+ *         status in status.
+ */
+static bool
+process_cmd_line( int       argc,
+                  char*     argv[],
+                  bool      read_input,
+                  ifstream& is,
+                  ofstream& out,
+                  int&      status )
 {
     int              a        = 1;
     OPARI2_ErrorCode err_flag = OPARI2_NO_ERROR;
-    const char*      ptr      = NULL;
-
-    opt.lang          = L_NA;
-    opt.form          = F_NA;
-    opt.keep_src_info = true;
-
-    opari2_omp_option* omp_opt = OPARI2_DirectiveOpenmp::GetOpenmpOpt();
+    string           infile;
 
     /* parse global options */
     while ( a < argc && argv[ a ][ 0 ] == '-' )
     {
-        if ( strncmp( argv[ a ], "--omp", 5 ) == 0 )
-        {
-            err_flag =  OPARI2_DirectiveOpenmp::ProcessOption( argv[ a ] );
-            if ( err_flag )
-            {
-                cerr << "ERROR: unknown option " << argv[ a ] << "\n";
-                err_flag = OPARI2_ERROR_WITH_MESSAGE;
-            }
-        }
-        else if ( strcmp( argv[ a ], "--f77" ) == 0 )
-        {
-            opt.lang = L_F77;
-        }
-        else if ( strcmp( argv[ a ], "--f90" ) == 0 )
-        {
-            opt.lang = L_F90;
-        }
-        else if ( strcmp( argv[ a ], "--c++" ) == 0 )
-        {
-            opt.lang = L_CXX;
-        }
-        else if ( strcmp( argv[ a ], "--c" ) == 0 )
-        {
-            opt.lang = L_C;
-        }
-        else if ( strcmp( argv[ a ], "--free-form" ) == 0 )
-        {
-            opt.form = F_FREE;
-        }
-        else if ( strcmp( argv[ a ], "--fix-form" ) == 0 )
-        {
-            opt.form = F_FIX;
-        }
-        else if ( strcmp( argv[ a ], "--version" ) == 0 )
+        if ( strcmp( argv[ a ], "--version" ) == 0 )
         {
             std::cout << "opari2 version " << PACKAGE_VERSION << std::endl;
         }
         else if ( strcmp( argv[ a ], "--help" ) == 0 )
         {
             print_usage_information( argv[ 0 ], std::cout );
-            exit( 0 );
-        }
-        else if ( strcmp( argv[ a ], "--nosrc" ) == 0 )
-        {
-            opt.keep_src_info = false;
+            status = 0;
+            return false;
         }
-        else if ( strcmp( argv[ a ], "--preprocessed" ) == 0 )
+        else if ( strcmp( argv[ a ], "--stats" ) == 0 )
         {
-            opt.preprocessed_file = true;
+            opari2_stats.enabled = true;
         }
-        /* handle "--disable=" */
-        else if ( strncmp( argv[ a ], "--disable", 9 ) == 0 )
+        else if ( strcmp( argv[ a ], "--write-if-changed" ) == 0 )
         {
-            ptr = strchr( argv[ a ], '=' );
-            if ( ptr )
-            {
-                ptr++;
-                if ( !set_disabled( ptr ) )
-                {
-                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
-                }
-            }
-            else
-            {
-                err_flag = OPARI2_ERROR_WITH_MESSAGE;
-                cerr << "ERROR: missing value for option --disable\n";
-            }
+            write_if_changed = true;
         }
-        /*  handle deprecated options */
-        else if ( strcmp( argv[ a ], "--tpd" ) == 0 )
+        else if ( strcmp( argv[ a ], "-MD" ) == 0 )
         {
-            print_deprecated_msg( "--tpd", "--omp-tpd" );
-            omp_opt->copytpd = true;
-            #if HAVE( PLATFORM_K ) || HAVE( PLATFORM_FX10 ) || HAVE( PLATFORM_FX100 )
-            cerr << "WARNING: option --tpd not supported on Fujitsu systems.\n";
-            #endif
+            write_dependencies = true;
         }
-        else if ( strncmp( argv[ a ], "--tpd-mangling=", 15 ) == 0 )
+        else if ( strcmp( argv[ a ], "-MF" ) == 0 )
         {
-            print_deprecated_msg( "--tpd-mangling=<comp>", "--omp-tpd-mangling=<comp>" );
-            char* tpd_arg = strchr( argv[ a ], '=' );
-            if ( tpd_arg != NULL )
+            if ( ++a == argc )
             {
-                tpd_arg++;
-                if ( strcmp( tpd_arg, "gnu" )   == 0 || strcmp( tpd_arg, "sun" ) == 0 ||
-                     strcmp( tpd_arg, "intel" ) == 0 || strcmp( tpd_arg, "pgi" ) == 0 ||
-                     strcmp( tpd_arg, "cray" )  == 0 )
-                {
-                    omp_opt->pomp_tpd            = "pomp_tpd_";
-                    omp_opt->tpd_in_extern_block = false;
-                }
-                else if ( strcmp( tpd_arg, "ibm" ) == 0 )
-                {
-                    omp_opt->pomp_tpd            = "pomp_tpd";
-                    omp_opt->tpd_in_extern_block = true;
-                }
-                else
-                {
-                    cerr << "ERROR: unknown option for --tpd-mangling\n";
-                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
-                }
-            }
-            else
-            {
-                cerr << "ERROR: missing value for option --tpd-mangling\n";
+                cerr << "ERROR: missing file name after -MF\n";
                 err_flag = OPARI2_ERROR_WITH_MESSAGE;
+                break;
             }
+            write_dependencies = true;
+            depfile            = argv[ a ];
         }
-        else if ( strncmp( argv[ a ], "--task=", 7 ) == 0 )
-        {
-            print_deprecated_msg( "--task=<comp>", "--omp-task=<comp>" );
-            char* token = strtok( argv[ a ], "=" );
-            token = strtok( NULL, "," );
-            while ( token != NULL )
-            {
-                if ( strcmp( token, "abort" ) == 0 )
-                {
-                    omp_opt->task_abort = true;
-                }
-                else if ( strcmp( token, "warn" ) == 0 )
-                {
-                    omp_opt->task_warn = true;
-                }
-                else if ( strcmp( token, "remove" ) == 0 )
-                {
-                    omp_opt->task_remove = true;
-                }
-                else
-                {
-                    cerr << "ERROR: unknown option \"" << token << "\" for --task\n";
-                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
-                }
-                token = strtok( NULL, "," );
-            }
-        }
-        else if ( strncmp( argv[ a ], "--untied=", 9 ) == 0 )
+        else if ( strcmp( argv[ a ], "-MP" ) == 0 )
         {
-            print_deprecated_msg( "--untied=<comp>", "--omp-task-untied=<comp>" );
-            char* token = strtok( argv[ a ], "=" );
-            token = strtok( NULL, "," );
-            do
-            {
-                if ( strcmp( token, "abort" ) == 0 )
-                {
-                    omp_opt->untied_abort = true;
-                }
-                else if ( strcmp( token, "no-warn" ) == 0 )
-                {
-                    omp_opt->untied_nowarn = true;
-                }
-                else if ( strcmp( token, "keep" ) == 0 )
-                {
-                    omp_opt->untied_keep = true;
-                }
-                else
-                {
-                    cerr << "ERROR: unknown option \"" << token << "\" for --untied\n";
-                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
-                }
-                token = strtok( NULL, "," );
-            }
-            while ( token != NULL );
+            phony_targets = true;
         }
-        else if ( strcmp( argv[ a ], "-disable" ) == 0 )
+        /* unknown options are ignored */
+        else if ( OPARI2_SetOption( argv[ a ] ) == 1 )
         {
-            cerr << "ERROR: -disable not supported by this version of OPARI2. "
-                 << "Please use --disable=paradigm[:directive|group[:inner],...][+paradigm...]. "
-                 << "Use opari2 --help or refer to the documentation for more details." << std::endl;
             err_flag = OPARI2_ERROR_WITH_MESSAGE;
         }
-        else if ( strcmp( argv[ a ], "-f77" ) == 0 )
-        {
-            print_deprecated_msg( "-f77", "--f77" );
-            opt.lang = L_F77;
-        }
-        else if ( strcmp( argv[ a ], "-f90" ) == 0 )
-        {
-            print_deprecated_msg( "-f90", "--f90" );
-            opt.lang = L_F90;
-        }
-        else if ( strcmp( argv[ a ], "-c++" ) == 0 )
-        {
-            print_deprecated_msg( "-c++", "--c++" );
-            opt.lang = L_CXX;
-        }
-        else if ( strcmp( argv[ a ], "-c" ) == 0 )
-        {
-            print_deprecated_msg( "-c", "--c" );
-            opt.lang = L_C;
-        }
-        else if ( strcmp( argv[ a ], "-nosrc" ) == 0 )
-        {
-            print_deprecated_msg( "-nosrc", "--nosrc" );
-            opt.keep_src_info = false;
-        }
-        else if ( strcmp( argv[ a ], "-rcfile" ) == 0 )
-        {
-            cerr << "WARNING: Option \"-rcfile\" is deprecated and ignored.\n";
-        }
-        else if ( strcmp( argv[ a ], "-table" ) == 0 )
-        {
-            cerr << "WARNING: Option \"-table\" is deprecated and ignored.\n";
-        }
-        /* End of deprecated options */
         ++a;
     }
 
-    /* parse file arguments, prepare input/output stream if specified */
+    /* parse file arguments, prepare output stream if specified */
     switch ( argc - a )
     {
         case 2:
             if ( strcmp( argv[ a + 1 ], "-" ) == 0 )
             {
-                opt.os.std::ostream::rdbuf( cout.rdbuf() );
+                out.std::ostream::rdbuf( cout.rdbuf() );
             }
             else
             {
-                opt.os.open( argv[ a + 1 ] );
-                if ( !opt.os )
+                outfile = string( argv[ a + 1 ] );
+                if ( !write_if_changed )
                 {
-                    cerr << "ERROR: cannot open output file " << argv[ a + 1 ] << "\n";
-                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
+                    out.open( outfile.c_str() );
+                    if ( !out )
+                    {
+                        cerr << "ERROR: cannot open output file " << outfile << "\n";
+                        err_flag = OPARI2_ERROR_WITH_MESSAGE;
+                    }
                 }
-
-                opt.outfile = string( argv[ a + 1 ] );
             }
         /*NOBREAK*/
         case 1:
@@ -473,21 +407,27 @@ process_cmd_line( int argc, char* argv[] )
                 if ( !getcwd( tmp_inf, pathlength ) )
                 {
                     cerr << "ERROR: cannot determine path of input file " << tmp_inf << "\n";
-                    exit( -1 );
+                    delete[] tmp_inf;
+                    status = -1;
+                    return false;
                 }
-                tmp_inf    = strcat( tmp_inf, "/" );
-                tmp_inf    = strcat( tmp_inf, argv[ a ] );
-                opt.infile = string( tmp_inf );
+                tmp_inf = strcat( tmp_inf, "/" );
+                tmp_inf = strcat( tmp_inf, argv[ a ] );
+                infile  = string( tmp_inf );
                 delete[] tmp_inf;
             }
             else
             {
-                opt.infile = string( argv[ a ] );
+                infile = string( argv[ a ] );
+            }
+            if ( !read_input )
+            {
+                break;
             }
-            opt.is.open( opt.infile.c_str() );
-            if ( !opt.is )
+            is.open( infile.c_str() );
+            if ( !is )
             {
-                cerr << "ERROR: cannot open input file " << opt.infile << "\n";
+                cerr << "ERROR: cannot open input file " << infile << "\n";
                 err_flag = OPARI2_ERROR_WITH_MESSAGE;
             }
             break;
@@ -496,86 +436,45 @@ process_cmd_line( int argc, char* argv[] )
             break;
     }
 
-    /* determine language and format by filename if not specified */
-    if ( !err_flag && !opt.infile.empty() && opt.lang == L_NA )
-    {
-        size_t pos = opt.infile.find_last_of( '.' );
-
-        if ( pos < opt.infile.length() + 1  && opt.infile[ pos + 1 ] )
-        {
-            switch ( opt.infile[ pos + 1 ] )
-            {
-                case 'f':
-                case 'F':
-                    opt.lang = opt.infile[ pos + 2 ] == '9' ? L_F90 : L_F77;
-                    break;
-                case 'c':
-                    /*Files *.CUF and *.cuf are CUDA Fortran files*/
-                    if ( opt.infile[ pos + 2 ] == 'u' && opt.infile[ pos + 3 ] == 'f' )
-                    {
-                        opt.lang = L_F90;
-                        break;
-                    }
-                case 'C':
-                    if ( opt.infile[ pos + 2 ] == 'U' && opt.infile[ pos + 3 ] == 'F' )
-                    {
-                        opt.lang = L_F90;
-                        break;
-                    }
-                    opt.lang = opt.infile[ pos + 2 ] ? L_CXX : L_C;
-                    break;
-            }
-        }
-    }
-    if ( !err_flag && opt.infile.empty() && opt.lang == L_NA )
+    /* determine language and format */
+    if ( !err_flag && !OPARI2_InitOptions( infile ) )
     {
-        cerr << "ERROR: cannot determine input file language\n";
         err_flag = OPARI2_ERROR_WITH_MESSAGE;
     }
-    /* if no format is specified, default is free format for f90 and fix form for f77 */
-    if ( ( opt.form == F_NA ) && ( opt.lang & L_FORTRAN ) )
-    {
-        if ( opt.lang & L_F77 )
-        {
-            opt.form = F_FIX;
-        }
-        else
-        {
-            opt.form = F_FREE;
-        }
-    }
 
     /* generate output file name if necessary */
-    if ( !err_flag && opt.outfile.empty() )
+    if ( !err_flag && argc - a == 1 )
     {
         size_t pos = opt.infile.find_last_of( '.' );
         if ( pos != string::npos )
         {
-            opt.outfile = opt.infile;
-            opt.outfile.replace( pos, 1, ".mod." );
+            outfile = opt.infile;
+            outfile.replace( pos, 1, ".mod." );
 
             if ( opt.keep_src_info && ( opt.lang & L_FORTRAN ) )
             {
-                if ( opt.outfile.find( "cuf", pos ) == pos + 5 ||
-                     opt.outfile.find( "CUF", pos ) == pos + 5 )
+                if ( outfile.find( "cuf", pos ) == pos + 5 ||
+                     outfile.find( "CUF", pos ) == pos + 5 )
                 {
-                    opt.outfile[ pos + 5 ] = 'C';
-                    opt.outfile[ pos + 6 ] = 'U';
-                    opt.outfile[ pos + 7 ] = 'F';
+                    outfile[ pos + 5 ] = 'C';
+                    outfile[ pos + 6 ] = 'U';
+                    outfile[ pos + 7 ] = 'F';
                 }
                 else
                 {
-                    opt.outfile[ pos + 5 ] = 'F';
+                    outfile[ pos + 5 ] = 'F';
                 }
             }
 
-            opt.os.open( opt.outfile.c_str() );
-            if ( !opt.os )
+            if ( !write_if_changed )
             {
-                cerr << "ERROR: cannot open output file " << opt.outfile << "\n";
-                err_flag = OPARI2_ERROR_WITH_MESSAGE;
+                out.open( outfile.c_str() );
+                if ( !out )
+                {
+                    cerr << "ERROR: cannot open output file " << outfile << "\n";
+                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
+                }
             }
-            //            opt.os << "\n";
         }
         else
         {
@@ -584,6 +483,25 @@ process_cmd_line( int argc, char* argv[] )
         }
     }
 
+    /* -MD without -MF names the dependency file after the output file */
+    if ( !err_flag && write_dependencies && depfile.empty() )
+    {
+        size_t pos = outfile.find_last_of( "./" );
+        if ( outfile.empty() )
+        {
+            cerr << "ERROR: -MD requires an output file name or -MF\n";
+            err_flag = OPARI2_ERROR_WITH_MESSAGE;
+        }
+        else if ( pos != string::npos && outfile[ pos ] == '.' )
+        {
+            depfile = outfile.substr( 0, pos ) + ".d";
+        }
+        else
+        {
+            depfile = outfile + ".d";
+        }
+    }
+
     /* print usage and die on error */
     if ( err_flag )
     {
@@ -592,124 +510,116 @@ process_cmd_line( int argc, char* argv[] )
             print_usage_information( argv[ 0 ], std::cerr );
         }
 
-        exit( 1 );
+        status = 1;
+        return false;
     }
 
-    return;
+    return true;
 }
 
-void
-misc_init()
+int
+run_command( int           argc,
+             char*         argv[],
+             const string* source,
+             string*       include_text )
 {
-    struct stat status;
-    timeval     compiletime;
-    //long long int     id[ 3 ];
-    uint64_t     id[ 3 ];
-    stringstream id_str;
-    int          rest = 0;
-    /* query inode number of the infile and timestamp as unique attribute */
-    int retval = stat( opt.infile.c_str(), &status );
-
-    // initialize inod_compiletime_id
-    assert( retval == 0 );
-    gettimeofday( &compiletime, NULL );
-
-    //id[ 0 ] = ( long long int )status.st_ino;
-    id[ 0 ] = static_cast< uint64_t > ( status.st_ino );
-    id[ 1 ] = static_cast< uint64_t > ( compiletime.tv_sec );
-    id[ 2 ] = static_cast< uint64_t > ( compiletime.tv_usec );
-
-    for ( int i = 0; i < 3; i++ )
-    {
-        while ( id[ i ] > 36 || ( i > 1 && id[ i ] > 0 ) )
-        {
-            rest     = id[ i ] % 36;
-            id[ i ] -= rest;
-            id[ i ] /= 36;
-            if ( rest < 10 )
-            {
-                id_str << ( char )( rest + 48 );
-            }
-            else
-            {
-                id_str << ( char )( rest + 87 );
-            }
-        }
-        if ( i < 2 )
-        {
-            id[ i + 1 ] += id[ i ];
-        }
+    timeval start_time;
+    gettimeofday( &start_time, NULL );
+
+    ifstream is;
+    ofstream out;
+    int      status;
+    if ( !process_cmd_line( argc, argv, source == NULL, is, out, status ) )
+    {
+        return status;
     }
 
-    // generate opari2 include file name
+    /* read the whole input file unless the caller holds it already */
+    double read_start = OPARI2_StatsStart();
+    string input;
+    if ( source == NULL )
+    {
+        input.assign( std::istreambuf_iterator<char>( is ),
+                      std::istreambuf_iterator<char>() );
+        source = &input;
+    }
+    OPARI2_StatsStop( OPARI2_PHASE_READ, read_start );
 
-    // only need base filename without path for include statement
-    // in Fortran files and if an output file without dir is used
+    /* instrument source file */
+    string output;
+    string include;
+    if ( OPARI2_Instrument( opt.infile, *source, output, include, outfile ) != 0 )
+    {
+        return remove_outfile();
+    }
 
-    size_t sep_in = opt.infile.find_last_of( '/' );
-    opt.incfile_nopath = string( opt.infile.substr( sep_in + 1 ) +
-                                 ".opari.inc" );
+    /* write *.opari.inc and the instrumented source */
+    double write_start = OPARI2_StatsStart();
+    if ( include_text )
+    {
+        include_text->swap( include );
+    }
+    else if ( !write_file( opt.incfile, include ) )
+    {
+        cerr << "ERROR: cannot write opari include file " << opt.incfile << "\n";
+        return 1;
+    }
 
-    size_t sep_out = opt.outfile.find_last_of( '/' );
-    if ( sep_out == string::npos )
+    bool written;
+    if ( write_if_changed && !outfile.empty() )
     {
-        opt.incfile = "";
+        written = write_file( outfile, output );
     }
     else
     {
-        opt.incfile = opt.outfile.substr( 0, sep_out + 1 );
+        out << output;
+        out.flush();
+        written = !out.fail();
+    }
+    if ( !written )
+    {
+        cerr << "ERROR: cannot write output file " << outfile << "\n";
+        return remove_outfile();
+    }
+
+    if ( write_dependencies && !write_depfile( argv[ 0 ] ) )
+    {
+        cerr << "ERROR: cannot write dependency file " << depfile << "\n";
+        return 1;
     }
-    opt.incfile += opt.incfile_nopath;
+    OPARI2_StatsStop( OPARI2_PHASE_WRITE, write_start );
 
-    OPARI2_Directive::SetOptions( opt.lang, opt.form, opt.keep_src_info,
-                                  opt.preprocessed_file, id_str.str() );
+    if ( opari2_stats.enabled )
+    {
+        timeval end_time;
+        gettimeofday( &end_time, NULL );
+        print_stats( ( end_time.tv_sec - start_time.tv_sec ) +
+                     ( end_time.tv_usec - start_time.tv_usec ) * 1e-6 );
+    }
 
-    return;
+    return 0;
 }
 
 /**
  * @brief Main function.
  *
- * Initialize directive and API table, handle command line options,
- * open files and call appropriate process function.
+ * Run the server if the first option is --server, the client if it is
+ * --client, otherwise handle
+ * command line options, read the input file, instrument it with
+ * libopari2 and write the output and the include file.
  */
 int
 main( int   argc,
       char* argv[] )
 {
-    process_cmd_line( argc, argv );
-
-    misc_init();
-
-    /* instrument source file */
-    if ( opt.lang & L_FORTRAN )
+    if ( argc > 1 && strncmp( argv[ 1 ], "--server=", 9 ) == 0 )
     {
-        /* in Fortran no Underscore is needed */
-        OPARI2_DirectiveOpenmp::SetOptPomptpd( "pomp_tpd" );
-
-        OPARI2_FortranParser parser( opt );
-        parser.process();
+        return run_server( argc, argv );
     }
-    else
+    if ( argc > 1 && strncmp( argv[ 1 ], "--client=", 9 ) == 0 )
     {
-        if ( !opt.preprocessed_file )
-        {
-            // const char* basename = strrchr( opt.incfile, '/' );
-            // basename =  basename ? ( basename + 1 ) : opt.incfile;
-            opt.os << "#include \"" << opt.incfile_nopath << "\"" << "\n";
-
-            if ( opt.keep_src_info )
-            {
-                opt.os << "#line 1 \"" << opt.infile << "\"" << "\n";
-            }
-        }
-
-        OPARI2_CParser parser( opt );
-        parser.process();
+        return run_client( argc, argv );
     }
 
-    /* generate *.opari.inc ( by directive_manager ) */
-    Finalize( opt );
-
-    return 0;
+    return run_command( argc, argv, NULL, NULL );
 }
@@ -54,11 +54,18 @@ using std::string;
 #include <fstream>
 using std::ifstream;
 using std::ofstream;
+#include <sstream>
+using std::stringstream;
+using std::istringstream;
+using std::istream;
+using std::ostream;
 #include <stdint.h>
 #include <map>
 using std::map;
 #include <vector>
 using std::vector;
+#include <set>
+using std::set;
 #include <utility>
 using std::pair;
 
@@ -121,18 +128,32 @@ typedef struct
     /** Specifies whether the input file was already partially
         preprocessed */
     bool     preprocessed_file;
+    /** Specifies whether system header spans of a preprocessed file
+        are copied without parsing */
+    bool     skip_system_headers;
+    /** Number of threads scanning the lines of a C/C++ file */
+    int      jobs;
+    /** Specifies whether Fortran instrumentation calls the C
+        functions of the POMP2 library through bind(C) interfaces */
+    bool     fortran_bind_c;
     /** Name of the input file */
-    string   infile;
-    /** Name of the output file */
-    string   outfile;
+    string        infile;
     /** Name of the generated include file (without path) */
-    string   incfile_nopath;
+    string        incfile_nopath;
     /** Name of the generated include file (including path) */
-    string   incfile;
-    /** Input file stream object */
-    ifstream is;
-    /** Output file stream object */
-    ofstream os;
+    string        incfile;
+    /** Source to instrument */
+    istringstream is;
+    /** Instrumented source */
+    stringstream  os;
+    /** Text of the generated include file */
+    stringstream  incs;
+    /** Files named in line markers of the input file */
+    set<string>   dependencies;
+    /** Macros given by -D, with their values */
+    map<string, string> defines;
+    /** Macros given by -U */
+    set<string>         undefines;
 } OPARI2_Option_t;
 
 
@@ -156,6 +177,55 @@ typedef enum OPARI2_ParadigmType
 } OPARI2_ParadigmType_t;
 
 
+/**
+ *  @brief Phases of a run that are timed for the --stats report.
+ */
+typedef enum
+{
+    /** Reading the input file and splitting it into lines */
+    OPARI2_PHASE_READ = 0,
+    /** Scanning lines, i.e. parser time not spent in other phases */
+    OPARI2_PHASE_SCAN,
+    /** Building OPARI2_Directive objects */
+    OPARI2_PHASE_BUILD,
+    /** Running the directive handlers */
+    OPARI2_PHASE_HANDLE,
+    /** Writing the instrumented source and the include file */
+    OPARI2_PHASE_WRITE,
+    /** Generating the include file text in Finalize() */
+    OPARI2_PHASE_FINALIZE,
+    OPARI2_NUM_PHASES
+} OPARI2_Phase_t;
+
+
+/**
+ *  @brief Timers and counters of a run, printed with --stats.
+ */
+typedef struct
+{
+    /** Specifies whether the timers are active */
+    bool     enabled;
+    /** Accumulated wall clock time per phase in seconds */
+    double   time[ OPARI2_NUM_PHASES ];
+    /** Number of lines read from the input file */
+    uint64_t lines;
+    /** Number of directives found per paradigm */
+    uint64_t directives[ OPARI2_PT_TMSE + 1 ];
+    /** Number of regions written to the include file */
+    uint64_t regions;
+} OPARI2_Stats_t;
+
+
+/** @brief Internal state and functions of libopari2. They are kept
+ *         out of the global namespace of programs embedding the
+ *         library, which only use the functions of opari2_lib.h. */
+namespace opari2
+{
+/** Statistics of the current run */
+extern OPARI2_Stats_t opari2_stats;
+} /* namespace opari2 */
+
+
 /**
  *  @brief Definition of error codes.
  */
@@ -178,16 +248,68 @@ typedef enum OPARI2_ErrorCode
 
 #define G_NONE 0x00000000
 
-//extern OPARI2_Option_t opt;
+namespace opari2
+{
+/** Options and streams of the file being instrumented */
+extern OPARI2_Option_t opt;
+
+/**
+ *  @brief Thrown by cleanup_and_exit() to abort the instrumentation
+ *         of the current file.
+ */
+struct OPARI2_Abort
+{
+};
 
 /**
  *  @brief This function can be called anywhere upon an error.
  *
- *  When this function is called, the output file is deleted and the
- *  program is exited.
+ *  The error message must already be printed. The instrumentation of
+ *  the current file is aborted by throwing OPARI2_Abort, which
+ *  OPARI2_Instrument() turns into an error return value.
  */
 void
 cleanup_and_exit( void );
+} /* namespace opari2 */
+
+
+/**
+ *  @brief Sets up opt for instrumenting @a infile with the options
+ *         given to OPARI2_SetOption().
+ *
+ *  The language and format are determined from the file name unless
+ *  specified by options.
+ *
+ *  @return false if the language cannot be determined.
+ */
+bool
+OPARI2_InitOptions( const string& infile );
+
+
+/**
+ *  @brief Returns the start time of a phase measured for --stats, or 0
+ *         if statistics are disabled.
+ */
+double
+OPARI2_StatsStart( void );
+
+
+/**
+ *  @brief Adds the time since @a start to the timer of @a phase if
+ *         statistics are enabled.
+ */
+void
+OPARI2_StatsStop( OPARI2_Phase_t phase,
+                  double         start );
+
+
+/**
+ *  @brief Reads the next line of @a is into @a line, timed and
+ *         counted for --stats.
+ */
+bool
+OPARI2_ReadLine( istream& is,
+                 string&  line );
 
 
 #endif
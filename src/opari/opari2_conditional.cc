@@ -0,0 +1,677 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_conditional.cc
+ *
+ *  @brief      Evaluation of #if expressions and tracking of
+ *              conditional groups, see opari2_conditional.h.
+ */
+
+#include <config.h>
+#include <cctype>
+#include <cstdlib>
+using std::strtoll;
+
+#include "opari2_conditional.h"
+
+
+/** @brief State of the evaluation of one expression. */
+typedef struct
+{
+    vector<string>             tokens;
+    size_t                     pos;
+    const OPARI2_Conditionals* conditionals;
+    int                        depth;
+    bool                       error;
+} expression_t;
+
+static const OPARI2_CondValue_t unknown_value = { 0, false };
+
+static OPARI2_CondValue_t
+known_value( long long value )
+{
+    OPARI2_CondValue_t v = { value, true };
+    return v;
+}
+
+/**
+ * @brief Split a preprocessor expression into identifiers, numbers,
+ *        character literals and operators.
+ */
+static vector<string>
+tokenize( const string& text )
+{
+    static const char* two_char_ops[] =
+    {
+        "&&", "||", "==", "!=", "<=", ">=", "<<", ">>", NULL
+    };
+
+    vector<string>    tokens;
+    string::size_type i = 0;
+    while ( i < text.size() )
+    {
+        string::size_type start = i;
+        char              c     = text[ i ];
+        if ( isspace( c ) )
+        {
+            ++i;
+            continue;
+        }
+        if ( isalpha( c ) || c == '_' )
+        {
+            while ( i < text.size() && ( isalnum( text[ i ] ) || text[ i ] == '_' ) )
+            {
+                ++i;
+            }
+        }
+        else if ( isdigit( c ) )
+        {
+            while ( i < text.size() && ( isalnum( text[ i ] ) || text[ i ] == '_' || text[ i ] == '.' ) )
+            {
+                ++i;
+            }
+        }
+        else if ( c == '\'' )
+        {
+            for ( ++i; i < text.size() && text[ i ] != '\''; ++i )
+            {
+                if ( text[ i ] == '\\' )
+                {
+                    ++i;
+                }
+            }
+            ++i;
+        }
+        else
+        {
+            ++i;
+            for ( int op = 0; two_char_ops[ op ]; ++op )
+            {
+                if ( text.compare( start, 2, two_char_ops[ op ] ) == 0 )
+                {
+                    ++i;
+                    break;
+                }
+            }
+        }
+        tokens.push_back( text.substr( start, i - start ) );
+    }
+    return tokens;
+}
+
+static const string&
+peek( expression_t& e )
+{
+    static const string end;
+    return e.pos < e.tokens.size() ? e.tokens[ e.pos ] : end;
+}
+
+static bool
+accept( expression_t& e,
+        const char*   token )
+{
+    if ( peek( e ) == token )
+    {
+        ++e.pos;
+        return true;
+    }
+    return false;
+}
+
+static int
+precedence( const string& op )
+{
+    if ( op == "*" || op == "/" || op == "%" )
+    {
+        return 10;
+    }
+    if ( op == "+" || op == "-" )
+    {
+        return 9;
+    }
+    if ( op == "<<" || op == ">>" )
+    {
+        return 8;
+    }
+    if ( op == "<" || op == "<=" || op == ">" || op == ">=" )
+    {
+        return 7;
+    }
+    if ( op == "==" || op == "!=" )
+    {
+        return 6;
+    }
+    if ( op == "&" )
+    {
+        return 5;
+    }
+    if ( op == "^" )
+    {
+        return 4;
+    }
+    if ( op == "|" )
+    {
+        return 3;
+    }
+    if ( op == "&&" )
+    {
+        return 2;
+    }
+    if ( op == "||" )
+    {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Apply a binary operator. && and || are known if one known
+ *        operand decides them, all other operators need two known
+ *        operands.
+ */
+static OPARI2_CondValue_t
+apply( const string&      op,
+       OPARI2_CondValue_t l,
+       OPARI2_CondValue_t r )
+{
+    if ( op == "&&" )
+    {
+        if ( ( l.known && !l.value ) || ( r.known && !r.value ) )
+        {
+            return known_value( 0 );
+        }
+        return l.known && r.known ? known_value( 1 ) : unknown_value;
+    }
+    if ( op == "||" )
+    {
+        if ( ( l.known && l.value ) || ( r.known && r.value ) )
+        {
+            return known_value( 1 );
+        }
+        return l.known && r.known ? known_value( 0 ) : unknown_value;
+    }
+    if ( !l.known || !r.known )
+    {
+        return unknown_value;
+    }
+
+    long long a = l.value;
+    long long b = r.value;
+    if ( ( op == "/" || op == "%" ) && b == 0 )
+    {
+        return unknown_value;
+    }
+    if ( ( op == "<<" || op == ">>" ) && ( b < 0 || b > 63 ) )
+    {
+        return unknown_value;
+    }
+
+    switch ( op[ 0 ] )
+    {
+        case '*':
+            return known_value( a * b );
+        case '/':
+            return known_value( a / b );
+        case '%':
+            return known_value( a % b );
+        case '+':
+            return known_value( a + b );
+        case '-':
+            return known_value( a - b );
+        case '&':
+            return known_value( a & b );
+        case '^':
+            return known_value( a ^ b );
+        case '|':
+            return known_value( a | b );
+        case '=':
+            return known_value( a == b );
+        case '!':
+            return known_value( a != b );
+        case '<':
+            if ( op == "<<" )
+            {
+                return known_value( a << b );
+            }
+            return known_value( op == "<" ? a < b : a <= b );
+        case '>':
+            if ( op == ">>" )
+            {
+                return known_value( a >> b );
+            }
+            return known_value( op == ">" ? a > b : a >= b );
+    }
+    return unknown_value;
+}
+
+static OPARI2_CondValue_t
+parse_conditional( expression_t& e );
+
+static OPARI2_CondValue_t
+parse_primary( expression_t& e )
+{
+    string token = peek( e );
+    if ( token.empty() )
+    {
+        e.error = true;
+        return unknown_value;
+    }
+    ++e.pos;
+
+    if ( token == "(" )
+    {
+        OPARI2_CondValue_t v = parse_conditional( e );
+        if ( !accept( e, ")" ) )
+        {
+            e.error = true;
+        }
+        return v;
+    }
+    if ( isdigit( token[ 0 ] ) )
+    {
+        string::size_type end = token.find_last_not_of( "uUlL" );
+        string            number( token, 0, end + 1 );
+        char*             rest;
+        long long         value = strtoll( number.c_str(), &rest, 0 );
+        return *rest == '\0' ? known_value( value ) : unknown_value;
+    }
+    if ( token == "defined" )
+    {
+        bool   paren = accept( e, "(" );
+        string name  = peek( e );
+        ++e.pos;
+        if ( ( paren && !accept( e, ")" ) ) ||
+             name.empty() || !( isalpha( name[ 0 ] ) || name[ 0 ] == '_' ) )
+        {
+            e.error = true;
+            return unknown_value;
+        }
+        return e.conditionals->IsDefined( name );
+    }
+    if ( isalpha( token[ 0 ] ) || token[ 0 ] == '_' )
+    {
+        /* function-like macro, skip its arguments */
+        if ( accept( e, "(" ) )
+        {
+            int level = 1;
+            while ( level > 0 && e.pos < e.tokens.size() )
+            {
+                const string& t = e.tokens[ e.pos++ ];
+                level += ( t == "(" ) - ( t == ")" );
+            }
+            return unknown_value;
+        }
+        return e.conditionals->MacroValue( token, e.depth );
+    }
+    /* character literals */
+    if ( token[ 0 ] == '\'' )
+    {
+        return unknown_value;
+    }
+
+    e.error = true;
+    return unknown_value;
+}
+
+static OPARI2_CondValue_t
+parse_unary( expression_t& e )
+{
+    if ( accept( e, "!" ) )
+    {
+        OPARI2_CondValue_t v = parse_unary( e );
+        return v.known ? known_value( !v.value ) : v;
+    }
+    if ( accept( e, "~" ) )
+    {
+        OPARI2_CondValue_t v = parse_unary( e );
+        return v.known ? known_value( ~v.value ) : v;
+    }
+    if ( accept( e, "-" ) )
+    {
+        OPARI2_CondValue_t v = parse_unary( e );
+        return v.known ? known_value( -v.value ) : v;
+    }
+    if ( accept( e, "+" ) )
+    {
+        return parse_unary( e );
+    }
+    return parse_primary( e );
+}
+
+/**
+ * @brief Parse binary operators with at least the precedence
+ *        min_precedence by precedence climbing.
+ */
+static OPARI2_CondValue_t
+parse_binary( expression_t& e,
+              int           min_precedence )
+{
+    OPARI2_CondValue_t l = parse_unary( e );
+    int                p;
+    while ( ( p = precedence( peek( e ) ) ) >= min_precedence && p > 0 )
+    {
+        string op = peek( e );
+        ++e.pos;
+        OPARI2_CondValue_t r = parse_binary( e, p + 1 );
+        l = apply( op, l, r );
+    }
+    return l;
+}
+
+static OPARI2_CondValue_t
+parse_conditional( expression_t& e )
+{
+    OPARI2_CondValue_t c = parse_binary( e, 1 );
+    if ( !accept( e, "?" ) )
+    {
+        return c;
+    }
+    OPARI2_CondValue_t a = parse_conditional( e );
+    if ( !accept( e, ":" ) )
+    {
+        e.error = true;
+    }
+    OPARI2_CondValue_t b = parse_conditional( e );
+    if ( c.known )
+    {
+        return c.value ? a : b;
+    }
+    if ( a.known && b.known && a.value == b.value )
+    {
+        return a;
+    }
+    return unknown_value;
+}
+
+/** @brief Replace comments in a directive line by blanks. */
+static string
+strip_comments( const string& line )
+{
+    string            text;
+    string::size_type pos = 0;
+    while ( pos < line.size() )
+    {
+        if ( line.compare( pos, 2, "//" ) == 0 )
+        {
+            break;
+        }
+        if ( line.compare( pos, 2, "/*" ) == 0 )
+        {
+            string::size_type end = line.find( "*/", pos + 2 );
+            if ( end == string::npos )
+            {
+                break;
+            }
+            text += ' ';
+            pos   = end + 2;
+            continue;
+        }
+        text += line[ pos++ ];
+    }
+    return text;
+}
+
+/** @brief The identifier at the start of text, after blanks. */
+static string
+first_identifier( const string& text,
+                  string::size_type& end )
+{
+    string::size_type begin = text.find_first_not_of( " \t" );
+    end = begin;
+    while ( end < text.size() && ( isalnum( text[ end ] ) || text[ end ] == '_' ) )
+    {
+        ++end;
+    }
+    return begin == string::npos ? "" : text.substr( begin, end - begin );
+}
+
+
+OPARI2_Conditionals::OPARI2_Conditionals( const OPARI2_Option_t& options )
+    : m_defined( options.defines ), m_undefined( options.undefines )
+{
+    m_active = !m_defined.empty() || !m_undefined.empty();
+}
+
+bool
+OPARI2_Conditionals::InDeadBranch( void ) const
+{
+    return !m_groups.empty() && m_groups.back().dead;
+}
+
+bool
+OPARI2_Conditionals::in_certain_branch( void ) const
+{
+    return m_groups.empty() || m_groups.back().certain;
+}
+
+OPARI2_CondValue_t
+OPARI2_Conditionals::IsDefined( const string& name ) const
+{
+    if ( m_defined.count( name ) )
+    {
+        return known_value( 1 );
+    }
+    if ( m_undefined.count( name ) )
+    {
+        return known_value( 0 );
+    }
+    return unknown_value;
+}
+
+OPARI2_CondValue_t
+OPARI2_Conditionals::MacroValue( const string& name,
+                                 int           depth ) const
+{
+    map<string, string>::const_iterator it = m_defined.find( name );
+    if ( it != m_defined.end() )
+    {
+        if ( depth <= 0 || it->second.find_first_not_of( " \t" ) == string::npos )
+        {
+            return unknown_value;
+        }
+        return Evaluate( it->second, depth - 1 );
+    }
+    if ( m_undefined.count( name ) )
+    {
+        return known_value( 0 );
+    }
+    return unknown_value;
+}
+
+OPARI2_CondValue_t
+OPARI2_Conditionals::Evaluate( const string& expression,
+                               int           depth ) const
+{
+    expression_t e;
+    e.tokens       = tokenize( expression );
+    e.pos          = 0;
+    e.conditionals = this;
+    e.depth        = depth;
+    e.error        = false;
+
+    OPARI2_CondValue_t v = parse_conditional( e );
+    if ( e.error || e.pos != e.tokens.size() )
+    {
+        return unknown_value;
+    }
+    return v;
+}
+
+void
+OPARI2_Conditionals::enter_branch( group_t&           group,
+                                   OPARI2_CondValue_t condition )
+{
+    if ( group.parent_dead || group.taken ||
+         ( condition.known && !condition.value ) )
+    {
+        group.dead    = true;
+        group.certain = false;
+        return;
+    }
+
+    group.dead    = false;
+    group.certain = group.parent_certain && condition.known && !group.maybe_taken;
+    if ( condition.known )
+    {
+        group.taken = true;
+    }
+    else
+    {
+        group.maybe_taken = true;
+    }
+}
+
+bool
+OPARI2_Conditionals::HandleDirective( const string& directive )
+{
+    string::size_type hash = directive.find( '#' );
+    if ( !m_active || hash == string::npos )
+    {
+        return false;
+    }
+
+    string::size_type end;
+    string            keyword = first_identifier( directive.substr( hash + 1 ), end );
+    string            rest    = directive.substr( hash + 1 + end );
+
+    if ( keyword == "if" || keyword == "ifdef" || keyword == "ifndef" )
+    {
+        group_t group;
+        group.parent_dead    = InDeadBranch();
+        group.parent_certain = in_certain_branch();
+        group.taken          = false;
+        group.maybe_taken    = false;
+
+        OPARI2_CondValue_t condition = unknown_value;
+        if ( group.parent_dead )
+        {
+            /* not evaluated */
+        }
+        else if ( keyword == "if" )
+        {
+            condition = Evaluate( rest );
+        }
+        else
+        {
+            condition = IsDefined( first_identifier( rest, end ) );
+            if ( keyword == "ifndef" && condition.known )
+            {
+                condition.value = !condition.value;
+            }
+        }
+        enter_branch( group, condition );
+        m_groups.push_back( group );
+    }
+    else if ( keyword == "elif" )
+    {
+        if ( !m_groups.empty() )
+        {
+            group_t& group = m_groups.back();
+            enter_branch( group, group.parent_dead || group.taken ?
+                          unknown_value : Evaluate( rest ) );
+        }
+    }
+    else if ( keyword == "else" )
+    {
+        if ( !m_groups.empty() )
+        {
+            enter_branch( m_groups.back(), known_value( 1 ) );
+        }
+    }
+    else if ( keyword == "endif" )
+    {
+        if ( !m_groups.empty() )
+        {
+            m_groups.pop_back();
+        }
+    }
+    else if ( keyword == "define" || keyword == "undef" )
+    {
+        if ( InDeadBranch() )
+        {
+            return true;
+        }
+        string name = first_identifier( rest, end );
+        if ( name.empty() )
+        {
+            return true;
+        }
+        m_defined.erase( name );
+        m_undefined.erase( name );
+
+        /* in a branch that may not be taken the macro becomes unknown */
+        if ( !in_certain_branch() )
+        {
+            return true;
+        }
+        if ( keyword == "undef" )
+        {
+            m_undefined.insert( name );
+        }
+        /* the value of function-like macros is not evaluated */
+        else if ( end < rest.size() && rest[ end ] == '(' )
+        {
+            m_defined[ name ] = "";
+        }
+        else
+        {
+            m_defined[ name ] = rest.substr( end );
+        }
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void
+OPARI2_Conditionals::HandleLine( const string& line )
+{
+    if ( m_continued.empty() )
+    {
+        string::size_type start = line.find_first_not_of( " \t" );
+        if ( start == string::npos || line[ start ] != '#' )
+        {
+            return;
+        }
+    }
+
+    string text = m_continued + line;
+    if ( !text.empty() && text[ text.size() - 1 ] == '\\' )
+    {
+        m_continued = text.substr( 0, text.size() - 1 );
+        return;
+    }
+    m_continued.clear();
+
+    HandleDirective( strip_comments( text ) );
+}
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_conditional.h
+ *
+ *  @brief      Resolution of conditional compilation with the macros
+ *              given by -D and -U, so that the parsers can skip the
+ *              branches the compiler drops.
+ */
+
+#ifndef OPARI2_CONDITIONAL_H
+#define OPARI2_CONDITIONAL_H
+
+#include <string>
+using std::string;
+#include <map>
+using std::map;
+#include <set>
+using std::set;
+#include <vector>
+using std::vector;
+
+#include "opari2.h"
+
+
+/** @brief Value of a preprocessor expression, which may be unknown if
+ *         it depends on macros neither given by -D nor by -U. */
+typedef struct
+{
+    long long value;
+    bool      known;
+} OPARI2_CondValue_t;
+
+/**
+ * @brief Tracks #if, #ifdef, #ifndef, #elif, #else and #endif groups.
+ *
+ * Macros given by -D are defined, macros given by -U are undefined,
+ * all other macros are unknown, as they may come from headers that
+ * are not read. A branch is dead if its condition is known to be
+ * false, or an earlier branch of its group is known to be taken.
+ * Branches with unknown conditions are parsed as before. #define and
+ * #undef in live branches update the macros.
+ */
+class OPARI2_Conditionals
+{
+public:
+    OPARI2_Conditionals( const OPARI2_Option_t& options );
+
+    /**
+     * @brief Handle a complete preprocessor directive.
+     *
+     * @param directive  Text of the directive including the '#', without
+     *                   comments and line continuations.
+     *
+     * @return true if the directive was a conditional or a macro
+     *         definition that has been handled.
+     */
+    bool
+    HandleDirective( const string& directive );
+
+    /**
+     * @brief Handle a source line, e.g. of a dead branch, which the
+     *        parsers copy without parsing. Directives are passed to
+     *        HandleDirective(), also if continued over several lines.
+     */
+    void
+    HandleLine( const string& line );
+
+    /** @brief Whether the following lines are in a dead branch. */
+    bool
+    InDeadBranch( void ) const;
+
+    /** @brief Value of expression with the current macros. Macros are
+     *         expanded up to depth levels deep. */
+    OPARI2_CondValue_t
+    Evaluate( const string& expression,
+              int           depth = 16 ) const;
+
+    /** @brief Value of the macro name, or unknown. */
+    OPARI2_CondValue_t
+    MacroValue( const string& name,
+                int           depth ) const;
+
+    /** @brief 1 if the macro name is defined, 0 if not, or unknown. */
+    OPARI2_CondValue_t
+    IsDefined( const string& name ) const;
+
+private:
+    /** @brief State of one #if group. */
+    typedef struct
+    {
+        /** the group is in a dead branch */
+        bool parent_dead;
+        /** the group is in a branch that is known to be taken */
+        bool parent_certain;
+        /** a branch with a condition known to be true has been seen */
+        bool taken;
+        /** a branch with an unknown condition has been seen */
+        bool maybe_taken;
+        /** the current branch is dead */
+        bool dead;
+        /** the current branch is known to be taken */
+        bool certain;
+    } group_t;
+
+    bool                m_active;
+    map<string, string> m_defined;
+    set<string>         m_undefined;
+    vector<group_t>     m_groups;
+    string              m_continued;
+
+    bool
+    in_certain_branch( void ) const;
+
+    void
+    enter_branch( group_t&           group,
+                  OPARI2_CondValue_t condition );
+};
+
+#endif /* OPARI2_CONDITIONAL_H */
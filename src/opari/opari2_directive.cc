@@ -52,12 +52,15 @@ using std::cerr;
 #include <algorithm>
 using std::transform;
 using std::remove_if;
+using std::lower_bound;
 
 #include "common.h"
 #include "opari2.h"
 #include "opari2_directive.h"
 #include "opari2_directive_manager.h"
 
+using namespace opari2;
+
 
 OPARI2_Directive::OPARI2_Directive( const string&   fname,
                                     const int       ln,
@@ -85,6 +88,7 @@ OPARI2_Directive::OPARI2_Directive( const string&   fname,
     m_orig_lines = lines;
     m_name.clear();
     m_needs_end_loop_directive = false;
+    arena_slot                 = -1;
 }
 
 
@@ -110,29 +114,6 @@ OPARI2_Directive::GetName( void )
 }
 
 
-/** @brief Returns whether a clause is present */
-bool
-OPARI2_Directive::HasClause( const string& clause )
-{
-    return m_clauses.find( clause ) != m_clauses.end();
-}
-
-
-/** @brief Returns the argument of a clause */
-string
-OPARI2_Directive::GetClauseArg( const string& clause )
-{
-    if ( m_clauses.find( clause ) != m_clauses.end() )
-    {
-        return m_clauses[ clause ];
-    }
-    else
-    {
-        return "";
-    }
-}
-
-
 void
 OPARI2_Directive::DelInlineComments( void )
 {
@@ -563,6 +544,10 @@ OPARI2_Directive::generate_ctc_string_common( OPARI2_Format_t form,
 
  * @endcode
  *
+ * With --fortran-bind-c the CTC-string is terminated with char(0),
+ * i.e. c_null_char, for the C functions called through bind(C)
+ * interfaces.
+ *
  * C/C++ example:
  * @code
 
@@ -576,6 +561,10 @@ void
 OPARI2_Directive::generate_descr_common( ostream& os  )
 {
     string ctc_string = generate_ctc_string( s_format );
+    if ( s_bind_c && ( s_lang & L_FORTRAN ) )
+    {
+        ctc_string += s_format == F_FIX ? "\n     &//char(0)" : "//char(0)";
+    }
 
     if ( s_lang & L_F77 )
     {
@@ -628,6 +617,73 @@ OPARI2_Directive::generate_descr_common( ostream& os  )
 }
 
 
+/* *INDENT-OFF* */
+/**
+ * Fortran 90 example:
+ * @code
+
+      subroutine POMP2_Parallel_join(a1, a2) &
+        bind(C, name="POMP2_Parallel_join")
+      use, intrinsic :: iso_c_binding
+      integer( c_int64_t ) :: a1
+      integer( c_int64_t ), value :: a2
+      end subroutine
+
+ * @endcode
+ */
+/* *INDENT-ON* */
+void
+OPARI2_Directive::generate_bind_c_interface( ostream&                     os,
+                                             const OPARI2_BindCInterface& function )
+{
+    const char* kind = function.result ? "function" : "subroutine";
+
+    os << "      ";
+    if ( function.result )
+    {
+        os << function.result << " ";
+    }
+    os << kind << " " << function.name << "(";
+    for ( int i = 0; function.arguments[ i ]; ++i )
+    {
+        os << ( i ? ", a" : "a" ) << i + 1;
+    }
+    os << ")";
+    if ( s_format == F_FIX )
+    {
+        os << "\n     &  ";
+    }
+    else
+    {
+        os << " &\n        ";
+    }
+    os << "bind(C, name=\"" << function.c_name << "\")\n";
+    os << "      use, intrinsic :: iso_c_binding\n";
+
+    for ( int i = 0; function.arguments[ i ]; ++i )
+    {
+        switch ( function.arguments[ i ] )
+        {
+            case 'r':
+            case 't':
+                os << "      integer( c_int64_t ) :: ";
+                break;
+            case 'T':
+                os << "      integer( c_int64_t ), value :: ";
+                break;
+            case 'i':
+                os << "      integer( c_int ), value :: ";
+                break;
+            case 'c':
+                os << "      character( kind=c_char ), dimension( * ) :: ";
+                break;
+        }
+        os << "a" << i + 1 << "\n";
+    }
+    os << "      end " << kind << "\n";
+}
+
+
 void
 OPARI2_Directive::remove_commas( void )
 {
@@ -672,9 +728,11 @@ OPARI2_Directive::find_arguments( unsigned&          line,
     }
     pos += clause.length();
 
+    bool has_arguments = false;
     pos = m_lines[ line ].find_first_not_of( " \t", pos );
     if ( ( pos != string::npos ) && ( m_lines[ line ][ pos ] == '(' ) )
     {
+        has_arguments = true;
         bracket_counter++;
         if ( remove )
         {
@@ -715,7 +773,7 @@ OPARI2_Directive::find_arguments( unsigned&          line,
 
         if ( pos >= m_lines[ line ].length() || contComm )
         {
-            if ( s_lang & L_FORTRAN && !remove_empty_line( line ) )
+            if ( !( s_lang & L_FORTRAN ) || !remove_empty_line( line ) )
             {
                 line++;
             }
@@ -751,7 +809,10 @@ OPARI2_Directive::find_arguments( unsigned&          line,
     //remove last bracket if necessary
     if ( remove && pos != string::npos )
     {
-        m_lines[ line ][ pos ] = ' ';
+        if ( has_arguments )
+        {
+            m_lines[ line ][ pos ] = ' ';
+        }
         //remove comma after the removed clause if needed
         while ( m_lines[ line ][ pos ] == ' ' )
         {
@@ -764,13 +825,7 @@ OPARI2_Directive::find_arguments( unsigned&          line,
     }
 
 
-    size_t p;
-    p = arguments.find( ' ' );
-    while ( p != string::npos )
-    {
-        arguments.erase( p, 1 );
-        p = arguments.find( ' ' );
-    }
+    arguments.erase( std::remove( arguments.begin(), arguments.end(), ' ' ), arguments.end() );
     return arguments;
 }
 
@@ -795,97 +850,121 @@ OPARI2_Directive::remove_empty_line( unsigned& line )
 }
 
 
-bool
-OPARI2_Directive::find_word( const string       word,
-                             unsigned&          line,
-                             string::size_type& pos )
+/** @brief Check whether c can be part of a word in 'm_words'. */
+static inline bool
+is_word_char( char c )
 {
-    if ( s_lang & L_C_OR_CXX )
+    return isalnum( ( unsigned char )c ) || c == '_' || c == '$';
+}
+
+
+void
+OPARI2_Directive::tokenize( void )
+{
+    m_words.clear();
+    m_words_line_lengths.clear();
+
+    int depth = 0;
+    for ( unsigned i = 0; i < m_lines.size(); ++i )
     {
-        for ( unsigned i = line; i < m_lines.size(); ++i )
+        const string&     l = m_lines[ i ];
+        string::size_type p = 0;
+        while ( p < l.length() )
         {
-            string::size_type w = m_lines[ i ].find( word );
-            while ( w != string::npos )
+            if ( !is_word_char( l[ p ] ) )
             {
-                char a;
-                char b;
-                //word may start at position 0 of a continuation line
-                if ( w == 0 )
-                {
-                    b = ' ';
-                }
-                else
-                {
-                    b = m_lines[ i ][ w - 1 ];
-                }
-
-                if ( m_lines[ i ].length() > w + word.length() )
+                if ( l[ p ] == '(' )
                 {
-                    a = m_lines[ i ][ w + word.length() ];
+                    ++depth;
                 }
-                else
+                else if ( l[ p ] == ')' )
                 {
-                    a = ' ';
-                }
-
-                if ( ( b == ' ' || b == '\t' || b == '/' || b == ')' || b == ',' || b == '#' ) &&
-                     ( a == ' ' || a == '\t' || a == '/' || a == '(' || a == ',' ) )
-                {
-                    line = i;
-                    pos  = w;
-                    return true;
-                }
-                else
-                {
-                    w++;
-                    if ( w != string::npos )
-                    {
-                        w = m_lines[ i ].find( word, w );
-                    }
+                    --depth;
                 }
+                ++p;
+                continue;
+            }
+            string::size_type w = p;
+            while ( p < l.length() && is_word_char( l[ p ] ) )
+            {
+                ++p;
+            }
+            if ( depth <= 0 )
+            {
+                m_words[ l.substr( w, p - w ) ].push_back( make_pair( i, w ) );
             }
-            pos = 0;
         }
+        m_words_line_lengths.push_back( l.length() );
     }
-    else if ( s_lang & L_FORTRAN )
+}
+
+
+bool
+OPARI2_Directive::find_word( const string       word,
+                             unsigned&          line,
+                             string::size_type& pos )
+{
+    bool valid = m_words_line_lengths.size() == m_lines.size();
+    for ( unsigned i = 0; valid && i < m_lines.size(); ++i )
+    {
+        valid = m_words_line_lengths[ i ] == m_lines[ i ].length();
+    }
+    if ( !valid )
     {
-        for ( unsigned i = line; i < m_lines.size(); ++i )
+        tokenize();
+    }
+
+    map<string, vector<pair<unsigned, string::size_type> > >::const_iterator found = m_words.find( word );
+    if ( found == m_words.end() )
+    {
+        return false;
+    }
+
+    /* The occurrences are sorted by position, so the search can start
+       at the first one at or after line:pos. */
+    const vector<pair<unsigned, string::size_type> >&          at = found->second;
+    vector<pair<unsigned, string::size_type> >::const_iterator it =
+        lower_bound( at.begin(), at.end(), make_pair( line, pos ) );
+
+    for (; it != at.end(); ++it )
+    {
+        unsigned          i = it->first;
+        string::size_type w = it->second;
+        const string&     l = m_lines[ i ];
+
+        // skip words that were blanked out in the meantime
+        if ( l.compare( w, word.length(), word ) != 0 )
         {
-            string::size_type s = ( pos == 0 ) ? m_lines[ i ].find( m_directive_prefix[ 0 ] ) + m_directive_prefix[ 0 ].length() : pos;
-            string::size_type w = m_lines[ i ].find( word, s );
-            string::size_type c = m_lines[ i ].find( '!', s );
-            // if word found and found before comment
-            while ( w != string::npos &&
-                    ( c == string::npos || ( c != string::npos && w < c ) )
-                    )
+            continue;
+        }
+
+        char b = w == 0 ? ' ' : l[ w - 1 ];
+        char a = l.length() > w + word.length() ? l[ w + word.length() ] : ' ';
+
+        if ( s_lang & L_C_OR_CXX )
+        {
+            if ( ( b == ' ' || b == '\t' || b == '/' || b == ')' || b == ',' || b == '#' ) &&
+                 ( a == ' ' || a == '\t' || a == '/' || a == '(' || a == ',' ) )
             {
-                char b = m_lines[ i ][ w - 1 ];
-                char a;
-                if ( m_lines[ i ].length() > w + word.length() )
-                {
-                    a = m_lines[ i ][ w + word.length() ];
-                }
-                else
-                {
-                    a = ' ';
-                }
-                if ( ( b == ' ' || b == '\t' || b == '!' || b == ')' || b == ',' ) &&
-                     ( a == ' ' || a == '\t' || a == '!' || a == '(' || a == ',' || a == '&' ) )
-                {
-                    line = i;
-                    pos  = w;
-                    return true;
-                }
-                else
-                {
-                    w++;
-                    if ( w != string::npos )
-                    {
-                        w = m_lines[ i ].find( word, w );
-                    }
-                }
+                line = i;
+                pos  = w;
+                return true;
+            }
+        }
+        else if ( s_lang & L_FORTRAN )
+        {
+            // words must follow the sentinel and precede a comment
+            string::size_type s = ( i != line || pos == 0 ) ?
+                                  l.find( m_directive_prefix[ 0 ] ) + m_directive_prefix[ 0 ].length() : pos;
+            string::size_type c = l.find( '!', s );
+            if ( w >= s && ( c == string::npos || w < c ) &&
+                 ( b == ' ' || b == '\t' || b == '!' || b == ')' || b == ',' ) &&
+                 ( a == ' ' || a == '\t' || a == '!' || a == '(' || a == ',' || a == '&' ) )
+            {
+                line = i;
+                pos  = w;
+                return true;
             }
-            pos = 0;
         }
     }
     return false;
@@ -978,7 +1057,9 @@ OPARI2_Directive::fix_clause_arg( vector<string>&    outer,
     string            sentinel = m_directive_prefix[ 0 ];
     string::size_type slen     = sentinel.length();
 
-    while ( *optr != ')' )
+    /* arguments may contain parentheses, e.g. schedule(static, f(n)) */
+    int depth = 0;
+    for (;; )
     {
         while ( ( ( s_lang & L_C_OR_CXX ) &&  *optr == '\\' )                 ||
                 ( ( ( s_lang & L_FORTRAN  ) && ( *optr == '!' || *optr == '&' ) ) ||
@@ -1008,6 +1089,14 @@ OPARI2_Directive::fix_clause_arg( vector<string>&    outer,
             optr = &( outer[ line ][ pos ] );
             iptr = &( inner[ line ][ pos ] );
         }
+        if ( *optr == '(' )
+        {
+            ++depth;
+        }
+        else if ( *optr == ')' && --depth <= 0 )
+        {
+            break;
+        }
         *iptr = *optr;
         *optr = ' ';
         ++iptr;
@@ -1028,19 +1117,18 @@ OPARI2_Directive::remove_empties( void )
 {
     if ( s_lang & L_C_OR_CXX )
     {
-        vector<string>::iterator it = m_lines.begin();
-        while ( it != m_lines.end() )
+        // move the lines to keep to the front in one pass
+        vector<string>::iterator kept = m_lines.begin();
+        for ( vector<string>::iterator it = m_lines.begin(); it != m_lines.end(); ++it )
         {
             string::size_type l = it->find_first_not_of( " \t&" );
-            if ( l == string::npos || ( *it )[ l ] == '\\' )
+            if ( l != string::npos && ( *it )[ l ] != '\\' )
             {
-                it = m_lines.erase( it );
-            }
-            else
-            {
-                ++it;
+                kept->swap( *it );
+                ++kept;
             }
         }
+        m_lines.erase( kept, m_lines.end() );
 
         // make sure last line is not a continued line
         int               lastline = m_lines.size() - 1;
@@ -1054,8 +1142,8 @@ OPARI2_Directive::remove_empties( void )
     {
         // remove lines without content
         string                   sentinel = m_directive_prefix[ 0 ];
-        vector<string>::iterator it       = m_lines.begin();
-        while ( it != m_lines.end() )
+        vector<string>::iterator kept     = m_lines.begin();
+        for ( vector<string>::iterator it = m_lines.begin(); it != m_lines.end(); ++it )
         {
             string::size_type pos = it->find( sentinel ) + sentinel.length();
             if ( ( *it )[ pos ] == '&' || ( *it )[ pos ] == '+' )
@@ -1063,15 +1151,13 @@ OPARI2_Directive::remove_empties( void )
                 ++pos;
             }
             pos = it->find_first_not_of( " \t&", pos );
-            if ( pos == string::npos || ( *it )[ pos ] == '!' )
-            {
-                it = m_lines.erase( it );
-            }
-            else
+            if ( pos != string::npos && ( *it )[ pos ] != '!' )
             {
-                ++it;
+                kept->swap( *it );
+                ++kept;
             }
         }
+        m_lines.erase( kept, m_lines.end() );
 
         // make sure 1st line is not a continuation line
         string::size_type pos = m_lines[ 0 ].find( sentinel );
@@ -1112,15 +1198,25 @@ OPARI2_Directive::SetOptions(  OPARI2_Language_t lang,
                                OPARI2_Format_t   form,
                                bool              keep_src,
                                bool              preprocessed,
+                               bool              bind_c,
                                const string      id )
 {
     s_lang                 = lang;
     s_format               = form;
     s_keep_src_info        = keep_src;
     s_preprocessed_file    = preprocessed;
+    s_bind_c               = bind_c;
     s_inode_compiletime_id = id;
 }
 
+void
+OPARI2_Directive::ResetRegions( void )
+{
+    s_common_block.clear();
+    s_outer           = NULL;
+    s_num_all_regions = 0;
+}
+
 /**
  * Where/when are they modified?
  */
@@ -1132,3 +1228,4 @@ OPARI2_Language_t OPARI2_Directive::s_lang                           = L_NA;
 OPARI2_Format_t   OPARI2_Directive::  s_format                       = F_NA;
 bool              OPARI2_Directive::             s_keep_src_info     = false;
 bool              OPARI2_Directive::             s_preprocessed_file = false;
+bool              OPARI2_Directive::             s_bind_c            = false;
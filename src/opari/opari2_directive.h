@@ -26,6 +26,8 @@ using std::string;
 using std::vector;
 #include <set>
 using std::set;
+#include <map>
+using std::map;
 #include <sstream>
 using std::stringstream;
 #include <iostream>
@@ -35,6 +37,22 @@ using std::pair;
 using std::make_pair;
 #include "opari2.h"
 
+/**
+ *  @brief C function of a paradigm library that instrumented Fortran
+ *         code calls through a bind(C) interface, see --fortran-bind-c.
+ */
+typedef struct
+{
+    const char* name;      /**< name called by the Fortran code */
+    const char* c_name;    /**< name of the C function */
+    const char* arguments; /**< one character per argument: 'r' region
+                                handle, 't' task handle, 'T' task handle
+                                by value, 'i' int by value, 'c' null
+                                terminated CTC string */
+    const char* result;    /**< result type of a function, NULL for a
+                                subroutine */
+} OPARI2_BindCInterface;
+
 /**
  *  @brief Abstract base class to store and manipulate directive
  *         related data
@@ -185,10 +203,6 @@ protected:
     /** directive name */
     string m_name;
 
-    /** A vector of pairs, consisting of clauses and their
-        arguments */
-    OPARI2_StrStr_map_t m_clauses;
-
     /* Global ID of instrumented region */
     int m_id;
 
@@ -223,6 +237,17 @@ protected:
     /** all original lines */
     vector<string> m_orig_lines;
 
+    /** Positions of the words in 'm_lines' outside of parentheses,
+        i.e., of the directive and clause names, indexed by the word. A
+        word is a maximal sequence of letters, digits, '_' and '$'. */
+    map<string, vector<pair<unsigned, string::size_type> > > m_words;
+
+    /** Lengths of the lines in 'm_lines' when 'm_words' was built. The
+        index is built again when a line was added, removed or changed
+        its length. Blanking out characters keeps it valid, as blanked
+        words are skipped by find_word(). */
+    vector<string::size_type> m_words_line_lengths;
+
     /** A series of tokens that identify a pragma/directive */
     vector<string> m_directive_prefix;
 
@@ -269,6 +294,10 @@ protected:
     /** Specifies whether the file was already preprocessed */
     static bool s_preprocessed_file;
 
+    /** Specifies whether Fortran instrumentation calls the POMP2
+        library through bind(C) interfaces */
+    static bool s_bind_c;
+
     /** A unique id that is needed to distinguish the initialization
         routines of the different compile units of the target
         application. It should not be placed here as it is strictly
@@ -286,14 +315,6 @@ public:
     string&
     GetName( void );
 
-    /** @brief Returns whether a clause is present */
-    bool
-    HasClause( const string& clause );
-
-    /** @brief Returns the argument of a clause */
-    string
-    GetClauseArg( const string& clause );
-
     /** @brief Deletes comments in directive lines */
     void
     DelInlineComments( void );
@@ -363,6 +384,7 @@ public:
                 OPARI2_Format_t   form,
                 bool              keep_src,
                 bool              preprocessed,
+                bool              bind_c,
                 const string      id );
 
     /** @brief Returns the file specific identifier to distinguish different
@@ -387,6 +409,10 @@ public:
     static void
     FinalizeFortranDescrs( ostream& os );
 
+    /** @brief Forget the regions of the previous file */
+    static void
+    ResetRegions( void );
+
     void
     FinishRegion( void );
 
@@ -423,6 +449,14 @@ protected:
     void
     generate_descr_common( ostream& os );
 
+    /**
+     * @brief Generate the bind(C) interface body of a C function for
+     *        the interface block of a Fortran include file
+     */
+    static void
+    generate_bind_c_interface( ostream&                     os,
+                               const OPARI2_BindCInterface& function );
+
 
     /**
      * @brief Generic part of identifying a directive name
@@ -451,11 +485,20 @@ protected:
     bool
     remove_empty_line( unsigned& line );
 
+    /**
+     * @brief Builds the index 'm_words' of the words in 'm_lines'.
+     */
+    void
+    tokenize( void );
+
     /**
      * @brief Check if 'word' can be found in directive 'm_lines'.
      *
-     * If true, save the line number within 'm_lines' in 'line' and
-     * offset within the line in 'pos'.
+     * The search starts at offset 'pos' of line 'line'. If true,
+     * save the line number within 'm_lines' in 'line' and offset
+     * within the line in 'pos'. 'word' must consist of the characters
+     * of a word as defined for 'm_words' and is not found inside the
+     * arguments of a clause.
      *
      * @return  true  if 'word' is found in m_lines.
      *		false otherwise.
@@ -619,6 +662,9 @@ public:
         return inner;
     }
     bool active;
+    /** slot of the directive in the arena of the directive manager,
+        -1 if it was allocated with new */
+    int arena_slot;
 };
 
 #endif  //OPARI2_DIRECTIVE_H
@@ -30,6 +30,7 @@ using std::map;
 #include <stack>
 using std::stack;
 #include <stdlib.h>
+#include <new>
 #include <cctype>
 using std::toupper;
 
@@ -50,6 +51,9 @@ using std::toupper;
 #include "offload/opari2_directive_offload.h"
 #include "offload/opari2_directive_entry_offload.h"
 
+namespace opari2
+{
+
 static const OPARI2_MapString2ParadigmNameType paradigm_identifiers[] =
 {
     OPARI2_OPENMP_SENTINELS,
@@ -61,7 +65,7 @@ static const OPARI2_MapString2ParadigmNameType paradigm_identifiers[] =
  * @brief Array holding all definitions for all supported directives
  *        of all supported paradigms.
  */
-OPARI2_DirectiveDefinition directive_table[] =
+static OPARI2_DirectiveDefinition directive_table[] =
 {
     OPARI2_OPENMP_DIRECTIVE_ENTRIES,
     OPARI2_POMP_DIRECTIVE_ENTRIES,
@@ -74,20 +78,20 @@ OPARI2_DirectiveDefinition directive_table[] =
  * @brief Array holding all definitions for all supported API
  *        functions of all supported paradigms.
  */
-OPARI2_RuntimeAPIDefinition api_table[] =
+static OPARI2_RuntimeAPIDefinition api_table[] =
 {
     OPARI2_OPENMP_API_ENTRIES
     //OPARI2_OPENACC_API_ENTRIES
 };
 
 
-OPARI2_Directive* saved_single_line_directive = NULL;
+static OPARI2_Directive* saved_single_line_directive = NULL;
 
 
 /**
  * @brief Convert paradigm string to ParadigmType.
  */
-OPARI2_ParadigmType_t
+static OPARI2_ParadigmType_t
 string_to_paradigm_type( const string& str )
 {
     int n = sizeof( paradigm_identifiers ) / sizeof( OPARI2_MapString2ParadigmNameType );
@@ -147,7 +151,7 @@ paradigm_type_to_string( OPARI2_ParadigmType_t type )
  * @return				G_NONE:	conversion failed
  *						others: OK
  */
-uint64_t
+static uint64_t
 string_to_group( OPARI2_ParadigmType_t type,
                  const string&         str )
 {
@@ -165,15 +169,138 @@ string_to_group( OPARI2_ParadigmType_t type,
     }
 }
 
-vector<OPARI2_Directive*> tmp_directives;
-vector<OPARI2_Directive*> directive_vec;
-vector<OPARI2_Directive*> directive_stack;
+/**
+ * @brief Storage for the directives created by NewDirective().
+ *
+ * Directives are constructed in large blocks instead of one heap
+ * allocation each. Each directive knows its slot in the arena, the
+ * slot records whether the directive was saved for the include file,
+ * so handing it over in SaveForInit() and releasing it early in
+ * DirectiveStackPop() take constant time. All remaining directives
+ * are destroyed and the blocks freed in bulk by Release().
+ */
+class OPARI2_DirectiveArena
+{
+public:
+    OPARI2_DirectiveArena( void ) : m_used( s_block_size )
+    {
+    }
+
+    ~
+    OPARI2_DirectiveArena( void )
+    {
+        Release();
+    }
+
+    /** @brief Construct a directive of type T in the arena */
+    template<class T>
+    T*
+    Create( const string&   file,
+            const int       lineno,
+            vector<string>& lines,
+            vector<string>& directive_prefix )
+    {
+        T* d = new( allocate( sizeof( T ) ) )T( file, lineno, lines, directive_prefix );
+
+        d->arena_slot = m_slots.size();
+        m_slots.push_back( slot_t( d, false ) );
+        return d;
+    }
+
+    /** @brief Returns whether d lives in the arena */
+    bool
+    Owns( OPARI2_Directive* d )
+    {
+        return d->arena_slot >= 0 && m_slots[ d->arena_slot ].first == d;
+    }
+
+    /** @brief Returns whether d lives in the arena and was not saved
+               for the include file */
+    bool
+    Temporary( OPARI2_Directive* d )
+    {
+        return Owns( d ) && !m_slots[ d->arena_slot ].second;
+    }
+
+    /** @brief Mark d as saved for the include file */
+    void
+    Save( OPARI2_Directive* d )
+    {
+        if ( Owns( d ) )
+        {
+            m_slots[ d->arena_slot ].second = true;
+        }
+    }
+
+    /** @brief Destroy d, its memory is reclaimed by Release() */
+    void
+    Destroy( OPARI2_Directive* d )
+    {
+        if ( Owns( d ) )
+        {
+            m_slots[ d->arena_slot ].first = NULL;
+            d->~OPARI2_Directive();
+        }
+    }
+
+    /** @brief Destroy all directives and free the blocks */
+    void
+    Release( void )
+    {
+        for ( vector<slot_t>::iterator it = m_slots.begin(); it != m_slots.end(); ++it )
+        {
+            if ( it->first )
+            {
+                it->first->~OPARI2_Directive();
+            }
+        }
+        m_slots.clear();
+        for ( vector<char*>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it )
+        {
+            delete[] *it;
+        }
+        m_blocks.clear();
+        m_used = s_block_size;
+    }
+
+private:
+    /** directive and whether it was saved for the include file */
+    typedef pair<OPARI2_Directive*, bool> slot_t;
+
+    void*
+    allocate( size_t size )
+    {
+        /* keep every object aligned for any member type */
+        size = ( size + s_alignment - 1 ) & ~( s_alignment - 1 );
+        if ( m_used + size > s_block_size )
+        {
+            /* objects larger than a block get a block of their own */
+            m_blocks.push_back( new char[ size > s_block_size ? size : s_block_size ] );
+            m_used = 0;
+        }
+        void* ptr = m_blocks.back() + m_used;
+        m_used += size;
+        return ptr;
+    }
+
+    static const size_t s_block_size = 64 * 1024;
+    static const size_t s_alignment  = 16;
+
+    vector<slot_t> m_slots;
+    vector<char*>  m_blocks;
+    /** bytes used in the last block */
+    size_t         m_used;
+};
+
+static OPARI2_DirectiveArena     directive_arena;
+static vector<OPARI2_Directive*> directive_vec;
+static vector<OPARI2_Directive*> directive_stack;
 /**
  * Keep track of the paradigm used in the source file.
  * Can be 'OR'ed with multiple paradigm types
  */
-uint32_t instrumented_paradigm_type = 0;
-bool     pomp2_header_included      = false;
+static uint32_t instrumented_paradigm_type = 0;
+static bool     pomp2_header_included      = false;
 
 
 bool
@@ -233,6 +360,23 @@ DisableParadigmDirectiveOrGroup(  const string& paradigm,
     return true;
 }
 
+void
+EnableAllDirectives( void )
+{
+    int size = sizeof( directive_table ) / sizeof( OPARI2_DirectiveDefinition );
+    for ( int i = 0; i < size; i++ )
+    {
+        directive_table[ i ].active       = true;
+        directive_table[ i ].inner_active = true;
+    }
+
+    size = sizeof( api_table ) / sizeof( OPARI2_RuntimeAPIDefinition );
+    for ( int i = 0; i < size; i++ )
+    {
+        api_table[ i ].active = true;
+    }
+}
+
 typedef pair<OPARI2_Disable_level_t, OPARI2_Disable_level_t> OPARI2_Disable_level_cur_max_t;
 static stack<OPARI2_Disable_level_cur_max_t>
 disable_levels( std::deque<OPARI2_Disable_level_cur_max_t>( 1, OPARI2_Disable_level_cur_max_t( D_NONE, D_NONE ) ) );
@@ -320,7 +464,7 @@ IsValidDirective( const string& paradigm,
  * @return	true	if the given directive is found in the "directive_table" and enabled.
                         false	otherwise.
  */
-bool
+static bool
 directive_enabled( OPARI2_ParadigmType_t type,
                    string&               directive )
 {
@@ -347,7 +491,7 @@ directive_enabled( OPARI2_ParadigmType_t type,
 }
 
 
-OPARI2_DirectiveDefinition*
+static OPARI2_DirectiveDefinition*
 get_directive_table_entry( OPARI2_ParadigmType_t type,
                            const std::string&    directive )
 {
@@ -372,7 +516,7 @@ get_directive_table_entry( OPARI2_ParadigmType_t type,
  * The entry is matching if both the type and name are the same as the
  * object.
  */
-OPARI2_DirectiveDefinition*
+static OPARI2_DirectiveDefinition*
 get_directive_table_entry( OPARI2_Directive* d )
 {
     return get_directive_table_entry( d->GetParadigmType(), d->GetName() );
@@ -402,6 +546,7 @@ NewDirective( vector<string>&   lines,
     OPARI2_ParadigmType_t type          = OPARI2_PT_NONE;
     OPARI2_Directive*     new_directive = NULL;
     string                sentinel;
+    double                start = OPARI2_StatsStart();
 
     if ( directive_prefix.size() )
     {
@@ -424,24 +569,26 @@ NewDirective( vector<string>&   lines,
     switch ( type )
     {
         case OPARI2_PT_OMP:
-            new_directive = new OPARI2_DirectiveOpenmp( file, lineno,
-                                                        lines, directive_prefix );
+            new_directive = directive_arena.Create<OPARI2_DirectiveOpenmp>( file, lineno,
+                                                                            lines, directive_prefix );
 
-            /*  Needed for Fortran end do loop detection */
+            /*  Needed for Fortran end do loop detection, combined
+             *  constructs may be loop constructs as well */
             d_def = get_directive_table_entry( new_directive );
             if ( d_def )
             {
-                new_directive->NeedsEndLoopDirective( d_def->loop_block );
+                new_directive->NeedsEndLoopDirective( d_def->loop_block ||
+                                                      new_directive->NeedsEndLoopDirective() );
             }
 
             break;
         case OPARI2_PT_POMP:
-            new_directive = new OPARI2_DirectivePomp( file, lineno,
-                                                      lines, directive_prefix );
+            new_directive = directive_arena.Create<OPARI2_DirectivePomp>( file, lineno,
+                                                                          lines, directive_prefix );
             break;
         case OPARI2_PT_OFFLOAD:
-            new_directive = new OPARI2_DirectiveOffload( file, lineno,
-                                                         lines, directive_prefix );
+            new_directive = directive_arena.Create<OPARI2_DirectiveOffload>( file, lineno,
+                                                                             lines, directive_prefix );
             break;
         /*no directives supported so far for openacc and tmse*/
         case OPARI2_PT_NONE:
@@ -451,14 +598,19 @@ NewDirective( vector<string>&   lines,
     }
     if ( new_directive )
     {
+        if ( new_directive->GetName() != "$END$" )
+        {
+            ++opari2_stats.directives[ type ];
+        }
         if ( directive_enabled( type, new_directive->GetName() ) ||
              new_directive->GetName() == "$END$" )
         {
-            tmp_directives.push_back( new_directive );
+            OPARI2_StatsStop( OPARI2_PHASE_BUILD, start );
             return new_directive;
         }
-        delete new_directive;
+        directive_arena.Destroy( new_directive );
     }
+    OPARI2_StatsStop( OPARI2_PHASE_BUILD, start );
     return NULL;
 }
 
@@ -471,6 +623,7 @@ ProcessDirective( OPARI2_Directive* d,
 {
     OPARI2_DirectiveDefinition* d_def = NULL;
     string                      name  = d->GetName();
+    double                      start = OPARI2_StatsStart();
     //std::cout << "Processing " << name << std::endl;
     if ( name == "$END$" ||                              // end of a directive (block) in C/C++
          ( name.find( "end" ) != string::npos &&         // end of a directive (block) in Fortran
@@ -501,7 +654,8 @@ ProcessDirective( OPARI2_Directive* d,
         }
         else    //disabled
         {
-            if ( d_top->GetName() == "parallelfor" || d_top->GetName() == "paralleldo" || d_top->GetName() == "parallelsections" )
+            if ( d_top->GetName() == "parallelfor" || d_top->GetName() == "paralleldo" || d_top->GetName() == "parallelsections" ||
+                 d_top->GetName() == "parallelforsimd" || d_top->GetName() == "paralleldosimd" )
             {
                 d_def->do_exit_transformation( d, os );
             }
@@ -539,7 +693,7 @@ ProcessDirective( OPARI2_Directive* d,
             }
             if ( is_for )
             {
-                *is_for =  ( name == "for" || name == "parallelfor" );
+                *is_for = d->NeedsEndLoopDirective();
             }
         }
         else         // the directive is disabled
@@ -580,9 +734,10 @@ ProcessDirective( OPARI2_Directive* d,
 
                 /** Directives that might be implicitly ended by the
                  * end of a do loop*/
-                d->NeedsEndLoopDirective( d_def->loop_block );
+                d->NeedsEndLoopDirective( d_def->loop_block || d->NeedsEndLoopDirective() );
             }
-            if ( name == "parallelfor" || name == "paralleldo" || name == "parallelsections" )
+            if ( name == "parallelfor" || name == "paralleldo" || name == "parallelsections" ||
+                 name == "parallelforsimd" || name == "paralleldosimd" )
             {
                 instrumented_paradigm_type |= d_def->type;
                 d_def->do_enter_transformation( d, os );
@@ -595,13 +750,14 @@ ProcessDirective( OPARI2_Directive* d,
         }
     }
 
+    OPARI2_StatsStop( OPARI2_PHASE_HANDLE, start );
     return;
 }
 
 
 /** @brief Check whether the current line is an omp function
     declaration */
-bool
+static bool
 is_runtime_decl( const string& file,
                  const string& header_file )
 {
@@ -614,6 +770,13 @@ is_runtime_decl( const string& file,
 }
 
 
+/** @brief Check whether the character can be part of an identifier */
+static inline bool
+is_ident_char( char c )
+{
+    return isalnum( ( unsigned char )c ) || c == '_' || c == '$';
+}
+
 /** Replaces a runtime call with the wrapper function. This function
     is currently used only by the Fortran parser */
 void
@@ -636,37 +799,54 @@ ReplaceRuntimeAPI( string&           lowline,
         return;
     }
 
+    /* Replacing "omp" by "POMP2" shifts the remainder of the line,
+       so search in a copy that is kept in sync with line. */
+    string low( lowline );
+
     for ( i = 0; i < sizeof( api_table ) / sizeof( OPARI2_RuntimeAPIDefinition ); i++ )
     {
         pos = 0;
 
         if ( api_table[ i ].active &&
+             !( lang & L_FORTRAN  && api_table[ i ].header_file_f.empty() ) &&
              !( lang & L_FORTRAN  && is_runtime_decl( file, api_table[ i ].header_file_f ) ) &&
              !( lang & L_C_OR_CXX && is_runtime_decl( file, api_table[ i ].header_file_c ) ) )
         {
-            while ( ( pos = lowline.find( api_table[ i ].name, pos ) ) != string::npos )
+            while ( ( pos = low.find( api_table[ i ].name, pos ) ) != string::npos )
             {
+                size_t end = pos + api_table[ i ].name.length();
+
+                /* only replace whole names, e.g., omp_init_lock must
+                   not match in omp_init_lock_with_hint */
+                if ( ( pos > 0 && is_ident_char( low[ pos - 1 ] ) ) ||
+                     ( end < low.length() && is_ident_char( low[ end ] ) ) )
+                {
+                    pos = end;
+                    continue;
+                }
                 /**
                  * when "omp_test_lock" and "omp_test_nest_lock" functions are defined,
                  * they may not be replaced.
                  */
                 if ( ( !api_table[ i ].name.find( "test" ) ) ||
-                     !( lowline.find( "logical" ) < pos ) )
+                     !( low.find( "logical" ) < pos ) )
                 {
                     instrumented_paradigm_type |= api_table[ i ].type;
                     line.replace( pos, 3, "POMP2" );
                     //Keep other letters unchanged, except for line[ pos + 6 ]
                     line[ pos + 6 ] = std::toupper( line[ pos + 6 ] );
+                    low.replace( pos, 3, "pomp2" );
+                    end += 2;
                 }
-                pos += api_table[ i ].name.length();
+                pos = end;
             }
         }
     }
 }
 
 
-set<string> header_files_f;
-set<string> header_files_c;
+static set<string> header_files_f;
+static set<string> header_files_c;
 
 bool
 IsSupportedAPIHeaderFile( const string&     include_file,
@@ -676,8 +856,14 @@ IsSupportedAPIHeaderFile( const string&     include_file,
     {
         for ( unsigned long i = 0; i < sizeof( api_table ) / sizeof( OPARI2_RuntimeAPIDefinition ); i++ )
         {
-            header_files_f.insert( api_table[ i ].header_file_f );
-            header_files_c.insert( api_table[ i ].header_file_c );
+            if ( !api_table[ i ].header_file_f.empty() )
+            {
+                header_files_f.insert( api_table[ i ].header_file_f );
+            }
+            if ( !api_table[ i ].header_file_c.empty() )
+            {
+                header_files_c.insert( api_table[ i ].header_file_c );
+            }
         }
     }
 
@@ -725,23 +911,7 @@ IsSupportedAPIHeaderFile( const string&     include_file,
 void
 SaveForInit( OPARI2_Directive* d )
 {
-    if ( !tmp_directives.empty() )
-    {
-        vector<OPARI2_Directive*>::iterator it = tmp_directives.begin();
-        while ( it != tmp_directives.end() )
-        {
-            if ( *it == d )
-            {
-                it = tmp_directives.erase( it );
-                break;
-            }
-            else
-            {
-                ++it;
-            }
-        }
-    }
-
+    directive_arena.Save( d );
     directive_vec.push_back( d );
 }
 
@@ -780,28 +950,14 @@ void
 DirectiveStackPop(  OPARI2_Directive* d )
 {
     OPARI2_Directive* d_top = DirectiveStackTop( d );
-    if ( !tmp_directives.empty() )
-    {
-        vector<OPARI2_Directive*>::iterator it = tmp_directives.begin();
-        while ( it != tmp_directives.end() )
-        {
-            if ( *it == d_top )
-            {
-                /*  This is the only reference left to this directive,
-                    so perform cleanup */
-                tmp_directives.erase( it );
-                directive_stack.pop_back();
-                delete d_top;
-                return;
-            }
-            else
-            {
-                ++it;
-            }
-        }
-    }
 
     directive_stack.pop_back();
+    if ( directive_arena.Temporary( d_top ) )
+    {
+        /*  This is the only reference left to this directive,
+            so perform cleanup */
+        directive_arena.Destroy( d_top );
+    }
 }
 
 
@@ -839,6 +995,23 @@ DirectiveStackInsertDescr( int id )
 }
 
 
+/**
+ * @brief Release all directives in bulk.
+ */
+static void
+release_directives( void )
+{
+    for ( vector<OPARI2_Directive*>::iterator it = directive_vec.begin(); it != directive_vec.end(); it++ )
+    {
+        if ( !directive_arena.Owns( *it ) )
+        {
+            delete *it;
+        }
+    }
+    directive_vec.clear();
+    directive_arena.Release();
+}
+
 void
 Finalize( OPARI2_Option_t& options )
 {
@@ -855,12 +1028,7 @@ Finalize( OPARI2_Option_t& options )
     }
 
     // generate opari include file
-    ofstream incs( options.incfile.c_str() );
-    if ( !incs )
-    {
-        cerr << "ERROR: cannot open opari include file " << options.incfile << "\n";
-        exit( 1 );
-    }
+    ostream& incs = options.incs;
 
     if (  options.lang & L_C_OR_CXX )
     {
@@ -895,6 +1063,7 @@ Finalize( OPARI2_Option_t& options )
                  ( *it )->GetName() != "declspec" )
             {
                 ( *it )->GenerateDescr( incs );
+                ++opari2_stats.regions;
             }
         }
     }
@@ -905,6 +1074,10 @@ Finalize( OPARI2_Option_t& options )
 
         OPARI2_DirectiveOpenmp::GenerateInitHandleCalls( options.os, options.incfile_nopath );
         OPARI2_DirectiveOpenmp::FinalizeDescrs( incs );
+        if ( instrumented_paradigm_type & OPARI2_PT_POMP )
+        {
+            OPARI2_DirectivePomp::FinalizeDescrs( incs );
+        }
 
         OPARI2_DirectivePomp::GenerateInitHandleCalls( options.os, options.incfile_nopath );
     }
@@ -913,15 +1086,27 @@ Finalize( OPARI2_Option_t& options )
         OPARI2_DirectiveOpenmp::GenerateInitHandleCalls( incs );
         OPARI2_DirectivePomp::GenerateInitHandleCalls( incs );
     }
-    /*cleanup tmp_directives and directive_vec vectors*/
-    for ( vector<OPARI2_Directive*>::iterator it = tmp_directives.begin(); it != tmp_directives.end(); it++ )
-    {
-        delete *it;
-    }
-    for ( vector<OPARI2_Directive*>::iterator it = directive_vec.begin(); it != directive_vec.end(); it++ )
+    release_directives();
+}
+
+void
+ResetDirectives( void )
+{
+    release_directives();
+    directive_stack.clear();
+    saved_single_line_directive = NULL;
+    instrumented_paradigm_type  = 0;
+    pomp2_header_included       = false;
+    while ( disable_levels.size() > 1 )
     {
-        delete *it;
+        disable_levels.pop();
     }
+
+    OPARI2_Directive::ResetRegions();
+    OPARI2_DirectiveOpenmp::ResetRegions();
+    OPARI2_DirectivePomp::ResetRegions();
+    OPARI2_DirectiveOffload::ResetRegions();
+    reset_omp_handler();
 }
 
 void
@@ -936,6 +1121,7 @@ HandleSingleLineDirective( const int lineno,
 {
     if ( saved_single_line_directive )
     {
+        double                      start = OPARI2_StatsStart();
         OPARI2_DirectiveDefinition* d_def = get_directive_table_entry( saved_single_line_directive );
         if ( d_def->active )
         {
@@ -949,5 +1135,8 @@ HandleSingleLineDirective( const int lineno,
             DirectiveStackPop();
             saved_single_line_directive = NULL;
         }
+        OPARI2_StatsStop( OPARI2_PHASE_HANDLE, start );
     }
 }
+
+} /* namespace opari2 */
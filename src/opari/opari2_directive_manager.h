@@ -33,6 +33,9 @@ using std::string;
 
 #include "opari2_directive.h"
 
+namespace opari2
+{
+
 /* Map entry. Matches string to enum */
 typedef struct
 {
@@ -43,6 +46,11 @@ typedef struct
 } OPARI2_MapString2ParadigmNameType;
 
 
+/** @brief Returns the name of a paradigm type for messages. */
+string
+paradigm_type_to_string( OPARI2_ParadigmType_t type );
+
+
 /** @brief Disables the instrumentation of whole paradigms or specific
  *         directives.
  *
@@ -61,6 +69,11 @@ DisableParadigmDirectiveOrGroup( const string& paradigm,
                                  const string& directiveOrGroup,
                                  bool          inner );
 
+/** @brief Enables all directives and runtime API functions again,
+ *         revoking DisableParadigmDirectiveOrGroup(). */
+void
+EnableAllDirectives( void );
+
 /**
  * @brief Different levels for full or partial disabling if
  *        instrumentation.
@@ -192,7 +205,8 @@ void
 DirectiveStackInsertDescr( int );
 
 /**
- * @brief Generate the final *.opari.inc file.
+ * @brief Generate the text of the final *.opari.inc file in
+ *        options.incs.
  *
  * Need revision if multiple kinds of paradigms are used in the source
  * fle. Current implementation considers OpenMP and POMP ONLY!
@@ -201,6 +215,14 @@ DirectiveStackInsertDescr( int );
 void
 Finalize( OPARI2_Option_t& options );
 
+/**
+ * @brief Discard all directives, regions and instrumentation state of
+ *        the previous file, so the next file can be processed in the
+ *        same process.
+ */
+void
+ResetDirectives( void );
+
 void
 SaveSingleLineDirective( OPARI2_Directive* d );
 
@@ -209,4 +231,6 @@ HandleSingleLineDirective( const int lineno,
                            ostream&  os );
 
 
+} /* namespace opari2 */
+
 #endif // OPARI2_DIRECTIVE_MANAGER_H
@@ -0,0 +1,343 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_lexer_c.cc
+ *
+ *  @brief      Table driven lexer for the lines of C/C++ source files.
+ */
+
+#include <config.h>
+#include <string>
+using std::string;
+#include <algorithm>
+using std::search;
+#include <cstring>
+
+#include "opari2_lexer_c.h"
+
+
+/** Character classes, the columns of the transition table */
+enum
+{
+    C_OTHER, C_BLANK, C_LETTER, C_EXP, C_DIGIT, C_DOT, C_SIGN, C_SLASH,
+    C_STAR, C_DQUOTE, C_SQUOTE, C_BSLASH, C_LBRACE, C_RBRACE, C_SEMI,
+    C_NUM_CLASSES
+};
+
+/** States of the lexer, the rows of the transition table. Raw string
+    literals are matched without the table, as their end depends on
+    the delimiter. */
+enum
+{
+    S_CODE, S_IDENT, S_NUMBER, S_NUMBER_EXP, S_NUMBER_SEP, S_SLASH,
+    S_LINE_COMMENT, S_BLOCK_COMMENT, S_BLOCK_STAR, S_STRING, S_STRING_ESC,
+    S_CHAR, S_CHAR_ESC, S_NUM_STATES, S_RAW_STRING = S_NUM_STATES
+};
+
+/** Actions of a transition */
+enum
+{
+    /** consume the character */
+    A_NONE,
+    /** consume the character, which starts an identifier */
+    A_BEGIN,
+    /** report the identifier that ends before the character */
+    A_IDENT,
+    /** identifier followed by a quote, which may be a literal prefix */
+    A_PREFIX,
+    /** process the character again in the new state */
+    A_AGAIN,
+    /** consume and report the character */
+    A_LBRACE, A_RBRACE, A_SEMI
+};
+
+typedef struct
+{
+    unsigned char next;
+    unsigned char action;
+} transition_t;
+
+#define T( state, action ) { S_ ## state, A_ ## action }
+
+/** Transition table, indexed by state and character class */
+static const transition_t transitions[ S_NUM_STATES ][ C_NUM_CLASSES ] =
+{
+    /*                 OTHER                   BLANK                   LETTER                  EXP                     DIGIT                   DOT                     SIGN                    SLASH                   STAR                    DQUOTE                  SQUOTE                  BSLASH                  LBRACE                  RBRACE                  SEMI */
+    /* CODE */       { T( CODE, NONE ),        T( CODE, NONE ),        T( IDENT, BEGIN ),      T( IDENT, BEGIN ),      T( NUMBER, NONE ),      T( CODE, NONE ),        T( CODE, NONE ),        T( SLASH, NONE ),       T( CODE, NONE ),        T( STRING, NONE ),      T( CHAR, NONE ),        T( CODE, NONE ),        T( CODE, LBRACE ),      T( CODE, RBRACE ),      T( CODE, SEMI ) },
+    /* IDENT */      { T( CODE, IDENT ),       T( CODE, IDENT ),       T( IDENT, NONE ),       T( IDENT, NONE ),       T( IDENT, NONE ),       T( CODE, IDENT ),       T( CODE, IDENT ),       T( CODE, IDENT ),       T( CODE, IDENT ),       T( CODE, PREFIX ),      T( CODE, PREFIX ),      T( CODE, IDENT ),       T( CODE, IDENT ),       T( CODE, IDENT ),       T( CODE, IDENT ) },
+    /* NUMBER */     { T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( NUMBER, NONE ),      T( NUMBER_EXP, NONE ),  T( NUMBER, NONE ),      T( NUMBER, NONE ),      T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( NUMBER_SEP, NONE ),  T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ) },
+    /* NUMBER_EXP */ { T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( NUMBER, NONE ),      T( NUMBER_EXP, NONE ),  T( NUMBER, NONE ),      T( NUMBER, NONE ),      T( NUMBER, NONE ),      T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( NUMBER_SEP, NONE ),  T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ) },
+    /* NUMBER_SEP */ { T( CHAR, NONE ),        T( CHAR, NONE ),        T( NUMBER, NONE ),      T( NUMBER_EXP, NONE ),  T( NUMBER, NONE ),      T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CODE, NONE ),        T( CHAR_ESC, NONE ),    T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ) },
+    /* SLASH */      { T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( LINE_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( CODE, AGAIN ),     T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ),       T( CODE, AGAIN ) },
+    /* LINE_COMMENT */ { T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ), T( LINE_COMMENT, NONE ) },
+    /* BLOCK_COMMENT */ { T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_STAR, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ) },
+    /* BLOCK_STAR */ { T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( CODE, NONE ), T( BLOCK_STAR, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ), T( BLOCK_COMMENT, NONE ) },
+    /* STRING */     { T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( CODE, NONE ),        T( STRING, NONE ),      T( STRING_ESC, NONE ),  T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ) },
+    /* STRING_ESC */ { T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ),      T( STRING, NONE ) },
+    /* CHAR */       { T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CODE, NONE ),        T( CHAR_ESC, NONE ),    T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ) },
+    /* CHAR_ESC */   { T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ),        T( CHAR, NONE ) }
+};
+
+#undef T
+
+
+/** @brief Maps the characters to their classes */
+class OPARI2_CCharClasses
+{
+public:
+    OPARI2_CCharClasses( void )
+    {
+        for ( int c = 0; c < 256; ++c )
+        {
+            /* bytes of UTF-8 sequences may appear in identifiers */
+            m_class[ c ] = c >= 0x80 ? C_LETTER : C_OTHER;
+        }
+        for ( int c = 'a'; c <= 'z'; ++c )
+        {
+            m_class[ c ]             = C_LETTER;
+            m_class[ c - 'a' + 'A' ] = C_LETTER;
+        }
+        for ( int c = '0'; c <= '9'; ++c )
+        {
+            m_class[ c ] = C_DIGIT;
+        }
+        m_class[ ( unsigned char )'_' ]  = C_LETTER;
+        m_class[ ( unsigned char )'$' ]  = C_LETTER;
+        m_class[ ( unsigned char )'e' ]  = C_EXP;
+        m_class[ ( unsigned char )'E' ]  = C_EXP;
+        m_class[ ( unsigned char )'p' ]  = C_EXP;
+        m_class[ ( unsigned char )'P' ]  = C_EXP;
+        m_class[ ( unsigned char )' ' ]  = C_BLANK;
+        m_class[ ( unsigned char )'\t' ] = C_BLANK;
+        m_class[ ( unsigned char )'.' ]  = C_DOT;
+        m_class[ ( unsigned char )'+' ]  = C_SIGN;
+        m_class[ ( unsigned char )'-' ]  = C_SIGN;
+        m_class[ ( unsigned char )'/' ]  = C_SLASH;
+        m_class[ ( unsigned char )'*' ]  = C_STAR;
+        m_class[ ( unsigned char )'"' ]  = C_DQUOTE;
+        m_class[ ( unsigned char )'\'' ] = C_SQUOTE;
+        m_class[ ( unsigned char )'\\' ] = C_BSLASH;
+        m_class[ ( unsigned char )'{' ]  = C_LBRACE;
+        m_class[ ( unsigned char )'}' ]  = C_RBRACE;
+        m_class[ ( unsigned char )';' ]  = C_SEMI;
+    }
+
+    unsigned char
+    operator[]( unsigned char c ) const
+    {
+        return m_class[ c ];
+    }
+
+private:
+    unsigned char m_class[ 256 ];
+};
+
+static const OPARI2_CCharClasses char_classes;
+
+
+OPARI2_CLexer::OPARI2_CLexer( void )
+{
+    m_text        = "";
+    m_length      = 0;
+    m_pos         = 0;
+    m_ident_begin = 0;
+    m_state       = S_CODE;
+}
+
+
+void
+OPARI2_CLexer::StartLine( const string&     line,
+                          string::size_type pos )
+{
+    m_text   = line.data();
+    m_length = line.length();
+    m_pos    = pos;
+}
+
+
+OPARI2_CToken_t
+OPARI2_CLexer::Next( string::size_type& begin,
+                     string::size_type& end )
+{
+    while ( m_pos < m_length )
+    {
+        if ( m_state == S_RAW_STRING )
+        {
+            const char* found = search( m_text + m_pos, m_text + m_length,
+                                        m_raw_end.begin(), m_raw_end.end() );
+            if ( found == m_text + m_length )
+            {
+                m_pos = m_length;
+            }
+            else
+            {
+                m_pos   = found - m_text + m_raw_end.length();
+                m_state = S_CODE;
+            }
+            continue;
+        }
+
+        const transition_t& t =
+            transitions[ m_state ][ char_classes[ ( unsigned char )m_text[ m_pos ] ] ];
+        switch ( t.action )
+        {
+            case A_NONE:
+                m_state = t.next;
+                m_pos++;
+                break;
+            case A_BEGIN:
+                m_state       = t.next;
+                m_ident_begin = m_pos++;
+                break;
+            case A_AGAIN:
+                m_state = t.next;
+                break;
+            case A_PREFIX:
+                /* otherwise the identifier is no prefix */
+                if ( handle_prefix() )
+                {
+                    break;
+                }
+            /* fall through */
+            case A_IDENT:
+                m_state = t.next;
+                begin   = m_ident_begin;
+                end     = m_pos;
+                return T_C_IDENT;
+            default:
+                m_state = t.next;
+                begin   = m_pos++;
+                end     = m_pos;
+                return t.action == A_LBRACE ? T_C_LBRACE :
+                       t.action == A_RBRACE ? T_C_RBRACE : T_C_SEMI;
+        }
+    }
+
+    if ( m_state == S_IDENT )
+    {
+        m_state = S_CODE;
+        begin   = m_ident_begin;
+        end     = m_length;
+        return T_C_IDENT;
+    }
+
+    /* Block comments and raw strings continue on the next line, line
+       comments and strings only if the line ends with a backslash. */
+    bool splice = m_length > 0 && m_text[ m_length - 1 ] == '\\';
+    switch ( m_state )
+    {
+        case S_BLOCK_COMMENT:
+        case S_BLOCK_STAR:
+            m_state = S_BLOCK_COMMENT;
+            break;
+        case S_RAW_STRING:
+            break;
+        case S_LINE_COMMENT:
+            m_state = splice ? S_LINE_COMMENT : S_CODE;
+            break;
+        case S_STRING:
+        case S_STRING_ESC:
+            m_state = splice ? S_STRING : S_CODE;
+            break;
+        default:
+            m_state = S_CODE;
+    }
+    begin = end = m_length;
+    return T_C_END;
+}
+
+
+bool
+OPARI2_CLexer::handle_prefix( void )
+{
+    string prefix( m_text + m_ident_begin, m_pos - m_ident_begin );
+    char   quote = m_text[ m_pos ];
+    bool   raw   = prefix == "R" || prefix == "LR" || prefix == "uR" ||
+                   prefix == "UR" || prefix == "u8R";
+
+    if ( raw && quote == '"' )
+    {
+        /* the delimiter has at most 16 characters and ends with '(' */
+        string::size_type open = m_pos + 1;
+        while ( open < m_length && open - m_pos <= 16 &&
+                !strchr( " ()\\\t\"", m_text[ open ] ) )
+        {
+            open++;
+        }
+        if ( open < m_length && m_text[ open ] == '(' )
+        {
+            m_raw_end = ")" + string( m_text + m_pos + 1, open - m_pos - 1 ) + "\"";
+            m_state   = S_RAW_STRING;
+            m_pos     = open + 1;
+            return true;
+        }
+        m_state = S_STRING;
+        m_pos++;
+        return true;
+    }
+    if ( prefix == "L" || prefix == "u" || prefix == "U" || prefix == "u8" )
+    {
+        m_state = quote == '"' ? S_STRING : S_CHAR;
+        m_pos++;
+        return true;
+    }
+    return false;
+}
+
+
+bool
+OPARI2_CLexer::InComment( void ) const
+{
+    return m_state == S_BLOCK_COMMENT || m_state == S_BLOCK_STAR ||
+           m_state == S_LINE_COMMENT;
+}
+
+
+bool
+OPARI2_CLexer::InString( void ) const
+{
+    return m_state == S_STRING || m_state == S_STRING_ESC ||
+           m_state == S_RAW_STRING;
+}
+
+
+void
+OPARI2_CLexer::SetInComment( bool in_comment )
+{
+    if ( in_comment )
+    {
+        m_state = S_BLOCK_COMMENT;
+    }
+    else if ( InComment() )
+    {
+        m_state = S_CODE;
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_lexer_c.h
+ *
+ *  @brief      Table driven lexer for the lines of C/C++ source files.
+ */
+
+#ifndef OPARI2_LEXER_C_H
+#define OPARI2_LEXER_C_H
+
+#include <string>
+using std::string;
+
+
+/** @brief Events reported by OPARI2_CLexer::Next() */
+typedef enum
+{
+    /** end of the line */
+    T_C_END = 0,
+    /** identifier or keyword */
+    T_C_IDENT,
+    /** opening brace */
+    T_C_LBRACE,
+    /** closing brace */
+    T_C_RBRACE,
+    /** semicolon */
+    T_C_SEMI
+} OPARI2_CToken_t;
+
+
+/**
+ * @brief Splits the lines of a C/C++ source file into the events the
+ *        parser needs to find the end of directive blocks and the
+ *        calls of runtime functions.
+ *
+ * The lexer is a deterministic finite automaton driven by a table over
+ * character classes. It knows comments, string and character literals
+ * with encoding prefixes, raw string literals, numbers with digit
+ * separators and exponents, and line splices in strings and line
+ * comments. Block comments, continued strings and line comments and
+ * raw strings carry over to the next line. Braces and semicolons in
+ * comments and literals are not reported.
+ */
+class OPARI2_CLexer
+{
+public:
+    OPARI2_CLexer( void );
+
+    /**
+     * @brief Start lexing a line at offset pos. The line must not be
+     *        changed before Next() returned T_C_END.
+     */
+    void
+    StartLine( const string&     line,
+               string::size_type pos = 0 );
+
+    /**
+     * @brief Return the next event of the line and its span
+     *        [begin, end).
+     *
+     * At the end of the line T_C_END is returned and the state for
+     * the next line is set.
+     */
+    OPARI2_CToken_t
+    Next( string::size_type& begin,
+          string::size_type& end );
+
+    /** @brief Check whether the next line starts inside a comment */
+    bool
+    InComment( void ) const;
+
+    /** @brief Check whether the next line starts inside a string */
+    bool
+    InString( void ) const;
+
+    /** @brief Set whether the next line starts inside a block comment */
+    void
+    SetInComment( bool in_comment );
+
+private:
+    const char*       m_text;
+    string::size_type m_length;
+    string::size_type m_pos;
+    string::size_type m_ident_begin;
+    unsigned char     m_state;
+    /** End of the current raw string literal, e.g. )xyz" */
+    string            m_raw_end;
+
+    /** @brief Handle an identifier followed by a quote, which may be
+        the prefix of a string or character literal */
+    bool
+    handle_prefix( void );
+};
+
+#endif // OPARI2_LEXER_C_H
@@ -0,0 +1,783 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_lib.cc
+ *
+ *  @brief      This file contains the libopari2 API. It handles the
+ *              options and runs the C or Fortran parser and Finalize()
+ *              on a source held in memory. The opari2 command is a
+ *              thin layer around it. */
+
+#include <config.h>
+#include <sstream>
+using std::stringstream;
+#include <iostream>
+using std::cerr;
+#include <cstring>
+#include <cstdlib>
+using std::string;
+using std::strcmp;
+using std::strncmp;
+using std::strchr;
+using std::strtok;
+#include <string>
+#include <vector>
+using std::vector;
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <opari2/opari2_lib.h>
+
+#include "opari2.h"
+#include "opari2_directive_manager.h"
+#include "openmp/opari2_directive_openmp.h"
+#include "opari2_parser_c.h"
+#include "opari2_parser_f.h"
+
+
+#define DEPRECATED_ON
+
+using namespace opari2;
+
+namespace opari2
+{
+/* options and streams of the file being instrumented */
+OPARI2_Option_t opt;
+
+/* statistics printed with --stats */
+OPARI2_Stats_t opari2_stats;
+
+
+void
+cleanup_and_exit( void )
+{
+    throw OPARI2_Abort();
+}
+} /* namespace opari2 */
+
+/* options set by OPARI2_SetOption() */
+static OPARI2_Language_t option_lang          = L_NA;
+static OPARI2_Format_t   option_form          = F_NA;
+static bool              option_keep_src_info = true;
+static bool              option_preprocessed  = false;
+static bool              option_deterministic = false;
+static bool              option_skip_system   = false;
+static int               option_jobs          = 1;
+static bool              option_bind_c        = false;
+static map<string, string> option_defines;
+static set<string>         option_undefines;
+
+double
+OPARI2_StatsStart( void )
+{
+    if ( !opari2_stats.enabled )
+    {
+        return 0.0;
+    }
+
+    timeval now;
+    gettimeofday( &now, NULL );
+    return now.tv_sec + now.tv_usec * 1e-6;
+}
+
+void
+OPARI2_StatsStop( OPARI2_Phase_t phase,
+                  double         start )
+{
+    if ( opari2_stats.enabled )
+    {
+        opari2_stats.time[ phase ] += OPARI2_StatsStart() - start;
+    }
+}
+
+bool
+OPARI2_ReadLine( istream& is,
+                 string&  line )
+{
+    double start   = OPARI2_StatsStart();
+    bool   success = ( bool )getline( is, line );
+    OPARI2_StatsStop( OPARI2_PHASE_READ, start );
+
+    if ( success )
+    {
+        ++opari2_stats.lines;
+    }
+    return success;
+}
+
+static void
+print_deprecated_msg( const string old_form, const string new_form )
+{
+#ifdef DEPRECATED_ON
+    cerr << "Warning: Option \"" << old_form << "\" is deprecated.\n\
+Please use \"" << new_form << "\" for future compatibility.\n";
+#endif
+}
+
+/**
+ * @brief Disable directive entry in the directive_table.
+ *
+ * Currently supported option:
+ * --disable=xx,xx,...
+ *  Here xx can possibly be an openmp/pomp directive name, openmp/pomp
+ *  group name, or a paradigm type name.
+ *
+ * Not supported anymore:
+ *  -disable xx,xx,...
+ *
+ * Current --help output (27.03.2014):
+ * [--disable=paradigm[:directive|group[:inner],...][+paradigm...]
+ *   [OPTIONAL] Disable the instrumentation of whole paradigms, or
+ *   specific directives or groups of directives of a paradigm.
+ *   Furthermore it gives the possibility to suppress the insertion of
+ *   instrumentation functions inside code regions, i.e. only the
+ *   surrounding instrumentation is inserted.  *
+ */
+static bool
+set_disabled( const string& constructs )
+{
+    typedef std::pair<char*, bool> dir_and_inner_t;
+
+    char str[ constructs.length() + 1 ];
+    std::strcpy( &str[ 0 ], constructs.c_str() );
+
+    std::vector<char*> paradigms;
+    char*              paradigm = strtok( &str[ 0 ], "+" );
+
+    while ( paradigm != NULL )
+    {
+        paradigms.push_back( paradigm );
+        paradigm = strtok( NULL, "+" );
+    }
+
+    for ( vector<char*>::iterator it = paradigms.begin(); it != paradigms.end(); ++it )
+    {
+        paradigm = strtok( *it, ",:" );
+
+        dir_and_inner_t               directive;
+        std::vector<dir_and_inner_t > directives;
+
+        directive.first  = strtok( NULL, "," );
+        directive.second = false;
+        while ( directive.first != NULL )
+        {
+            directives.push_back( directive );
+            directive.second = false;
+            directive.first  = strtok( NULL, "," );
+        }
+
+        for ( vector<dir_and_inner_t>::iterator it = directives.begin(); it != directives.end(); ++it )
+        {
+            if ( strchr( it->first, ':' ) )
+            {
+                it->first = strtok( it->first, ":" );
+                char* inner = strtok( NULL, ":" );
+                if ( strcmp( inner, "inner" ) == 0 )
+                {
+                    it->second = true;
+                }
+                else
+                {
+                    cerr << "Error, unknown identifier " <<  inner << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        if ( directives.empty() )
+        {
+            if ( !DisableParadigmDirectiveOrGroup( paradigm, "", false ) )
+            {
+                return false;
+            }
+        }
+        else
+        {
+            for ( vector<dir_and_inner_t>::iterator it = directives.begin(); it != directives.end(); ++it )
+            {
+                if ( !DisableParadigmDirectiveOrGroup( paradigm, it->first, it->second ) )
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parse and handle one option.
+ *
+ * First handle global options,
+ * then handle paradigm-specific options.
+ */
+int
+OPARI2_SetOption( const std::string& option )
+{
+    OPARI2_ErrorCode err_flag = OPARI2_NO_ERROR;
+    const char*      ptr      = NULL;
+
+    /* strtok() needs a modifiable copy */
+    vector<char> buffer( option.begin(), option.end() );
+    buffer.push_back( '\0' );
+    char* arg = &buffer[ 0 ];
+
+    opari2_omp_option* omp_opt = OPARI2_DirectiveOpenmp::GetOpenmpOpt();
+
+    if ( strncmp( arg, "--omp", 5 ) == 0 )
+    {
+        err_flag =  OPARI2_DirectiveOpenmp::ProcessOption( arg );
+        if ( err_flag )
+        {
+            cerr << "ERROR: unknown option " << arg << "\n";
+            err_flag = OPARI2_ERROR_WITH_MESSAGE;
+        }
+    }
+    else if ( strcmp( arg, "--f77" ) == 0 )
+    {
+        option_lang = L_F77;
+    }
+    else if ( strcmp( arg, "--f90" ) == 0 )
+    {
+        option_lang = L_F90;
+    }
+    else if ( strcmp( arg, "--c++" ) == 0 )
+    {
+        option_lang = L_CXX;
+    }
+    else if ( strcmp( arg, "--c" ) == 0 )
+    {
+        option_lang = L_C;
+    }
+    else if ( strcmp( arg, "--free-form" ) == 0 )
+    {
+        option_form = F_FREE;
+    }
+    else if ( strcmp( arg, "--fix-form" ) == 0 )
+    {
+        option_form = F_FIX;
+    }
+    else if ( strcmp( arg, "--nosrc" ) == 0 )
+    {
+        option_keep_src_info = false;
+    }
+    else if ( strcmp( arg, "--preprocessed" ) == 0 )
+    {
+        option_preprocessed = true;
+    }
+    /* macros for the resolution of conditional compilation */
+    else if ( strncmp( arg, "-D", 2 ) == 0 && arg[ 2 ] )
+    {
+        string      define( arg + 2 );
+        size_t      equal = define.find( '=' );
+        string      name  = define.substr( 0, equal );
+        option_defines[ name ] = equal == string::npos ? "1" : define.substr( equal + 1 );
+        option_undefines.erase( name );
+    }
+    else if ( strncmp( arg, "-U", 2 ) == 0 && arg[ 2 ] )
+    {
+        option_undefines.insert( arg + 2 );
+        option_defines.erase( arg + 2 );
+    }
+    else if ( strcmp( arg, "--skip-system-headers" ) == 0 )
+    {
+        option_skip_system = true;
+    }
+    else if ( strncmp( arg, "--jobs=", 7 ) == 0 )
+    {
+        char* end;
+        long  jobs = strtol( arg + 7, &end, 10 );
+        if ( end == arg + 7 || *end || jobs < 1 || jobs > 1024 )
+        {
+            cerr << "ERROR: invalid value for option --jobs\n";
+            err_flag = OPARI2_ERROR_WITH_MESSAGE;
+        }
+        else
+        {
+            option_jobs = jobs;
+        }
+    }
+    else if ( strcmp( arg, "--fortran-bind-c" ) == 0 )
+    {
+        option_bind_c = true;
+    }
+    else if ( strcmp( arg, "--deterministic-ids" ) == 0 )
+    {
+        option_deterministic = true;
+    }
+    /* handle "--disable=" */
+    else if ( strncmp( arg, "--disable", 9 ) == 0 )
+    {
+        ptr = strchr( arg, '=' );
+        if ( ptr )
+        {
+            ptr++;
+            if ( !set_disabled( ptr ) )
+            {
+                err_flag = OPARI2_ERROR_WITH_MESSAGE;
+            }
+        }
+        else
+        {
+            err_flag = OPARI2_ERROR_WITH_MESSAGE;
+            cerr << "ERROR: missing value for option --disable\n";
+        }
+    }
+    /*  handle deprecated options */
+    else if ( strcmp( arg, "--tpd" ) == 0 )
+    {
+        print_deprecated_msg( "--tpd", "--omp-tpd" );
+        omp_opt->copytpd = true;
+        #if HAVE( PLATFORM_K ) || HAVE( PLATFORM_FX10 ) || HAVE( PLATFORM_FX100 )
+        cerr << "WARNING: option --tpd not supported on Fujitsu systems.\n";
+        #endif
+    }
+    else if ( strncmp( arg, "--tpd-mangling=", 15 ) == 0 )
+    {
+        print_deprecated_msg( "--tpd-mangling=<comp>", "--omp-tpd-mangling=<comp>" );
+        char* tpd_arg = strchr( arg, '=' );
+        if ( tpd_arg != NULL )
+        {
+            tpd_arg++;
+            if ( strcmp( tpd_arg, "gnu" )   == 0 || strcmp( tpd_arg, "sun" ) == 0 ||
+                 strcmp( tpd_arg, "intel" ) == 0 || strcmp( tpd_arg, "pgi" ) == 0 ||
+                 strcmp( tpd_arg, "cray" )  == 0 )
+            {
+                omp_opt->pomp_tpd            = "pomp_tpd_";
+                omp_opt->tpd_in_extern_block = false;
+            }
+            else if ( strcmp( tpd_arg, "ibm" ) == 0 )
+            {
+                omp_opt->pomp_tpd            = "pomp_tpd";
+                omp_opt->tpd_in_extern_block = true;
+            }
+            else
+            {
+                cerr << "ERROR: unknown option for --tpd-mangling\n";
+                err_flag = OPARI2_ERROR_WITH_MESSAGE;
+            }
+        }
+        else
+        {
+            cerr << "ERROR: missing value for option --tpd-mangling\n";
+            err_flag = OPARI2_ERROR_WITH_MESSAGE;
+        }
+    }
+    else if ( strncmp( arg, "--task=", 7 ) == 0 )
+    {
+        print_deprecated_msg( "--task=<comp>", "--omp-task=<comp>" );
+        char* token = strtok( arg, "=" );
+        token = strtok( NULL, "," );
+        while ( token != NULL )
+        {
+            if ( strcmp( token, "abort" ) == 0 )
+            {
+                omp_opt->task_abort = true;
+            }
+            else if ( strcmp( token, "warn" ) == 0 )
+            {
+                omp_opt->task_warn = true;
+            }
+            else if ( strcmp( token, "remove" ) == 0 )
+            {
+                omp_opt->task_remove = true;
+            }
+            else
+            {
+                cerr << "ERROR: unknown option \"" << token << "\" for --task\n";
+                err_flag = OPARI2_ERROR_WITH_MESSAGE;
+            }
+            token = strtok( NULL, "," );
+        }
+    }
+    else if ( strncmp( arg, "--untied=", 9 ) == 0 )
+    {
+        print_deprecated_msg( "--untied=<comp>", "--omp-task-untied=<comp>" );
+        char* token = strtok( arg, "=" );
+        token = strtok( NULL, "," );
+        do
+        {
+            if ( strcmp( token, "abort" ) == 0 )
+            {
+                omp_opt->untied_abort = true;
+            }
+            else if ( strcmp( token, "no-warn" ) == 0 )
+            {
+                omp_opt->untied_nowarn = true;
+            }
+            else if ( strcmp( token, "keep" ) == 0 )
+            {
+                omp_opt->untied_keep = true;
+            }
+            else
+            {
+                cerr << "ERROR: unknown option \"" << token << "\" for --untied\n";
+                err_flag = OPARI2_ERROR_WITH_MESSAGE;
+            }
+            token = strtok( NULL, "," );
+        }
+        while ( token != NULL );
+    }
+    else if ( strcmp( arg, "-disable" ) == 0 )
+    {
+        cerr << "ERROR: -disable not supported by this version of OPARI2. "
+             << "Please use --disable=paradigm[:directive|group[:inner],...][+paradigm...]. "
+             << "Use opari2 --help or refer to the documentation for more details." << std::endl;
+        err_flag = OPARI2_ERROR_WITH_MESSAGE;
+    }
+    else if ( strcmp( arg, "-f77" ) == 0 )
+    {
+        print_deprecated_msg( "-f77", "--f77" );
+        option_lang = L_F77;
+    }
+    else if ( strcmp( arg, "-f90" ) == 0 )
+    {
+        print_deprecated_msg( "-f90", "--f90" );
+        option_lang = L_F90;
+    }
+    else if ( strcmp( arg, "-c++" ) == 0 )
+    {
+        print_deprecated_msg( "-c++", "--c++" );
+        option_lang = L_CXX;
+    }
+    else if ( strcmp( arg, "-c" ) == 0 )
+    {
+        print_deprecated_msg( "-c", "--c" );
+        option_lang = L_C;
+    }
+    else if ( strcmp( arg, "-nosrc" ) == 0 )
+    {
+        print_deprecated_msg( "-nosrc", "--nosrc" );
+        option_keep_src_info = false;
+    }
+    else if ( strcmp( arg, "-rcfile" ) == 0 )
+    {
+        cerr << "WARNING: Option \"-rcfile\" is deprecated and ignored.\n";
+    }
+    else if ( strcmp( arg, "-table" ) == 0 )
+    {
+        cerr << "WARNING: Option \"-table\" is deprecated and ignored.\n";
+    }
+    /* End of deprecated options */
+    else
+    {
+        return 2;
+    }
+
+    return err_flag ? 1 : 0;
+}
+
+void
+OPARI2_ResetOptions( void )
+{
+    option_lang          = L_NA;
+    option_form          = F_NA;
+    option_keep_src_info = true;
+    option_preprocessed  = false;
+    option_deterministic = false;
+    option_skip_system   = false;
+    option_jobs          = 1;
+    option_bind_c        = false;
+    option_defines.clear();
+    option_undefines.clear();
+
+    OPARI2_DirectiveOpenmp::ResetOptions();
+    EnableAllDirectives();
+}
+
+bool
+OPARI2_InitOptions( const string& infile )
+{
+    opt.infile              = infile;
+    opt.keep_src_info       = option_keep_src_info;
+    opt.preprocessed_file   = option_preprocessed;
+    opt.skip_system_headers = option_skip_system;
+    opt.jobs                = option_jobs;
+    opt.fortran_bind_c      = option_bind_c;
+    opt.defines             = option_defines;
+    opt.undefines           = option_undefines;
+    opt.lang                = option_lang;
+    opt.form                = option_form;
+
+    /* determine language and format by filename if not specified */
+    if ( opt.lang == L_NA )
+    {
+        size_t pos = opt.infile.find_last_of( '.' );
+
+        if ( pos < opt.infile.length() + 1  && opt.infile[ pos + 1 ] )
+        {
+            switch ( opt.infile[ pos + 1 ] )
+            {
+                case 'f':
+                case 'F':
+                    opt.lang = opt.infile[ pos + 2 ] == '9' ? L_F90 : L_F77;
+                    break;
+                case 'c':
+                    /*Files *.CUF and *.cuf are CUDA Fortran files*/
+                    if ( opt.infile[ pos + 2 ] == 'u' && opt.infile[ pos + 3 ] == 'f' )
+                    {
+                        opt.lang = L_F90;
+                        break;
+                    }
+                /* fall through */
+                case 'C':
+                    if ( opt.infile[ pos + 2 ] == 'U' && opt.infile[ pos + 3 ] == 'F' )
+                    {
+                        opt.lang = L_F90;
+                        break;
+                    }
+                    opt.lang = opt.infile[ pos + 2 ] ? L_CXX : L_C;
+                    break;
+            }
+        }
+    }
+    if ( opt.lang == L_NA )
+    {
+        cerr << "ERROR: cannot determine input file language\n";
+        return false;
+    }
+
+    /* if no format is specified, default is free format for f90 and fix form for f77 */
+    if ( ( opt.form == F_NA ) && ( opt.lang & L_FORTRAN ) )
+    {
+        if ( opt.lang & L_F77 )
+        {
+            opt.form = F_FIX;
+        }
+        else
+        {
+            opt.form = F_FREE;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief FNV-1a hash of the input file's base name and text, used
+ *        instead of the inode and the time of instrumentation with
+ *        --deterministic-ids. The directory is left out, so the ids do
+ *        not change when the sources are built in another place.
+ */
+static uint64_t
+hash_source( const string& source )
+{
+    uint64_t hash = 14695981039346656037ULL;
+    string   text = opt.infile.substr( opt.infile.find_last_of( '/' ) + 1 ) + '\0' + source;
+    for ( string::size_type i = 0; i < text.size(); ++i )
+    {
+        hash ^= static_cast< unsigned char >( text[ i ] );
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Generate the unique id of this compilation unit and the
+ *        include file names.
+ */
+static void
+misc_init( const string& source,
+           const string& outfile )
+{
+    struct stat status;
+    timeval     compiletime;
+    //long long int     id[ 3 ];
+    uint64_t     id[ 3 ];
+    stringstream id_str;
+    int          rest = 0;
+    /* query inode number of the infile and timestamp as unique
+       attribute, a source that exists in memory only has no inode */
+    if ( stat( opt.infile.c_str(), &status ) != 0 )
+    {
+        status.st_ino = 0;
+    }
+
+    // initialize inod_compiletime_id
+    gettimeofday( &compiletime, NULL );
+
+    //id[ 0 ] = ( long long int )status.st_ino;
+    id[ 0 ] = static_cast< uint64_t > ( status.st_ino );
+    id[ 1 ] = static_cast< uint64_t > ( compiletime.tv_sec );
+    id[ 2 ] = static_cast< uint64_t > ( compiletime.tv_usec );
+    /* the inode changes when a file is checked out again */
+    if ( option_deterministic )
+    {
+        uint64_t hash = hash_source( source );
+        id[ 0 ] = 0;
+        id[ 1 ] = hash & 0xffffffff;
+        id[ 2 ] = hash >> 32;
+    }
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        while ( id[ i ] > 36 || ( i > 1 && id[ i ] > 0 ) )
+        {
+            rest     = id[ i ] % 36;
+            id[ i ] -= rest;
+            id[ i ] /= 36;
+            if ( rest < 10 )
+            {
+                id_str << ( char )( rest + 48 );
+            }
+            else
+            {
+                id_str << ( char )( rest + 87 );
+            }
+        }
+        if ( i < 2 )
+        {
+            id[ i + 1 ] += id[ i ];
+        }
+    }
+
+    // generate opari2 include file name
+
+    // only need base filename without path for include statement
+    // in Fortran files and if an output file without dir is used
+
+    size_t sep_in = opt.infile.find_last_of( '/' );
+    opt.incfile_nopath = string( opt.infile.substr( sep_in + 1 ) +
+                                 ".opari.inc" );
+
+    size_t sep_out = outfile.find_last_of( '/' );
+    if ( sep_out == string::npos )
+    {
+        opt.incfile = "";
+    }
+    else
+    {
+        opt.incfile = outfile.substr( 0, sep_out + 1 );
+    }
+    opt.incfile += opt.incfile_nopath;
+
+    OPARI2_Directive::SetOptions( opt.lang, opt.form, opt.keep_src_info,
+                                  opt.preprocessed_file, opt.fortran_bind_c,
+                                  id_str.str() );
+
+    return;
+}
+
+/**
+ * @brief Run the parser matching the language of opt.infile.
+ */
+static void
+parse( void )
+{
+    if ( opt.lang & L_FORTRAN )
+    {
+        /* in Fortran no Underscore is needed */
+        opari2_omp_option* omp_opt  = OPARI2_DirectiveOpenmp::GetOpenmpOpt();
+        string             pomp_tpd = omp_opt->pomp_tpd;
+        OPARI2_DirectiveOpenmp::SetOptPomptpd( "pomp_tpd" );
+
+        try
+        {
+            OPARI2_FortranParser parser( opt );
+            parser.process();
+        }
+        catch ( OPARI2_Abort& )
+        {
+            OPARI2_DirectiveOpenmp::SetOptPomptpd( pomp_tpd );
+            throw;
+        }
+        OPARI2_DirectiveOpenmp::SetOptPomptpd( pomp_tpd );
+    }
+    else
+    {
+        if ( !opt.preprocessed_file )
+        {
+            opt.os << "#include \"" << opt.incfile_nopath << "\"" << "\n";
+
+            if ( opt.keep_src_info )
+            {
+                opt.os << "#line 1 \"" << opt.infile << "\"" << "\n";
+            }
+        }
+
+        OPARI2_CParser parser( opt );
+        parser.process();
+    }
+}
+
+int
+OPARI2_Instrument( const std::string& infile,
+                   const std::string& source,
+                   std::string&       output,
+                   std::string&       include,
+                   const std::string& outfile )
+{
+    ResetDirectives();
+
+    if ( !OPARI2_InitOptions( infile ) )
+    {
+        return 1;
+    }
+
+    opt.is.clear();
+    opt.is.str( source );
+    opt.os.clear();
+    opt.os.str( "" );
+    opt.incs.clear();
+    opt.incs.str( "" );
+    opt.dependencies.clear();
+
+    misc_init( source, outfile );
+
+    try
+    {
+        /* scanning is the parser time not spent in the other phases */
+        double parse_start = OPARI2_StatsStart();
+        double nested      = opari2_stats.time[ OPARI2_PHASE_READ ] +
+                             opari2_stats.time[ OPARI2_PHASE_BUILD ] +
+                             opari2_stats.time[ OPARI2_PHASE_HANDLE ];
+        parse();
+        OPARI2_StatsStop( OPARI2_PHASE_SCAN, parse_start );
+        opari2_stats.time[ OPARI2_PHASE_SCAN ] -= opari2_stats.time[ OPARI2_PHASE_READ ] +
+                                                 opari2_stats.time[ OPARI2_PHASE_BUILD ] +
+                                                 opari2_stats.time[ OPARI2_PHASE_HANDLE ] -
+                                                 nested;
+
+        /* generate *.opari.inc ( by directive_manager ) */
+        double finalize_start = OPARI2_StatsStart();
+        Finalize( opt );
+        OPARI2_StatsStop( OPARI2_PHASE_FINALIZE, finalize_start );
+    }
+    catch ( OPARI2_Abort& )
+    {
+        return 1;
+    }
+
+    output  = opt.os.str();
+    include = opt.incs.str();
+    return 0;
+}
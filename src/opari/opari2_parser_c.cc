@@ -62,6 +62,10 @@ using std::isalnum;
 using std::isalpha;
 #include <cstdlib>
 #include <cassert>
+#include <cstring>
+#include <system_error>
+#include <thread>
+using std::thread;
 
 #include "opari2.h"
 #include "opari2_parser_c.h"
@@ -70,14 +74,15 @@ using std::isalpha;
 #include "offload/opari2_directive_offload.h"
 #include "opari2_directive_manager.h"
 
+using namespace opari2;
+
 
 OPARI2_CParser::OPARI2_CParser( OPARI2_Option_t& options )
-    : m_options( options ), m_os( options.os ), m_is( options.is )
+    : m_options( options ), m_os( options.os ), m_is( options.is ),
+    m_conditionals( options )
 {
     m_line          = "";
     m_pos           = 0;
-    m_in_comment    = false;
-    m_in_string     = false;
     m_pre_cont_line = false;
     m_require_end   = true;
     m_is_for        = false;
@@ -86,6 +91,7 @@ OPARI2_CParser::OPARI2_CParser( OPARI2_Option_t& options )
     m_level         = 0;
     m_num_semi      = 0;
     m_lstart        = string::npos;
+    m_line_index    = 0;
 
     m_current_file = options.infile;
     m_infile       = options.infile;
@@ -235,6 +241,21 @@ OPARI2_CParser::process_prestmt( int               ln,
             s = 0;
         }
     }
+    else
+    {
+        /* conditionals and macro definitions, without continuations */
+        string directive;
+        for ( unsigned i = 0; i < s; ++i )
+        {
+            string::size_type end = m_pre_stmt[ i ].find_last_not_of( " \t" );
+            if ( end != string::npos && m_pre_stmt[ i ][ end ] == '\\' )
+            {
+                --end;
+            }
+            directive += m_pre_stmt[ i ].substr( 0, end + 1 ) + " ";
+        }
+        m_conditionals.HandleDirective( directive );
+    }
 
     for ( unsigned i = 0; i < s; ++i )
     {
@@ -243,6 +264,11 @@ OPARI2_CParser::process_prestmt( int               ln,
 
     orig_stmt.clear();
 
+    if ( m_conditionals.InDeadBranch() )
+    {
+        skip_dead_branch();
+    }
+
     return false;
 }
 
@@ -342,8 +368,20 @@ OPARI2_CParser::handle_preprocessor_directive( void )
                 path           = path.substr( 0, path.find_last_of( "/" ) );
                 m_current_file = path + "/" + filename;
             }
+            if ( filename[ 0 ] != '<' )
+            {
+                m_options.dependencies.insert( m_current_file );
+            }
         }
         m_os << m_line << std::endl;
+
+        /* nothing to instrument in system headers, unless a directive
+           still waits for its statement */
+        if ( m_options.preprocessed_file && m_options.skip_system_headers &&
+             !m_lexer.InString() && m_num_semi == 0 && is_system_linemarker( filename ) )
+        {
+            skip_system_header();
+        }
     }
     else if ( m_line.compare( m_lstart + 1, 5, "line " ) == 0 &&
               isdigit( m_line[ m_line.find_first_not_of( " \t", m_lstart + 5 ) ] ) )
@@ -371,6 +409,10 @@ OPARI2_CParser::handle_preprocessor_directive( void )
                 path           = path.substr( 0, path.find_last_of( "/" ) );
                 m_current_file = path + "/" + filename;
             }
+            if ( filename[ 0 ] != '<' )
+            {
+                m_options.dependencies.insert( m_current_file );
+            }
         }
         m_os << m_line << std::endl;
     }
@@ -404,23 +446,99 @@ OPARI2_CParser::handle_preprocessor_directive( void )
 }
 
 
+bool
+OPARI2_CParser::is_system_linemarker( string& filename )
+{
+    string::size_type begin = m_line.find( '"' );
+    string::size_type end   = begin;
+    if ( begin == string::npos )
+    {
+        return false;
+    }
+    do
+    {
+        end = m_line.find( '"', end + 1 );
+    }
+    while ( end != string::npos && m_line[ end - 1 ] == '\\' );
+    if ( end == string::npos )
+    {
+        return false;
+    }
+    filename = m_line.substr( begin + 1, end - begin - 1 );
+
+    /* flags: 1 enter, 2 return, 3 system header, 4 extern "C" */
+    for ( string::size_type pos = end + 1; pos < m_line.size(); ++pos )
+    {
+        if ( m_line[ pos ] == '3' &&
+             ( m_line[ pos - 1 ] == ' ' || m_line[ pos - 1 ] == '\t' ) &&
+             ( pos + 1 == m_line.size() || m_line[ pos + 1 ] == ' ' || m_line[ pos + 1 ] == '\t' ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void
+OPARI2_CParser::skip_system_header( void )
+{
+    string filename;
+    while ( get_next_line() )
+    {
+        string::size_type ls = m_line.find_first_not_of( " \t" );
+        if ( ls != string::npos && m_line[ ls ] == '#' )
+        {
+            string::size_type nr = m_line.find_first_not_of( " \t", ls + 1 );
+            if ( nr != string::npos && isdigit( m_line[ nr ] ) )
+            {
+                if ( !is_system_linemarker( filename ) )
+                {
+                    /* back in a file to instrument, the parser state
+                       is the one at the start of the span */
+                    m_lstart = ls;
+                    handle_preprocessor_directive();
+                    return;
+                }
+                if ( filename[ 0 ] == '/' )
+                {
+                    m_options.dependencies.insert( filename );
+                }
+            }
+        }
+        m_os << m_line << "\n";
+    }
+}
+
+
+void
+OPARI2_CParser::skip_dead_branch( void )
+{
+    while ( m_conditionals.InDeadBranch() && get_next_line() )
+    {
+        m_conditionals.HandleLine( m_line );
+        m_os << m_line << "\n";
+    }
+}
+
+
 void
 OPARI2_CParser::handle_preprocessor_continuation_line( void )
 {
     m_pre_stmt.push_back( m_line );
     /* check for multiline comments in preprocessor directives */
-    if ( !m_in_comment && m_line.find( "/*" ) != string::npos &&
+    if ( !m_lexer.InComment() && m_line.find( "/*" ) != string::npos &&
          !( m_line.find( "*/" ) != string::npos &&
             m_line.find( "/*" ) < m_line.find( "*/" ) ) )
     {
-        m_in_comment = true;
+        m_lexer.SetInComment( true );
     }
-    else if ( m_in_comment && m_line.find( "*/" ) != string::npos )
+    else if ( m_lexer.InComment() && m_line.find( "*/" ) != string::npos )
     {
-        m_in_comment = false;
+        m_lexer.SetInComment( false );
     }
 
-    if ( m_line[ m_line.size() - 1 ] != '\\' && !m_in_comment )
+    if ( m_line[ m_line.size() - 1 ] != '\\' && !m_lexer.InComment() )
     {
         m_pre_cont_line = false;
         if ( process_prestmt( m_lineno - m_pre_stmt.size() + 1, m_lstart + 1 ) )
@@ -443,190 +561,74 @@ OPARI2_CParser::handle_preprocessor_continuation_line( void )
 void
 OPARI2_CParser::handle_regular_line()
 {
-    bool newline_printed = false;
+    string::size_type begin, end;
+    OPARI2_CToken_t   token;
 
-    while ( m_pos < m_line.size() )
+    /* copy the text between the events verbatim */
+    m_lexer.StartLine( m_line, m_pos );
+    while ( ( token = m_lexer.Next( begin, end ) ) != T_C_END )
     {
-        newline_printed = false;
-        if ( m_in_comment )
+        m_os.write( m_line.data() + m_pos, begin - m_pos );
+        m_pos = end;
+        switch ( token )
         {
-            // look for comment end
-            if ( m_line[ m_pos ] == '*' && m_line[ m_pos + 1 ] == '/' )
-            {
-                m_os << "*/";
-                m_in_comment = false;
-                m_pos       += 2;
-            }
-            else
+            case T_C_IDENT:
             {
-                m_os << m_line[ m_pos++ ];
-            }
-        }
-        else if ( m_line[ m_pos ] == '/' )
-        {
-            m_pos++;
-            if ( m_line[ m_pos ] == '/' )
-            {
-                // c++ comments
-                m_pos++;
-                m_os << "//";
-                while ( m_pos < m_line.size() )
+                string ident( m_line, begin, end - begin );
+
+                /* Replace if valid runtime function */
+                ReplaceRuntimeAPI( ident, ident, m_current_file, L_C_OR_CXX );
+                m_os << ident;
+
+                if ( ident == "for" && m_num_semi == 1 )
                 {
-                    m_os << m_line[ m_pos++ ];
+                    m_num_semi = 3;
                 }
+                break;
             }
-            else if ( m_line[ m_pos ] == '*' )
-            {
-                // c comment start
-                m_pos++;
-                m_os << "/*";
-                m_in_comment = true;
-            }
-            else
-            {
-                m_os << '/';
-            }
-        }
-        else if ( m_in_string || m_line[ m_pos ] == '\"' )
-        {
-            // character string constant
-            if ( m_in_string )
-            {
-                m_in_string = false;
-                m_pos--; // to make sure current character gets reprocessed
-            }
-            else
-            {
-                m_os << "\"";
-            }
-            m_pos++;
-            while ( m_line[ m_pos ] != '\"' )
-            {
-                // handle C++11 multiline string, see https://en.cppreference.com/w/cpp/language/string_literal
-                if ( m_pos == m_line.size() )
+            case T_C_LBRACE:
+                // block open
+                m_os << '{';
+                m_level++;
+                m_num_semi = 0;
+                break;
+            case T_C_RBRACE:
+                // block close
+                m_os << '}';
+                m_level--;
+                if ( m_line.find_first_not_of( " \t", m_pos ) != string::npos )
                 {
-                    m_in_string = true;
-                    break;
+                    handle_closed_block();
                 }
-                if ( m_line[ m_pos ] == '\\' )
+                else
                 {
-                    m_os << '\\';
-                    m_pos++;
-                    if ( m_line[ m_pos ] == '\0' )
-                    {
-                        m_in_string = true;
-                        break;
-                    }
-                    else if ( m_line[ m_pos ] == '\\' )
-                    {
-                        if ( m_line[ m_pos + 1 ] == '\0' )
-                        {
-                            m_os << '\\';
-                            m_in_string = true;
-                            break;
-                        }
-                    }
+                    m_block_closed = true;
                 }
-                m_os << m_line[ m_pos ];
-                m_pos++;
-            }
-            if ( !m_in_string )
-            {
-                m_os << '\"';
-            }
-            m_pos++;
-        }
-        else if ( m_line[ m_pos ] == '\'' )
-        {
-            // character constant
-            m_os << "\'";
-            do
-            {
-                m_pos++;
-                if ( m_line[ m_pos ] == '\\' )
+                break;
+            case T_C_SEMI:
+                // statement end
+                m_os << ';';
+                m_num_semi--;
+                if ( m_num_semi == 0 )
                 {
-                    m_os << '\\';
-                    m_pos++;
-                    if ( m_line[ m_pos ] == '\'' )
-                    {
-                        m_os << '\'';
-                        m_pos++;
-                    }
+                    m_block_closed = true;
                 }
-                m_os << m_line[ m_pos ];
-            }
-            while ( m_line[ m_pos ] != '\'' );
-            m_pos++;
-        }
-        else if ( isalpha( m_line[ m_pos ] ) || m_line[ m_pos ] == '_' )
-        {
-            // identifier
-            string::size_type startpos = m_pos;
-            while ( m_pos < m_line.size() &&
-                    ( isalnum( m_line[ m_pos ] ) || m_line[ m_pos ] == '_' ) )
-            {
-                m_pos++;
-            }
-            string ident( m_line, startpos, m_pos - startpos );
-
-            /* Replace if valid runtime function */
-            ReplaceRuntimeAPI( ident, ident, m_current_file, L_C_OR_CXX );
-            m_os << ident;
-
-            if ( ident == "for" && m_num_semi == 1 )
-            {
-                m_num_semi = 3;
-            }
+                break;
+            default:
+                break;
         }
-        else if ( m_line[ m_pos ] == '{' )
-        {
-            // block open
-            m_os << m_line[ m_pos++ ];
-            m_level++;
-            m_num_semi = 0;
-        }
-        else if ( m_line[ m_pos ] == '}' )
-        {
-            // block close
-            m_os << m_line[ m_pos++ ];
-            m_level--;
-            size_t next_char = m_line.find_first_not_of( " \t", m_pos );
-            if ( next_char != string::npos )
-            {
-                newline_printed = handle_closed_block();
-            }
-            else
-            {
-                m_block_closed = true;
-            }
-        }
-        else if ( m_line[ m_pos ] == ';' )
-        {
-            // statement end
-            m_os << m_line[ m_pos++ ];
-            m_num_semi--;
-            if ( m_num_semi == 0 )
-            {
-                //newline_printed = handle_closed_block();
-                m_block_closed = true;
-            }
-        }
-        else
-        {
-            m_os << m_line[ m_pos++ ];
-        }
-    }
-    if ( !newline_printed )
-    {
-        m_os << '\n';
     }
+    m_os.write( m_line.data() + m_pos, m_line.size() - m_pos );
+    m_os << '\n';
+    m_pos = m_line.size();
 }
 
 bool
 OPARI2_CParser::get_next_line( void )
 {
-    bool success = ( bool )getline( m_is, m_line );
+    bool success = OPARI2_ReadLine( m_is, m_line );
     ++m_lineno;
+    ++m_line_index;
     m_pos = 0;
 
     //std::cout << m_lineno << ": " << m_line << std::endl;
@@ -636,8 +638,9 @@ OPARI2_CParser::get_next_line( void )
         /* workaround for bogus getline implementations */
         while ( m_line.size() == 1 && m_line[ 0 ] == '\0' )
         {
-            success = ( bool )getline( m_is, m_line );
+            success = OPARI2_ReadLine( m_is, m_line );
             ++m_lineno;
+            ++m_line_index;
         }
 
         /* remove extra \r from Windows source files */
@@ -651,6 +654,171 @@ OPARI2_CParser::get_next_line( void )
 }
 
 
+/** @brief Check whether text contains the string word. */
+static bool
+contains( const char* text,
+          size_t      len,
+          const char* word )
+{
+    size_t wlen = strlen( word );
+    for ( size_t i = 0; i + wlen <= len; ++i )
+    {
+        if ( text[ i ] == word[ 0 ] && strncmp( text + i, word, wlen ) == 0 )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/** @brief Determine how handle_regular_line() would change the parser
+ *         state for a line that starts outside of comments and
+ *         strings. The line is plain if it holds no preprocessor
+ *         directive, runtime API call or offload declaration and ends
+ *         outside of comments and strings.
+ */
+static void
+scan_line( const char* line,
+           size_t      len,
+           bool&       plain,
+           bool&       closes_block,
+           int&        level_change,
+           int&        min_level )
+{
+    plain        = false;
+    closes_block = false;
+    level_change = 0;
+    min_level    = 0;
+
+    /* get_next_line() removes the \r of Windows source files */
+    if ( len && line[ len - 1 ] == '\r' )
+    {
+        len--;
+    }
+    size_t pos = 0;
+    while ( pos < len && ( line[ pos ] == ' ' || line[ pos ] == '\t' ) )
+    {
+        pos++;
+    }
+    if ( ( pos < len && line[ pos ] == '#' ) ||
+         ( len == 1 && line[ 0 ] == '\0' ) ||
+         contains( line, len, "omp_" ) ||
+         contains( line, len, "__declspec" ) ||
+         contains( line, len, "___POMP2_INCLUDE___" ) )
+    {
+        return;
+    }
+
+    string            text( line, len );
+    OPARI2_CLexer     lexer;
+    string::size_type begin, end;
+    OPARI2_CToken_t   token;
+    lexer.StartLine( text );
+    while ( ( token = lexer.Next( begin, end ) ) != T_C_END )
+    {
+        if ( token == T_C_LBRACE )
+        {
+            level_change++;
+        }
+        else if ( token == T_C_RBRACE )
+        {
+            level_change--;
+            if ( level_change < min_level )
+            {
+                min_level = level_change;
+            }
+            closes_block = text.find_first_not_of( " \t", end ) == string::npos;
+        }
+    }
+
+    plain = !lexer.InComment() && !lexer.InString();
+}
+
+
+void
+OPARI2_CParser::scan_lines( const vector<const char*>* starts,
+                            size_t                     first,
+                            size_t                     last,
+                            line_scan_t*               result )
+{
+    for ( size_t i = first; i < last; ++i )
+    {
+        line_scan_t& r = result[ i ];
+        scan_line( ( *starts )[ i ], ( *starts )[ i + 1 ] - ( *starts )[ i ] - 1,
+                   r.plain, r.closes_block, r.level_change, r.min_level );
+    }
+}
+
+
+void
+OPARI2_CParser::prescan_lines( void )
+{
+    string              text = m_options.is.str();
+    vector<const char*> starts;
+    for ( const char* p = text.c_str(); p < text.c_str() + text.size(); )
+    {
+        const char* nl = static_cast<const char*>( memchr( p, '\n', text.c_str() + text.size() - p ) );
+        starts.push_back( p );
+        p = nl ? nl + 1 : text.c_str() + text.size();
+    }
+    size_t n = starts.size();
+    starts.push_back( text.c_str() + text.size() + 1 );
+    if ( n == 0 )
+    {
+        return;
+    }
+
+    /* the threads only read the text and write disjoint ranges of
+       the result, the first chunk is scanned by the calling thread */
+    m_scan.resize( n );
+    size_t         jobs  = m_options.jobs;
+    size_t         chunk = ( n + jobs - 1 ) / jobs;
+    vector<thread> threads;
+    for ( size_t first = chunk; first < n; first += chunk )
+    {
+        size_t last = first + chunk < n ? first + chunk : n;
+        try
+        {
+            threads.push_back( thread( scan_lines, &starts, first, last, &m_scan[ 0 ] ) );
+        }
+        catch ( const std::system_error& )
+        {
+            /* without another thread the lines are scanned here */
+            scan_lines( &starts, first, last, &m_scan[ 0 ] );
+        }
+    }
+    scan_lines( &starts, 0, chunk < n ? chunk : n, &m_scan[ 0 ] );
+    for ( size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[ i ].join();
+    }
+}
+
+
+bool
+OPARI2_CParser::copy_plain_line( void )
+{
+    if ( m_line_index == 0 || m_line_index > m_scan.size() )
+    {
+        return false;
+    }
+    const line_scan_t& scan = m_scan[ m_line_index - 1 ];
+    if ( !scan.plain || m_block_closed || m_lexer.InComment() || m_lexer.InString() ||
+         m_pre_cont_line || m_next_end.top() != -1 || m_num_semi > 0 ||
+         m_level + scan.min_level < 0 )
+    {
+        return false;
+    }
+
+    /* handle_regular_line() would only copy the line and count braces */
+    m_os << m_line << '\n';
+    m_level       += scan.level_change;
+    m_block_closed = scan.closes_block;
+    return true;
+}
+
+
 /** Parse source file line by line, search for directives and the
  *  related code blocks. Comments and strings are removed to avoid
  *  finding keywords in comments.
@@ -658,6 +826,11 @@ OPARI2_CParser::get_next_line( void )
 void
 OPARI2_CParser::process( void )
 {
+    if ( m_options.jobs > 1 )
+    {
+        prescan_lines();
+    }
+
     while ( get_next_line() )
     {
         string::size_type ls;
@@ -670,10 +843,15 @@ OPARI2_CParser::process( void )
             m_block_closed = false;
         }
 
+        if ( copy_plain_line() )
+        {
+            continue;
+        }
+
         /* start offload region if __declspec is found and continue to
          * parse the rest of the line as usual without the __declspec
          */
-        if ( !m_in_comment &&
+        if ( !m_lexer.InComment() && !m_lexer.InString() &&
              ( ( ls = m_line.find_first_not_of( " \t" ) ) != string::npos ) &&
              m_line.substr( ls, 10 ) == "__declspec" )
         {
@@ -707,13 +885,14 @@ OPARI2_CParser::process( void )
         {
             handle_preprocessor_continuation_line();
         }
-        else if ( !m_in_comment && m_options.preprocessed_file &&
+        else if ( !m_lexer.InComment() && !m_lexer.InString() &&
+                  m_options.preprocessed_file &&
                   ( m_line == "___POMP2_INCLUDE___"  ||
                     m_line == "___POMP2_INCLUDE___ " ) ) // Studio compiler appends a blank during preprocessing
         {
             m_os << "#include \"" << m_options.incfile << "\"" << "\n";
         }
-        else if ( !m_in_comment &&
+        else if ( !m_lexer.InComment() && !m_lexer.InString() &&
                   ( ( m_lstart = m_line.find_first_not_of( " \t" ) ) != string::npos ) &&
                   m_line[ m_lstart ] == '#' )
         {
@@ -20,6 +20,9 @@
 #ifndef OPARI2_PARSER_C_H
 #define OPARI2_PARSER_C_H
 
+#include "opari2_conditional.h"
+#include "opari2_lexer_c.h"
+
 class OPARI2_CParser
 {
 public:
@@ -30,10 +33,22 @@ public:
     };
 
 private:
+/** @brief Effect of a line on the parser state, as determined by
+           prescan_lines() */
+    typedef struct
+    {
+        /** Whether the line can be copied without parsing */
+        bool plain;
+        /** Whether the line ends with a closing brace */
+        bool closes_block;
+        /** Change of the brace level */
+        int  level_change;
+        /** Lowest brace level within the line, relative to its start */
+        int  min_level;
+    } line_scan_t;
+
     string            m_line;
     string::size_type m_pos;
-    bool              m_in_comment;
-    bool              m_in_string;
     bool              m_pre_cont_line;
     bool              m_require_end;
     bool              m_is_for;
@@ -48,9 +63,13 @@ private:
     string            m_current_file;
     string            m_infile;
 
-    OPARI2_Option_t& m_options;
-    ofstream&        m_os;
-    ifstream&        m_is;
+    OPARI2_Option_t&    m_options;
+    ostream&            m_os;
+    istream&            m_is;
+    OPARI2_Conditionals m_conditionals;
+    OPARI2_CLexer       m_lexer;
+    vector<line_scan_t> m_scan;
+    size_t              m_line_index;
 
 
     string
@@ -81,6 +100,28 @@ private:
     void
     handle_preprocessor_directive( void );
 
+/**
+ * @brief Check whether the line marker in m_line has the flag 3 of a
+ *        system header and store the file it names in filename.
+ */
+    bool
+    is_system_linemarker( string& filename );
+
+/**
+ * @brief Copy the lines of a branch that is dead for the macros given
+ *        by -D and -U verbatim, up to the directive that ends it.
+ */
+    void
+    skip_dead_branch( void );
+
+/**
+ * @brief Copy the lines of a system header span of a preprocessed file
+ *        verbatim, up to the line marker that returns to a non-system
+ *        file.
+ */
+    void
+    skip_system_header( void );
+
     void
     handle_preprocessor_continuation_line( void );
 
@@ -90,6 +131,32 @@ private:
     bool
     get_next_line( void );
 
+/**
+ * @brief Classify the lines [first, last) of the input, which start
+ *        at starts, into result. Runs in the threads of
+ *        prescan_lines().
+ */
+    static void
+    scan_lines( const vector<const char*>* starts,
+                size_t                     first,
+                size_t                     last,
+                line_scan_t*               result );
+
+/**
+ * @brief Classify the lines of the input with --jobs=n threads and
+ *        store the result in m_scan.
+ */
+    void
+    prescan_lines( void );
+
+/**
+ * @brief Copy the current line without parsing if prescan_lines()
+ *        found it to be plain and the parser is outside of any
+ *        construct, comment or string.
+ */
+    bool
+    copy_plain_line( void );
+
 
 public:
 /**  @brief Instrument directives / runtime APIs in C/C++ source file.
@@ -66,6 +66,8 @@ using std::remove_if;
 #include "opari2_parser_f.h"
 #include "opari2_directive_manager.h"
 
+using namespace opari2;
+
 struct fo_tolower : public std::unary_function<int, int>
 {
     int
@@ -76,7 +78,8 @@ struct fo_tolower : public std::unary_function<int, int>
 };
 
 OPARI2_FortranParser::OPARI2_FortranParser( OPARI2_Option_t& options )
-    : m_options( options ), m_os( options.os ), m_is( options.is )
+    : m_options( options ), m_os( options.os ), m_is( options.is ),
+    m_conditionals( options )
 {
     m_line             = "";
     m_lowline          = "";
@@ -90,6 +93,13 @@ OPARI2_FortranParser::OPARI2_FortranParser( OPARI2_Option_t& options )
     m_continuation = false;
     m_sentinel     = "";
 
+    m_header_continuation = false;
+    m_header_brackets     = 0;
+    m_in_program          = false;
+    m_in_module           = false;
+    m_in_interface        = false;
+    m_in_contains         = false;
+
     m_offload_pragma           = false;
     m_offload_attribute        = "";
     m_current_offload_function = "";
@@ -122,12 +132,6 @@ OPARI2_FortranParser::is_sub_unit_header( void )
     string      lline;
     string      keyword;
     bool        result;
-    static bool continuation = false;
-    static int  openbrackets = 0;
-    static bool inProgram    = false;
-    static bool inModule     = false;
-    static bool inInterface  = false;
-    static bool inContains   = false;
 
     size_t pos;
 
@@ -149,33 +153,33 @@ OPARI2_FortranParser::is_sub_unit_header( void )
     //Set number of open brackets to 0 if new unit begins, since we might have missed
     //closing brackets on continuation lines.
     if ( ( ( sline.find( "program" ) == 0 )  && lline.find( "program" ) != string::npos )               ||
-         ( ( sline.find( "module" ) == 0 ) && !inProgram && lline.find( "module" ) != string::npos )     ||
-         ( ( sline.find( "interface" ) == 0 ) && inModule && lline.find( "interface" ) != string::npos ) ||
-         ( ( sline.find( "abstractinterface" ) == 0 ) && inModule )  ||
-         ( ( sline.find( "contains" ) != string::npos ) && inModule  && lline.find( "contains" ) != string::npos )  ||
+         ( ( sline.find( "module" ) == 0 ) && !m_in_program && lline.find( "module" ) != string::npos )     ||
+         ( ( sline.find( "interface" ) == 0 ) && m_in_module && lline.find( "interface" ) != string::npos ) ||
+         ( ( sline.find( "abstractinterface" ) == 0 ) && m_in_module )  ||
+         ( ( sline.find( "contains" ) != string::npos ) && m_in_module  && lline.find( "contains" ) != string::npos )  ||
          ( sline.find( "subroutine" ) == 0  && lline.find( "subroutine" ) != string::npos )                                                 ||
          ( ( sline.find( "function" ) == 0  && lline.find( "function" ) != string::npos )  &&
            !m_in_header                                &&
            ( ( sline.find( "=" ) >= sline.find( "!" ) )             ||
              ( sline.find( "=" ) >= sline.find( "kind" ) ) ) ) )
     {
-        openbrackets = 0;
+        m_header_brackets = 0;
     }
 
     //Check if we are in Fortran77 and have a character in column 6
     if ( ( m_options.form & F_FIX ) && m_lowline.length() >= 6 && m_lowline[ 5 ] != ' ' && m_lowline.find( "\t" ) > 6 )
     {
-        continuation = true;
+        m_header_continuation = true;
     }
 
     //Check if we enter a program block
-    inProgram = inProgram || ( sline.find( "program" ) == 0 );
+    m_in_program = m_in_program || ( sline.find( "program" ) == 0 );
     //Check if we enter a module block
-    inModule = !inProgram && ( inModule || ( sline.find( "module" ) == 0 ) );
+    m_in_module = !m_in_program && ( m_in_module || ( sline.find( "module" ) == 0 ) );
     //Check if we enter an interface block
-    inInterface = inModule && ( inInterface || ( sline.find( "interface" ) == 0 ) || ( sline.find( "abstractinterface" ) == 0 ) );
+    m_in_interface = m_in_module && ( m_in_interface || ( sline.find( "interface" ) == 0 ) || ( sline.find( "abstractinterface" ) == 0 ) );
     //Check if we enter a contains block
-    inContains = inModule && ( inContains || ( sline.find( "contains" ) != string::npos ) );
+    m_in_contains = m_in_module && ( m_in_contains || ( sline.find( "contains" ) != string::npos ) );
 
     //search for words indicating, that we did not reach a point where
     //we can insert variable definitions, these keywords are:
@@ -229,50 +233,50 @@ OPARI2_FortranParser::is_sub_unit_header( void )
                   ( sline.empty()  && m_in_header )                 ||
                   ( sline.find( "parameter" ) == 0 && m_in_header ) ||
                   ( sline.find( "dimension" ) == 0 && m_in_header ) ||
-                  ( openbrackets != 0 && m_in_header )              ||
-                  ( continuation && m_in_header ) );
+                  ( m_header_brackets != 0 && m_in_header )         ||
+                  ( m_header_continuation && m_in_header ) );
 
     /* Debug output */
     /*std::cout << std::endl << lline << std::endl;
-       std::cout << "continuation= " << continuation << std::endl;
+       std::cout << "m_header_continuation= " << m_header_continuation << std::endl;
        std::cout << "m_in_header= " << m_in_header << std::endl;
        std::cout << "func= " << func << std::endl;
        std::cout << "sub= " << sub << std::endl;
        std::cout << "key= " << key << std::endl;
        std::cout << "validequal= " << validequal << std::endl;
        std::cout << "misc= " << misc << std::endl;
-       std::cout << "openbrackets= " << openbrackets << std::endl;
-       std::cout << "inModule= " << inModule << std::endl;
-       std::cout << "inInterface= " << inInterface << std::endl;
-       std::cout << "inContains= " << inContains << std::endl;
+       std::cout << "m_header_brackets= " << m_header_brackets << std::endl;
+       std::cout << "m_in_module= " << m_in_module << std::endl;
+       std::cout << "m_in_interface= " << m_in_interface << std::endl;
+       std::cout << "m_in_contains= " << m_in_contains << std::endl;
        std::cout << "noend= " << noend << std::endl;*/
 
     if ( ( ( sline.find( "program" ) == 0 || func || sub || key ) &&
            noend && validequal )     ||
          misc )
     {
-        result = !inModule || ( !inInterface && inContains );
+        result = !m_in_module || ( !m_in_interface && m_in_contains );
     }
     else
     {
         result = false;
     }
     //Check if we leave a program block
-    inProgram = inProgram && sline.find( "endprogram" ) == string::npos;
+    m_in_program = m_in_program && sline.find( "endprogram" ) == string::npos;
     //Check if we leave a module block
-    inModule = inModule && sline.find( "endmodule" ) == string::npos;
+    m_in_module = m_in_module && sline.find( "endmodule" ) == string::npos;
     //Check if we leave an interface block
-    inInterface = inInterface && sline.find( "endinterface" ) == string::npos;
+    m_in_interface = m_in_interface && sline.find( "endinterface" ) == string::npos;
     //Check if we leave an contains block
-    inContains = inContains && sline.find( "endmodule" ) == string::npos;
+    m_in_contains = m_in_contains && sline.find( "endmodule" ) == string::npos;
 
     if ( sline.length() && sline[ sline.length() - 1 ] == '&' )
     {
-        continuation = true;
+        m_header_continuation = true;
     }
     else
     {
-        continuation = false;
+        m_header_continuation = false;
     }
 
     /*count open brackets, to see if a functionheader is split across different lines*/
@@ -281,11 +285,11 @@ OPARI2_FortranParser::is_sub_unit_header( void )
         bool in_string = false;
         if ( m_lowline[ i ] == '(' )
         {
-            openbrackets++;
+            m_header_brackets++;
         }
         if ( m_lowline[ i ] == ')' )
         {
-            openbrackets--;
+            m_header_brackets--;
         }
         if ( ( m_lowline[ i ] == '\'' || m_lowline[ i ] == '"' ) && in_string )
         {
@@ -640,7 +644,7 @@ OPARI2_FortranParser::is_directive( void )
 bool
 OPARI2_FortranParser::get_next_line( void )
 {
-    if ( getline( m_is, m_line ) )
+    if ( OPARI2_ReadLine( m_is, m_line ) )
     {
         /* workaround for bogus getline implementations */
         while ( m_line.size() == 1 && m_line[ 0 ] == '\0' )
@@ -708,6 +712,10 @@ OPARI2_FortranParser::handle_line_directive( const string::size_type lstart )
                 path        = path.substr( 0, path.find_last_of( "/" ) );
                 m_curr_file = path + "/" + filename;
             }
+            if ( filename[ 0 ] != '<' )
+            {
+                m_options.dependencies.insert( m_curr_file );
+            }
         }
         m_os << m_line << std::endl;
     }
@@ -737,6 +745,10 @@ OPARI2_FortranParser::handle_line_directive( const string::size_type lstart )
                 path        = path.substr( 0, path.find_last_of( "/" ) );
                 m_curr_file = path + "/" + filename;
             }
+            if ( filename[ 0 ] != '<' )
+            {
+                m_options.dependencies.insert( m_curr_file );
+            }
         }
         m_os << m_line << std::endl;
     }
@@ -744,6 +756,14 @@ OPARI2_FortranParser::handle_line_directive( const string::size_type lstart )
     {
         /*keep other C/C++ preprocessor directives like #if and #endif*/
         m_os << m_line << std::endl;
+
+        /* copy branches that are dead for the macros given by -D and -U */
+        m_conditionals.HandleLine( m_line );
+        while ( m_conditionals.InDeadBranch() && get_next_line() )
+        {
+            m_conditionals.HandleLine( m_line );
+            m_os << m_line << '\n';
+        }
     }
 }
 
@@ -871,6 +891,9 @@ OPARI2_FortranParser::handle_directive( void )
     }
     else
     {
+        // An ignored directive may follow a loop that needs to be ended
+        test_and_insert_enddo();
+
         // Print orig code if directive is ignored.
         for ( vector<string>::const_iterator line = lines.begin();
               line != lines.end(); ++line )
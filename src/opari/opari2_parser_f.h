@@ -32,6 +32,7 @@ using std::stack;
 #include "opari2.h"
 #include "opari2_directive_manager.h"
 #include "opari2_directive.h"
+#include "opari2_conditional.h"
 
 /** @brief information about loops*/
 typedef struct
@@ -75,6 +76,14 @@ private:
     bool                          m_next_is_continuation;
     string                        m_sentinel;
 
+    // program unit state tracked by is_sub_unit_header()
+    bool m_header_continuation;
+    int  m_header_brackets;
+    bool m_in_program;
+    bool m_in_module;
+    bool m_in_interface;
+    bool m_in_contains;
+
     bool   m_offload_pragma;
     string m_offload_attribute;
     string m_current_offload_function;
@@ -89,9 +98,10 @@ private:
     bool m_waitfor_loopend;
     int  m_lineno_loopend;
 
-    OPARI2_Option_t& m_options;
-    ofstream&        m_os;
-    ifstream&        m_is;
+    OPARI2_Option_t&    m_options;
+    ostream&            m_os;
+    istream&            m_is;
+    OPARI2_Conditionals m_conditionals;
 
     /**@brief Check if the line belongs to the header of a subroutine or function.
      *        After lines in the header, we can insert our variable definitions.*/
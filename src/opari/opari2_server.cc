@@ -0,0 +1,540 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_server.cc
+ *
+ *  @brief      This file contains the server mode of the opari2
+ *              command. The protocol is described in opari2_server.h. */
+
+#include <config.h>
+#include <iostream>
+using std::cerr;
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+#include <iterator>
+#include <sstream>
+using std::ostringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+#include <cstring>
+using std::strncmp;
+using std::strcmp;
+using std::strchr;
+using std::strlen;
+using std::strerror;
+using std::memset;
+#include <cstdlib>
+using std::strtol;
+using std::strtoul;
+#include <cerrno>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "opari2_server.h"
+
+
+/* set by SIGINT and SIGTERM to shut the server down */
+static volatile sig_atomic_t stop_server = 0;
+
+/** @brief Buffered reading of a request from a connection. */
+typedef struct
+{
+    int    fd;
+    string buffer;
+    size_t pos;
+} request_stream_t;
+
+static void
+handle_stop_signal( int )
+{
+    stop_server = 1;
+}
+
+/**
+ * @brief Append the next chunk of the connection to the buffer.
+ *
+ * @return false on end of file or error.
+ */
+static bool
+fill_buffer( request_stream_t& rs )
+{
+    rs.buffer.erase( 0, rs.pos );
+    rs.pos = 0;
+
+    char    chunk[ 65536 ];
+    ssize_t n;
+    do
+    {
+        n = read( rs.fd, chunk, sizeof( chunk ) );
+    }
+    while ( n < 0 && errno == EINTR );
+
+    if ( n <= 0 )
+    {
+        return false;
+    }
+    rs.buffer.append( chunk, n );
+    return true;
+}
+
+static bool
+read_line( request_stream_t& rs,
+           string&           line )
+{
+    size_t newline;
+    while ( ( newline = rs.buffer.find( '\n', rs.pos ) ) == string::npos )
+    {
+        if ( !fill_buffer( rs ) )
+        {
+            return false;
+        }
+    }
+    line.assign( rs.buffer, rs.pos, newline - rs.pos );
+    rs.pos = newline + 1;
+    return true;
+}
+
+static bool
+read_bytes( request_stream_t& rs,
+            size_t            length,
+            string&           data )
+{
+    while ( rs.buffer.size() - rs.pos < length )
+    {
+        if ( !fill_buffer( rs ) )
+        {
+            return false;
+        }
+    }
+    data.assign( rs.buffer, rs.pos, length );
+    rs.pos += length;
+    return true;
+}
+
+static bool
+write_all( int           fd,
+           const string& data )
+{
+    size_t done = 0;
+    while ( done < data.size() )
+    {
+        ssize_t n = write( fd, data.data() + done, data.size() - done );
+        if ( n < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( n <= 0 )
+        {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+/**
+ * @brief Read one request from the connection, run the opari2 command
+ *        and send the reply.
+ *
+ * Called in a freshly forked process, so the command may change the
+ * working directory and the global state of libopari2.
+ */
+static void
+handle_request( int fd )
+{
+    request_stream_t rs;
+    rs.fd  = fd;
+    rs.pos = 0;
+
+    vector<string> args( 1, "opari2" );
+    string         source;
+    bool           have_source = false;
+    bool           complete    = false;
+    ostringstream  errors;
+    string         line;
+
+    while ( !complete && read_line( rs, line ) )
+    {
+        size_t blank = line.find( ' ' );
+        string key   = line.substr( 0, blank );
+        string value = blank == string::npos ? "" : line.substr( blank + 1 );
+
+        if ( key == "END" )
+        {
+            complete = true;
+        }
+        else if ( key == "ARG" )
+        {
+            args.push_back( value );
+        }
+        else if ( key == "CWD" )
+        {
+            if ( chdir( value.c_str() ) != 0 )
+            {
+                errors << "ERROR: cannot change to directory " << value << "\n";
+            }
+        }
+        else if ( key == "SOURCE" )
+        {
+            if ( !read_bytes( rs, strtoul( value.c_str(), NULL, 10 ), source ) )
+            {
+                break;
+            }
+            have_source = true;
+        }
+        else
+        {
+            errors << "ERROR: unknown request line " << key << "\n";
+        }
+    }
+
+    /* the client went away */
+    if ( !complete )
+    {
+        return;
+    }
+
+    int    status = 1;
+    string output;
+    string include;
+    if ( errors.str().empty() )
+    {
+        vector<char*> argv;
+        for ( vector<string>::iterator it = args.begin(); it != args.end(); ++it )
+        {
+            argv.push_back( &( *it )[ 0 ] );
+        }
+        argv.push_back( NULL );
+
+        ostringstream   out;
+        std::streambuf* cout_buf = std::cout.rdbuf( out.rdbuf() );
+        std::streambuf* cerr_buf = cerr.rdbuf( errors.rdbuf() );
+        status = run_command( argv.size() - 1, &argv[ 0 ],
+                              have_source ? &source : NULL,
+                              have_source ? &include : NULL );
+        std::cout.rdbuf( cout_buf );
+        cerr.rdbuf( cerr_buf );
+        output = out.str();
+    }
+
+    ostringstream reply;
+    reply << "STATUS " << status << "\n"
+          << "STDOUT " << output.size() << "\n" << output
+          << "STDERR " << errors.str().size() << "\n" << errors.str()
+          << "INCLUDE " << include.size() << "\n" << include;
+    write_all( fd, reply.str() );
+}
+
+/**
+ * @brief Connect to the server listening on socket_path.
+ *
+ * @return The connected socket, or -1 after printing an error.
+ */
+static int
+connect_server( const string& socket_path )
+{
+    sockaddr_un address;
+    memset( &address, 0, sizeof( address ) );
+    address.sun_family = AF_UNIX;
+    if ( socket_path.empty() || socket_path.size() >= sizeof( address.sun_path ) )
+    {
+        cerr << "ERROR: invalid socket name " << socket_path << "\n";
+        return -1;
+    }
+    socket_path.copy( address.sun_path, socket_path.size() );
+
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( fd < 0 ||
+         connect( fd, ( sockaddr* )&address, sizeof( address ) ) != 0 )
+    {
+        cerr << "ERROR: cannot connect to server on socket " << socket_path << ": "
+             << strerror( errno ) << "\n";
+        if ( fd >= 0 )
+        {
+            close( fd );
+        }
+        return -1;
+    }
+    return fd;
+}
+
+int
+run_client( int   argc,
+            char* argv[] )
+{
+    string socket_path( argv[ 1 ] + 9 );
+
+    /* the working directory of the client */
+    vector<char> cwd( 256 );
+    while ( !getcwd( &cwd[ 0 ], cwd.size() ) )
+    {
+        if ( errno != ERANGE )
+        {
+            cerr << "ERROR: cannot determine working directory: " << strerror( errno ) << "\n";
+            return 1;
+        }
+        cwd.resize( 2 * cwd.size() );
+    }
+
+    ostringstream request;
+    request << "CWD " << &cwd[ 0 ] << "\n";
+    for ( int a = 2; a < argc; ++a )
+    {
+        if ( strchr( argv[ a ], '\n' ) )
+        {
+            cerr << "ERROR: argument with a newline cannot be sent to the server\n";
+            return 1;
+        }
+        request << "ARG " << argv[ a ] << "\n";
+    }
+
+    /* with outfile "-" the input is sent along and the include file
+       returned, so the server does not write into this directory */
+    string infile;
+    if ( argc > 3 && strcmp( argv[ argc - 1 ], "-" ) == 0 && argv[ argc - 2 ][ 0 ] != '-' )
+    {
+        infile = argv[ argc - 2 ];
+
+        ifstream is( infile.c_str() );
+        string   source( ( std::istreambuf_iterator<char>( is ) ),
+                         std::istreambuf_iterator<char>() );
+        if ( !is )
+        {
+            cerr << "ERROR: cannot open input file " << infile << "\n";
+            return 1;
+        }
+        request << "SOURCE " << source.size() << "\n" << source;
+    }
+    request << "END\n";
+
+    int fd = connect_server( socket_path );
+    if ( fd < 0 )
+    {
+        return 1;
+    }
+    if ( !write_all( fd, request.str() ) )
+    {
+        cerr << "ERROR: cannot send request to server: " << strerror( errno ) << "\n";
+        close( fd );
+        return 1;
+    }
+
+    request_stream_t rs;
+    rs.fd  = fd;
+    rs.pos = 0;
+
+    int    status   = -1;
+    bool   complete = false;
+    string line;
+    string data;
+    while ( read_line( rs, line ) )
+    {
+        size_t blank = line.find( ' ' );
+        string key   = line.substr( 0, blank );
+        long   value = blank == string::npos ? 0 : strtol( line.c_str() + blank + 1, NULL, 10 );
+
+        if ( key == "STATUS" )
+        {
+            status = value;
+            continue;
+        }
+        if ( !read_bytes( rs, value, data ) )
+        {
+            break;
+        }
+        if ( key == "STDOUT" )
+        {
+            std::cout << data << std::flush;
+        }
+        else if ( key == "STDERR" )
+        {
+            cerr << data;
+        }
+        else if ( key == "INCLUDE" )
+        {
+            /* the command writes the include file of outfile "-" into
+               the working directory */
+            if ( status == 0 && !infile.empty() )
+            {
+                string   incfile = infile.substr( infile.find_last_of( '/' ) + 1 ) + ".opari.inc";
+                ofstream os( incfile.c_str() );
+                if ( !( os << data ) )
+                {
+                    cerr << "ERROR: cannot write opari include file " << incfile << "\n";
+                    status = 1;
+                }
+            }
+            complete = true;
+        }
+    }
+    close( fd );
+
+    if ( !complete || status < 0 )
+    {
+        cerr << "ERROR: incomplete reply from server on socket " << socket_path << "\n";
+        return 1;
+    }
+    return status;
+}
+
+int
+run_server( int   argc,
+            char* argv[] )
+{
+    string socket_path;
+    long   jobs = sysconf( _SC_NPROCESSORS_ONLN );
+    if ( jobs < 1 )
+    {
+        jobs = 1;
+    }
+
+    for ( int a = 1; a < argc; ++a )
+    {
+        if ( strncmp( argv[ a ], "--server=", 9 ) == 0 )
+        {
+            socket_path = string( argv[ a ] + 9 );
+        }
+        else if ( strncmp( argv[ a ], "--server-jobs=", 14 ) == 0 )
+        {
+            char* end;
+            jobs = strtol( argv[ a ] + 14, &end, 10 );
+            if ( *end != '\0' || jobs < 1 )
+            {
+                cerr << "ERROR: invalid number of server jobs " << argv[ a ] + 14 << "\n";
+                return 1;
+            }
+        }
+        else
+        {
+            cerr << "ERROR: option " << argv[ a ] << " cannot be used with --server\n";
+            return 1;
+        }
+    }
+
+    sockaddr_un address;
+    memset( &address, 0, sizeof( address ) );
+    address.sun_family = AF_UNIX;
+    if ( socket_path.empty() || socket_path.size() >= sizeof( address.sun_path ) )
+    {
+        cerr << "ERROR: invalid socket name " << socket_path << "\n";
+        return 1;
+    }
+    socket_path.copy( address.sun_path, socket_path.size() );
+
+    /* remove the socket of a previous server */
+    struct stat st;
+    if ( lstat( socket_path.c_str(), &st ) == 0 && S_ISSOCK( st.st_mode ) )
+    {
+        unlink( socket_path.c_str() );
+    }
+
+    int listen_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( listen_fd < 0 ||
+         bind( listen_fd, ( sockaddr* )&address, sizeof( address ) ) != 0 ||
+         listen( listen_fd, SOMAXCONN ) != 0 )
+    {
+        cerr << "ERROR: cannot listen on socket " << socket_path << ": "
+             << strerror( errno ) << "\n";
+        return 1;
+    }
+
+    /* no SA_RESTART, so that the signals interrupt accept() and waitpid() */
+    struct sigaction action;
+    memset( &action, 0, sizeof( action ) );
+    action.sa_handler = handle_stop_signal;
+    sigemptyset( &action.sa_mask );
+    sigaction( SIGINT, &action, NULL );
+    sigaction( SIGTERM, &action, NULL );
+    signal( SIGPIPE, SIG_IGN );
+
+    long running = 0;
+    while ( !stop_server )
+    {
+        /* reap finished requests, wait for one if all jobs are busy */
+        while ( running > 0 && waitpid( -1, NULL, running >= jobs ? 0 : WNOHANG ) > 0 )
+        {
+            --running;
+        }
+        if ( running >= jobs )
+        {
+            continue;
+        }
+
+        int fd = accept( listen_fd, NULL, NULL );
+        if ( fd < 0 )
+        {
+            if ( errno == EINTR || errno == ECONNABORTED )
+            {
+                continue;
+            }
+            cerr << "ERROR: cannot accept connection on socket " << socket_path
+                 << ": " << strerror( errno ) << "\n";
+            break;
+        }
+
+        pid_t pid = fork();
+        if ( pid == 0 )
+        {
+            close( listen_fd );
+            signal( SIGINT, SIG_DFL );
+            signal( SIGTERM, SIG_DFL );
+            handle_request( fd );
+            close( fd );
+            _exit( 0 );
+        }
+        if ( pid < 0 )
+        {
+            cerr << "ERROR: cannot fork request handler: " << strerror( errno ) << "\n";
+        }
+        else
+        {
+            ++running;
+        }
+        close( fd );
+    }
+
+    close( listen_fd );
+    unlink( socket_path.c_str() );
+    while ( running > 0 && waitpid( -1, NULL, 0 ) > 0 )
+    {
+        --running;
+    }
+
+    return stop_server ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2013,
+ * RWTH Aachen University, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Dresden, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * University of Oregon, Eugene, USA
+ *
+ * Copyright (c) 2009-2013, 2015,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *
+ * Copyright (c) 2009-2013,
+ * Technische Universitaet Muenchen, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/** @internal
+ *
+ *  @file       opari2_server.h
+ *
+ *  @brief      Server mode of the opari2 command, which instruments
+ *              files on request of clients connecting to a unix socket.
+ *
+ *              A request is a sequence of lines, each a keyword and a
+ *              value separated by one blank:
+ *
+ *              CWD <directory>      working directory of the client
+ *              ARG <argument>       one argument of the opari2 command
+ *                                   line, repeated for each argument
+ *              SOURCE <length>      followed by <length> bytes holding
+ *                                   the text of the input file, which
+ *                                   is then not read from disk
+ *              END                  end of the request
+ *
+ *              The server runs the opari2 command with these arguments
+ *              in the given directory, so it writes the output file like
+ *              the command does. The include file is written as well
+ *              unless the request contains SOURCE. The reply is
+ *
+ *              STATUS <exit status of the command>
+ *              STDOUT <length>      followed by <length> bytes, e.g. the
+ *                                   instrumented source for outfile "-"
+ *              STDERR <length>      followed by <length> bytes of
+ *                                   error messages
+ *              INCLUDE <length>     followed by <length> bytes holding
+ *                                   the text of the include file for a
+ *                                   request with SOURCE, empty otherwise
+ *
+ *              opari2 --client=<socket> sends its remaining arguments
+ *              as such a request and prints the reply, so a compiler
+ *              wrapper can call it instead of the opari2 command, e.g.
+ *
+ *                opari2 --server=/tmp/opari2.sock &
+ *                opari2 --client=/tmp/opari2.sock --nosrc foo.c foo.mod.c
+ */
+
+#ifndef OPARI2_SERVER_H
+#define OPARI2_SERVER_H
+
+#include <string>
+
+/**
+ * @brief Runs the opari2 command, implemented in opari2.cc.
+ *
+ * @param argc    Number of arguments, including the program name.
+ * @param argv    Command line arguments.
+ * @param source  Text of the input file, or NULL to read the input
+ *                file from disk.
+ * @param include Receives the text of the include file, which is then
+ *                not written, or NULL to write the include file.
+ *
+ * @return The exit status of the command.
+ */
+int
+run_command( int                argc,
+             char*              argv[],
+             const std::string* source,
+             std::string*       include );
+
+/**
+ * @brief Serves instrumentation requests until SIGINT or SIGTERM.
+ *
+ * Handles the options --server=<socket> and --server-jobs=<n>. Each
+ * request is run by run_command() in a process forked from the server,
+ * so requests neither share nor leak the global state of libopari2. At
+ * most <n> requests are handled at once, by default as many as there
+ * are online processors.
+ *
+ * @return The exit status of the server.
+ */
+int
+run_server( int   argc,
+            char* argv[] );
+
+/**
+ * @brief Sends an instrumentation request to a server.
+ *
+ * Handles --client=<socket> as the first argument and sends the
+ * remaining arguments and the working directory to the server. If the
+ * output file is "-", the input file is sent as SOURCE and the include
+ * file received is written into the working directory. Prints the
+ * output and error messages of the request.
+ *
+ * @return The exit status of the request.
+ */
+int
+run_client( int   argc,
+            char* argv[] );
+
+#endif /* OPARI2_SERVER_H */
@@ -41,12 +41,40 @@ enum OPARI2_OmpGroup
     G_OMP_TASK     = 0x00000040,
     G_OMP_ORDERED  = 0x00000080,
     G_OMP_SYNC     = 0x000000FF,
+    G_OMP_API      = 0x00000100,
     G_OMP_DEFAULT  = 0x00001000,
     G_OMP_OMP      = 0x0000FFFF,
     G_OMP_REGION   = 0x00010000,
     G_OMP_ALL      = 0xFFFFFFFF
 };
 
+/** OpenMP clauses recorded by OPARI2. They are sorted by name, which
+ *  is the order they appear in on the CTC string. */
+enum OPARI2_OmpClause
+{
+    C_OMP_COLLAPSE = 0,
+    C_OMP_COPYIN,
+    C_OMP_COPYPRIVATE,
+    C_OMP_DEFAULT,
+    C_OMP_DEPEND,
+    C_OMP_FIRSTPRIVATE,
+    C_OMP_IF,
+    C_OMP_LASTPRIVATE,
+    C_OMP_NOWAIT,
+    C_OMP_NUM_THREADS,
+    C_OMP_ORDERED,
+    C_OMP_PRIVATE,
+    C_OMP_PROC_BIND,
+    C_OMP_REDUCTION,
+    C_OMP_SCHEDULE,
+    C_OMP_SHARED,
+    C_OMP_UNTIED,
+    C_OMP_NUM_CLAUSES
+};
+
+/** Bit of a clause in a set of clauses */
+#define C_OMP_BIT( clause ) ( ( uint32_t )1 << ( clause ) )
+
 #define OPARI2_OPENMP_SENTINELS \
     { "!$omp", OPARI2_PT_OMP }, \
     { "c$omp", OPARI2_PT_OMP }, \
@@ -82,16 +110,35 @@ enum OPARI2_OmpGroup
         OPARI2_CREATE_OPENMP_TABLE_ENTRY( parallelworkshare,   false, true,  3.0, G_OMP_DEFAULT ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY( ordered,             false, true,  3.0, G_OMP_ORDERED ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY( task,                false, true,  3.0, G_OMP_TASK ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( simd,                true,  true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( forsimd,             true,  true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( dosimd,              true,  true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( parallelforsimd,     true,  true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( paralleldosimd,      true,  true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( target,              false, true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( teams,               false, true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( distribute,          true,  true,  4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( taskloop,            true,  true,  4.5, G_OMP_TASK ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY( taskgroup,           false, true,  4.0, G_OMP_TASK ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY_SINGLE_STATEMENT( atomic, 3.0, G_OMP_ATOMIC ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( barrier,       false, 3.0, G_OMP_DEFAULT ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( flush,         false, 3.0, G_OMP_FLUSH ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( taskwait,      false, 3.0, G_OMP_TASK ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( taskyield,     false, 3.1, G_OMP_TASK ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( cancel,        false, 4.0, G_OMP_DEFAULT ), \
+        OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( cancellationpoint, false, 4.0, G_OMP_DEFAULT ), \
         OPARI2_CREATE_OPENMP_TABLE_ENTRY_NOEND( threadprivate, false, 3.0, G_OMP_DEFAULT )
 /* *INDENT-ON* */
 
 #define OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( name, version, group, wrapper ) \
     { OPARI2_PT_OMP, #name, #version, group, true, #wrapper, "omp.h", "omp_lib.h" }
 
+/** Runtime API entry that is replaced in C/C++ only, e.g., because
+    the Fortran binding is a bind(C) function without a Fortran
+    wrapper in the measurement library. */
+#define OPARI2_CREATE_OPENMP_API_TABLE_ENTRY_C( name, version, group, wrapper ) \
+    { OPARI2_PT_OMP, #name, #version, group, true, #wrapper, "omp.h", "" }
+
 #define OPARI2_OPENMP_API_ENTRIES \
     OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_init_lock,         3.0, G_OMP_LOCKS, POMP2_Init_lock ), \
     OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_destroy_lock,      3.0, G_OMP_LOCKS, POMP2_Destroy_lock ), \
@@ -102,5 +149,12 @@ enum OPARI2_OmpGroup
     OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_destroy_nest_lock, 3.0, G_OMP_LOCKS, POMP2_Destroy_nest_lock ), \
     OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_set_nest_lock,     3.0, G_OMP_LOCKS, POMP2_Set_nest_lock ), \
     OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_unset_nest_lock,   3.0, G_OMP_LOCKS, POMP2_Unset_nest_lock ), \
-    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_test_nest_lock,    3.0, G_OMP_LOCKS, POMP2_Test_nest_lock )
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_test_nest_lock,    3.0, G_OMP_LOCKS, POMP2_Test_nest_lock ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_init_lock_with_hint,      4.5, G_OMP_LOCKS, POMP2_Init_lock_with_hint ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_init_nest_lock_with_hint, 4.5, G_OMP_LOCKS, POMP2_Init_nest_lock_with_hint ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY( omp_set_num_threads,   3.0, G_OMP_API,   POMP2_Set_num_threads ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY_C( omp_get_wtime,       3.0, G_OMP_API,   POMP2_Get_wtime ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY_C( omp_target_memcpy,   4.5, G_OMP_API,   POMP2_Target_memcpy ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY_C( omp_alloc,           5.0, G_OMP_API,   POMP2_Alloc ), \
+    OPARI2_CREATE_OPENMP_API_TABLE_ENTRY_C( omp_free,            5.0, G_OMP_API,   POMP2_Free )
 #endif
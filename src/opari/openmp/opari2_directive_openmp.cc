@@ -56,17 +56,137 @@ using std::string;
 #include "opari2_directive_entry_openmp.h"
 #include "opari2_directive_manager.h"
 
+using namespace opari2;
+
 
 #define MAKE_STR( x ) MAKE_STR_( x )
 #define MAKE_STR_( x ) #x
 
+/** Names of the clauses, indexed by OPARI2_OmpClause */
+static const char* const clause_names[ C_OMP_NUM_CLAUSES ] =
+{
+    "collapse",
+    "copyin",
+    "copyprivate",
+    "default",
+    "depend",
+    "firstprivate",
+    "if",
+    "lastprivate",
+    "nowait",
+    "num_threads",
+    "ordered",
+    "private",
+    "proc_bind",
+    "reduction",
+    "schedule",
+    "shared",
+    "untied"
+};
+
+#define C_OMP_PARALLEL_CLAUSES                                     \
+    ( C_OMP_BIT( C_OMP_IF ) | C_OMP_BIT( C_OMP_NUM_THREADS ) |      \
+      C_OMP_BIT( C_OMP_DEFAULT ) | C_OMP_BIT( C_OMP_PRIVATE ) |     \
+      C_OMP_BIT( C_OMP_FIRSTPRIVATE ) | C_OMP_BIT( C_OMP_SHARED ) | \
+      C_OMP_BIT( C_OMP_COPYIN ) | C_OMP_BIT( C_OMP_REDUCTION ) |    \
+      C_OMP_BIT( C_OMP_PROC_BIND ) )
+
+#define C_OMP_DO_CLAUSES                                                \
+    ( C_OMP_BIT( C_OMP_PRIVATE ) | C_OMP_BIT( C_OMP_FIRSTPRIVATE ) |     \
+      C_OMP_BIT( C_OMP_LASTPRIVATE ) | C_OMP_BIT( C_OMP_REDUCTION ) |    \
+      C_OMP_BIT( C_OMP_SCHEDULE ) | C_OMP_BIT( C_OMP_COLLAPSE ) |        \
+      C_OMP_BIT( C_OMP_ORDERED ) )
+
+#define C_OMP_FOR_CLAUSES ( C_OMP_DO_CLAUSES | C_OMP_BIT( C_OMP_NOWAIT ) )
+
+#define C_OMP_SECTIONS_CLAUSES                                          \
+    ( C_OMP_BIT( C_OMP_PRIVATE ) | C_OMP_BIT( C_OMP_FIRSTPRIVATE ) |     \
+      C_OMP_BIT( C_OMP_LASTPRIVATE ) | C_OMP_BIT( C_OMP_REDUCTION ) |    \
+      C_OMP_BIT( C_OMP_NOWAIT ) )
+
+/** @brief Set of clauses OPARI2 records for a directive */
+typedef struct
+{
+    const char* name;
+    uint32_t    clauses;
+} OPARI2_OmpDirectiveClauses_t;
+
+/**
+ *  @brief Clauses OPARI2 records per directive.
+ *
+ *  Only clauses known to the CTC string parser of the runtime library
+ *  are listed for the OpenMP 4.x constructs; safelen, simdlen,
+ *  linear, aligned, device, map, num_teams, thread_limit,
+ *  dist_schedule, grainsize and num_tasks are left in place without
+ *  being recorded. The if clause stays on these constructs, as it is
+ *  only replaced for parallel and task. The construct type of cancel
+ *  and cancellation point is stored by FindName, the if clause of
+ *  cancel is kept on the directive.
+ */
+static const OPARI2_OmpDirectiveClauses_t directive_clauses[] =
+{
+    { "parallel",          C_OMP_PARALLEL_CLAUSES                           },
+    { "for",               C_OMP_FOR_CLAUSES                                },
+    { "do",                C_OMP_DO_CLAUSES                                 },
+    { "sections",          C_OMP_SECTIONS_CLAUSES                           },
+    { "single",            C_OMP_BIT( C_OMP_PRIVATE ) | C_OMP_BIT( C_OMP_FIRSTPRIVATE ) |
+      C_OMP_BIT( C_OMP_COPYPRIVATE ) | C_OMP_BIT( C_OMP_NOWAIT )           },
+    { "endsingle",         C_OMP_BIT( C_OMP_NOWAIT ) | C_OMP_BIT( C_OMP_COPYPRIVATE ) },
+    { "enddo",             C_OMP_BIT( C_OMP_NOWAIT )                        },
+    { "endsections",       C_OMP_BIT( C_OMP_NOWAIT )                        },
+    { "endworkshare",      C_OMP_BIT( C_OMP_NOWAIT )                        },
+    { "task",              C_OMP_BIT( C_OMP_IF ) | C_OMP_BIT( C_OMP_UNTIED ) |
+      C_OMP_BIT( C_OMP_DEFAULT ) | C_OMP_BIT( C_OMP_PRIVATE ) |
+      C_OMP_BIT( C_OMP_FIRSTPRIVATE ) | C_OMP_BIT( C_OMP_SHARED ) |
+      C_OMP_BIT( C_OMP_DEPEND )                                             },
+    { "parallelfor",       C_OMP_PARALLEL_CLAUSES | C_OMP_FOR_CLAUSES       },
+    { "paralleldo",        C_OMP_PARALLEL_CLAUSES | C_OMP_DO_CLAUSES        },
+    { "parallelsections",  C_OMP_PARALLEL_CLAUSES | C_OMP_SECTIONS_CLAUSES  },
+    { "parallelworkshare", C_OMP_PARALLEL_CLAUSES                           },
+    { "simd",              C_OMP_BIT( C_OMP_PRIVATE ) | C_OMP_BIT( C_OMP_LASTPRIVATE ) |
+      C_OMP_BIT( C_OMP_REDUCTION ) | C_OMP_BIT( C_OMP_COLLAPSE )           },
+    { "forsimd",           C_OMP_FOR_CLAUSES                                },
+    { "dosimd",            C_OMP_DO_CLAUSES                                 },
+    { "parallelforsimd",   C_OMP_PARALLEL_CLAUSES | C_OMP_FOR_CLAUSES       },
+    { "paralleldosimd",    C_OMP_PARALLEL_CLAUSES | C_OMP_DO_CLAUSES        },
+    { "enddosimd",         C_OMP_BIT( C_OMP_NOWAIT )                        },
+    { "taskloop",          C_OMP_BIT( C_OMP_DEFAULT ) | C_OMP_BIT( C_OMP_PRIVATE ) |
+      C_OMP_BIT( C_OMP_FIRSTPRIVATE ) | C_OMP_BIT( C_OMP_LASTPRIVATE ) |
+      C_OMP_BIT( C_OMP_SHARED ) | C_OMP_BIT( C_OMP_REDUCTION ) |
+      C_OMP_BIT( C_OMP_COLLAPSE )                                           },
+    { "target",            C_OMP_BIT( C_OMP_PRIVATE ) | C_OMP_BIT( C_OMP_FIRSTPRIVATE ) |
+      C_OMP_BIT( C_OMP_NOWAIT )                                             },
+    { "teams",             C_OMP_BIT( C_OMP_DEFAULT ) | C_OMP_BIT( C_OMP_PRIVATE ) |
+      C_OMP_BIT( C_OMP_FIRSTPRIVATE ) | C_OMP_BIT( C_OMP_SHARED ) |
+      C_OMP_BIT( C_OMP_REDUCTION )                                          },
+    { "distribute",        C_OMP_BIT( C_OMP_PRIVATE ) | C_OMP_BIT( C_OMP_FIRSTPRIVATE ) |
+      C_OMP_BIT( C_OMP_LASTPRIVATE ) | C_OMP_BIT( C_OMP_COLLAPSE )         },
+    { "cancel",            C_OMP_BIT( C_OMP_IF )                            }
+};
+
+/** @brief Returns the set of clauses recorded for a directive */
+static uint32_t
+get_directive_clauses( const string& name )
+{
+    int n = sizeof( directive_clauses ) / sizeof( OPARI2_OmpDirectiveClauses_t );
+
+    for ( int i = 0; i < n; i++ )
+    {
+        if ( name == directive_clauses[ i ].name )
+        {
+            return directive_clauses[ i ].clauses;
+        }
+    }
+    return 0;
+}
+
 typedef struct
 {
     uint32_t     mEnum;
     const string mGroupName;
 } OPARI2_OpenMPGroupStringMapEntry;
 
-OPARI2_OpenMPGroupStringMapEntry ompGroupStringMap[] =
+static OPARI2_OpenMPGroupStringMapEntry ompGroupStringMap[] =
 {
     { G_OMP_ATOMIC,   "atomic"    },
     { G_OMP_CRITICAL, "critical"  },
@@ -76,6 +196,7 @@ OPARI2_OpenMPGroupStringMapEntry ompGroupStringMap[] =
     { G_OMP_FLUSH,    "flush"     },
     { G_OMP_TASK,     "tasks"     },
     { G_OMP_SYNC,     "sync"      },
+    { G_OMP_API,      "api"       },
     { G_OMP_OMP,      "omp"       },
     { G_OMP_ALL,      "all"       },
 };
@@ -99,6 +220,46 @@ OPARI2_DirectiveOpenmp::ProcessOption( string option )
         {
             s_omp_opt.copytpd = true;
         }
+        else if ( option == "--omp-ctc-at-init" )
+        {
+            s_omp_opt.ctc_at_init = true;
+        }
+        else if ( option == "--omp-barrier-timestamp" )
+        {
+            s_omp_opt.barrier_timestamp = true;
+        }
+        else if ( option.find( "--omp-barrier-timestamp=" ) == 0 )
+        {
+            string constructs = option.substr( option.find( "=" ) + 1 );
+            if ( constructs == "" )
+            {
+                cerr << "ERROR: missing value for option --omp-barrier-timestamp\n";
+                err_flag = OPARI2_ERROR_WITH_MESSAGE;
+            }
+            s_omp_opt.barrier_timestamp = true;
+            string::size_type p1 = 0;
+            while ( p1 < constructs.length() )
+            {
+                string::size_type p2 = constructs.find( ",", p1 );
+                if ( p2 == string::npos )
+                {
+                    p2 = constructs.length();
+                }
+                string token = constructs.substr( p1, p2 - p1 );
+                if ( token == "for"      || token == "do"     ||
+                     token == "sections" || token == "single" ||
+                     token == "workshare" || token == "parallel" )
+                {
+                    s_omp_opt.barrier_timestamp_constructs.push_back( token );
+                }
+                else
+                {
+                    cerr << "ERROR: unknown construct \"" << token << "\" for --omp-barrier-timestamp\n";
+                    err_flag = OPARI2_ERROR_WITH_MESSAGE;
+                }
+                p1 = p2 + 1;
+            }
+        }
         else if ( option.find( "--omp-tpd-mangling=" ) != string::npos )
         {
             size_t p1      = option.find( "=" );
@@ -266,9 +427,10 @@ OPARI2_DirectiveOpenmp::FindName( void )
 {
     find_name_common();
 
+    string w;
     if ( m_name == "parallel"  || m_name == "endparallel" )
     {
-        string w = find_next_word();
+        w = find_next_word();
         if ( w == "do"  || w == "sections" ||
              w == "for" || w == "workshare" /*2.0*/ )
         {
@@ -277,7 +439,7 @@ OPARI2_DirectiveOpenmp::FindName( void )
     }
     else if ( m_name == "end" )
     {
-        string w = find_next_word();
+        w       = find_next_word();
         m_name += w;
         if ( w == "parallel" )
         {
@@ -289,6 +451,36 @@ OPARI2_DirectiveOpenmp::FindName( void )
             }
         }
     }
+    else
+    {
+        w = m_name;
+    }
+
+    /* worksharing-loop SIMD constructs (4.0) */
+    if ( w == "do" || w == "for" )
+    {
+        if ( find_next_word() == "simd" )
+        {
+            m_name += "simd";
+        }
+    }
+    /* constructs whose combined forms are not split (4.0), only the
+       name of the outermost construct is used */
+    else if ( w == "target" || w == "teams" ||
+              w == "distribute" || w == "taskloop" )
+    {
+        find_combined( w );
+    }
+    /* cancel and cancellation point directives (4.0) store the type
+       of the construct to be cancelled */
+    else if ( w == "cancel" || w == "cancellation" )
+    {
+        if ( w == "cancellation" && find_next_word() == "point" )
+        {
+            m_name += "point";
+        }
+        m_cancel_construct = find_next_word();
+    }
 
     if ( m_name == "critical" ||
          m_name == "endcritical" )
@@ -303,22 +495,140 @@ OPARI2_DirectiveOpenmp::FindName( void )
     identify_clauses();
 }
 
+/**
+ * @brief Collects the constructs combined with a target, teams,
+ *        distribute or taskloop construct.
+ *
+ * The stand-alone target data, enter data, exit data and update
+ * directives get their own names, so they are not mistaken for a
+ * target construct.
+ */
+void
+OPARI2_DirectiveOpenmp::find_combined( const string& first )
+{
+    string w = find_next_word();
+
+    if ( first == "target" &&
+         ( w == "data" || w == "update" || w == "enter" || w == "exit" ) )
+    {
+        m_name += w;
+        return;
+    }
+
+    while ( w == "teams" || w == "distribute" || w == "parallel" ||
+            w == "for"   || w == "do"         || w == "simd" )
+    {
+        m_combined += " " + w;
+        w           = find_next_word();
+    }
+
+    m_combined_loop = first == "distribute" || first == "taskloop" ||
+                      m_combined.find( "distribute" ) != string::npos ||
+                      m_combined.find( " for" ) != string::npos ||
+                      m_combined.find( " do" ) != string::npos ||
+                      m_combined.find( "simd" ) != string::npos;
+
+    /* Combined forms of target and teams that are associated with a
+       loop need to be ended with the loop like loop constructs. */
+    if ( m_name == first && m_combined_loop )
+    {
+        NeedsEndLoopDirective( true );
+    }
+}
+
 void
 OPARI2_DirectiveOpenmp::identify_clauses( void )
 {
-    for ( vector<string>::iterator it = s_directive_clauses[ m_name ].begin(); it != s_directive_clauses[ m_name ].end(); ++it )
+    uint32_t clauses = get_directive_clauses( m_name );
+
+    for ( int c = 0; c < C_OMP_NUM_CLAUSES; ++c )
     {
         unsigned          line = 0;
         string::size_type pos  = 0;
+        const string      name = clause_names[ c ];
+
+        if ( ( clauses & C_OMP_BIT( c ) ) && find_word( name, line, pos ) )
+        {
+            bool remove = ( ( c == C_OMP_IF && !IsCancelDirective() ) ||
+                            c == C_OMP_NUM_THREADS                  ||
+                            ( c == C_OMP_UNTIED && !s_omp_opt.untied_keep ) );
+            string arguments = find_arguments( line, pos, remove, name );
+
+            /* A task may have several depend clauses, the argument
+               of the last one is kept */
+            while ( c == C_OMP_DEPEND )
+            {
+                m_num_depend += count_depend_items( arguments );
+                if ( !find_word( name, line, pos ) )
+                {
+                    break;
+                }
+                arguments = find_arguments( line, pos, remove, name );
+            }
+
+            m_clause_set                  |= C_OMP_BIT( c );
+            m_clause_arg_spans[ c ].first  = m_clause_args.length();
+            m_clause_arg_spans[ c ].second = arguments.length();
+            m_clause_args                 += arguments;
+        }
+    }
+}
+
+bool
+OPARI2_DirectiveOpenmp::HasClause( OPARI2_OmpClause clause )
+{
+    return ( m_clause_set & C_OMP_BIT( clause ) ) != 0;
+}
+
+string
+OPARI2_DirectiveOpenmp::GetClauseArg( OPARI2_OmpClause clause )
+{
+    if ( !HasClause( clause ) )
+    {
+        return "";
+    }
+    return m_clause_args.substr( m_clause_arg_spans[ clause ].first,
+                                 m_clause_arg_spans[ clause ].second );
+}
+
+/**
+ * @brief Counts the list items of the argument of a depend clause,
+ *        e.g. "in:a,b[0:n]" has two items.
+ *
+ * The items follow the last colon outside of brackets and
+ * parentheses, which separates them from the dependence type and an
+ * optional iterator modifier.
+ */
+int
+OPARI2_DirectiveOpenmp::count_depend_items( const string& arguments )
+{
+    int               level = 0;
+    int               items = 1;
+    string::size_type start = 0;
 
-        if ( find_word( *it, line, pos ) )
+    for ( string::size_type i = 0; i < arguments.length(); ++i )
+    {
+        char c = arguments[ i ];
+        if ( c == '(' || c == '[' )
+        {
+            level++;
+        }
+        else if ( c == ')' || c == ']' )
+        {
+            level--;
+        }
+        else if ( level == 0 && c == ':' )
+        {
+            items = 1;
+            start = i + 1;
+        }
+        else if ( level == 0 && c == ',' )
         {
-            bool remove = ( *it == "if"          ||
-                            *it == "num_threads" ||
-                            ( *it == "untied" && !s_omp_opt.untied_keep ) );
-            m_clauses[ *it ] = find_arguments( line, pos, remove, *it );
+            items++;
         }
     }
+
+    return start < arguments.length() ? items : 0;
 }
 
 string
@@ -339,30 +649,40 @@ OPARI2_DirectiveOpenmp::generate_ctc_string( OPARI2_Format_t form )
     {
         s << "numSections=" << m_num_sections << "*";
     }
+    else if ( m_name == "task" && m_num_depend > 0 )
+    {
+        s << "numDepend=" << m_num_depend << "*";
+    }
+    else if ( IsCancelDirective() && !m_cancel_construct.empty() )
+    {
+        s << "cancelConstruct=" << m_cancel_construct << "*";
+    }
 
-    for ( OPARI2_StrStr_map_t::iterator it = m_clauses.begin(); it != m_clauses.end(); ++it )
+    for ( int c = 0; c < C_OMP_NUM_CLAUSES; ++c )
     {
         /** Clauses not to appear on CTC-string */
-        if ( ( *it ).first != "private"      &&
-             ( *it ).first != "lastprivate"  &&
-             ( *it ).first != "firstprivate" &&
-             ( *it ).first != "copyin"       &&
-             ( ( *it ).first != "default" || ChangedDefault() ) )
+        if ( HasClause( ( OPARI2_OmpClause )c ) &&
+             c != C_OMP_PRIVATE                   &&
+             c != C_OMP_LASTPRIVATE               &&
+             c != C_OMP_FIRSTPRIVATE              &&
+             c != C_OMP_COPYIN                    &&
+             ( c != C_OMP_DEFAULT || ChangedDefault() ) )
         {
-            string name = ( *it ).first;
+            string name = clause_names[ c ];
             name[ 0 ] = toupper( name[ 0 ] );
             s << "has" << name << "=";
             /** Clauses for which the argument is put on the
                 CTC-string */
-            if ( ( *it ).first == "schedule"    ||
-                 ( *it ).first == "default" )
+            if ( c == C_OMP_SCHEDULE ||
+                 c == C_OMP_DEFAULT )
             {
+                string arguments = GetClauseArg( ( OPARI2_OmpClause )c );
                 /*replace * with @ in the CTC String to distinguish it from the CTC String delimited '*' */
-                while ( ( *it ).second.find( '*' ) != string::npos )
+                while ( arguments.find( '*' ) != string::npos )
                 {
-                    ( *it ).second.replace( ( *it ).second.find( '*' ), 1, "@" );
+                    arguments.replace( arguments.find( '*' ), 1, "@" );
                 }
-                s << ( *it ).second << "*";
+                s << arguments << "*";
             }
             else
             {
@@ -381,14 +701,15 @@ OPARI2_DirectiveOpenmp::generate_ctc_string( OPARI2_Format_t form )
 bool
 OPARI2_DirectiveOpenmp::ChangedDefault( void )
 {
-    if ( m_clauses.find( "default" ) == m_clauses.end() )
+    if ( !HasClause( C_OMP_DEFAULT ) )
     {
         return false;
     }
     else
     {
-        return m_clauses[ "default" ] == "none" ||
-               m_clauses[ "default" ] == "private";
+        string arguments = GetClauseArg( C_OMP_DEFAULT );
+        return arguments == "none" ||
+               arguments == "private";
     }
 }
 
@@ -425,6 +746,20 @@ OPARI2_DirectiveOpenmp::GetNumSections( void )
 }
 
 
+bool
+OPARI2_DirectiveOpenmp::IsCancelDirective( void )
+{
+    return m_name == "cancel" || m_name == "cancellationpoint";
+}
+
+
+string&
+OPARI2_DirectiveOpenmp::GetCancelConstruct( void )
+{
+    return m_cancel_construct;
+}
+
+
 bool
 OPARI2_DirectiveOpenmp::IsNowaitAdded( void )
 {
@@ -544,6 +879,14 @@ OPARI2_DirectiveOpenmp::GenerateInitHandleCalls( ostream&     os,
     return;
 }
 
+void
+OPARI2_DirectiveOpenmp::ResetRegions( void )
+{
+    s_init_handle_calls.str( "" );
+    s_init_handle_calls.clear();
+    s_num_regions = 0;
+}
+
 
 /** @brief add a nowait to a pragma */
 void
@@ -611,24 +954,182 @@ OPARI2_DirectiveOpenmp::AddDescr( int id )
 OPARI2_DirectiveOpenmp*
 OPARI2_DirectiveOpenmp::SplitCombined( void )
 {
+    if ( m_name == "parallelforsimd" || m_name == "paralleldosimd" )
+    {
+        return SplitCombinedT<OPARI2_DirectiveOpenmp>( s_outer_inner, s_inner_clauses_simd );
+    }
     return SplitCombinedT<OPARI2_DirectiveOpenmp>( s_outer_inner, s_inner_clauses );
 }
 
 
+/** @brief Functions of the POMP2 library called by instrumented
+    Fortran code, see --fortran-bind-c */
+static const OPARI2_BindCInterface bind_c_functions[] =
+{
+    { "POMP2_Lib_get_max_threads",        "POMP2_Lib_get_max_threads",        "",   "integer( c_int )" },
+    { "POMP2_Assign_handle",              "POMP2_Assign_handle",              "rc", NULL               }
+};
+
+/** @brief Events without CTC string, called in both modes of
+    --omp-ctc-at-init */
+static const OPARI2_BindCInterface bind_c_events[] =
+{
+    { "POMP2_Atomic_exit",                "POMP2_Atomic_exit",                "r",  NULL },
+    { "POMP2_Implicit_barrier_enter",     "POMP2_Implicit_barrier_enter",     "rt", NULL },
+    { "POMP2_Implicit_barrier_exit",      "POMP2_Implicit_barrier_exit",      "rT", NULL },
+    { "POMP2_Implicit_barrier_arrive",    "POMP2_Implicit_barrier_arrive",    "r",  NULL },
+    { "POMP2_Barrier_exit",               "POMP2_Barrier_exit",               "rT", NULL },
+    { "POMP2_Flush_exit",                 "POMP2_Flush_exit",                 "r",  NULL },
+    { "POMP2_Critical_begin",             "POMP2_Critical_begin",             "r",  NULL },
+    { "POMP2_Critical_end",               "POMP2_Critical_end",               "r",  NULL },
+    { "POMP2_Critical_exit",              "POMP2_Critical_exit",              "r",  NULL },
+    { "POMP2_Do_exit",                    "POMP2_For_exit",                   "r",  NULL },
+    { "POMP2_Master_end",                 "POMP2_Master_end",                 "r",  NULL },
+    { "POMP2_Parallel_begin",             "POMP2_Parallel_begin",             "r",  NULL },
+    { "POMP2_Parallel_end",               "POMP2_Parallel_end",               "r",  NULL },
+    { "POMP2_Parallel_join",              "POMP2_Parallel_join",              "rT", NULL },
+    { "POMP2_Section_end",                "POMP2_Section_end",                "r",  NULL },
+    { "POMP2_Sections_exit",              "POMP2_Sections_exit",              "r",  NULL },
+    { "POMP2_Single_begin",               "POMP2_Single_begin",               "r",  NULL },
+    { "POMP2_Single_end",                 "POMP2_Single_end",                 "r",  NULL },
+    { "POMP2_Single_exit",                "POMP2_Single_exit",                "r",  NULL },
+    { "POMP2_Workshare_exit",             "POMP2_Workshare_exit",             "r",  NULL },
+    { "POMP2_Ordered_begin",              "POMP2_Ordered_begin",              "r",  NULL },
+    { "POMP2_Ordered_end",                "POMP2_Ordered_end",                "r",  NULL },
+    { "POMP2_Ordered_exit",               "POMP2_Ordered_exit",               "r",  NULL },
+    { "POMP2_Task_create_end",            "POMP2_Task_create_end",            "rT", NULL },
+    { "POMP2_Task_begin",                 "POMP2_Task_begin",                 "rT", NULL },
+    { "POMP2_Task_end",                   "POMP2_Task_end",                   "r",  NULL },
+    { "POMP2_Untied_task_create_end",     "POMP2_Untied_task_create_end",     "rT", NULL },
+    { "POMP2_Untied_task_begin",          "POMP2_Untied_task_begin",          "rT", NULL },
+    { "POMP2_Untied_task_end",            "POMP2_Untied_task_end",            "r",  NULL },
+    { "POMP2_Taskwait_end",               "POMP2_Taskwait_end",               "rT", NULL },
+    { "POMP2_Taskloop_exit",              "POMP2_Taskloop_exit",              "r",  NULL },
+    { "POMP2_Simd_exit",                  "POMP2_Simd_exit",                  "r",  NULL },
+    { "POMP2_Teams_exit",                 "POMP2_Teams_exit",                 "r",  NULL },
+    { "POMP2_Distribute_exit",            "POMP2_Distribute_exit",            "r",  NULL },
+    { "POMP2_Target_exit",                "POMP2_Target_exit",                "r",  NULL },
+    { "POMP2_Taskgroup_begin",            "POMP2_Taskgroup_begin",            "r",  NULL },
+    { "POMP2_Taskgroup_end",              "POMP2_Taskgroup_end",              "r",  NULL },
+    { "POMP2_Taskgroup_exit",             "POMP2_Taskgroup_exit",             "rT", NULL },
+    { "POMP2_Taskyield_end",              "POMP2_Taskyield_end",              "rT", NULL }
+};
+
+/** @brief Events that are passed the CTC string */
+static const OPARI2_BindCInterface bind_c_events_ctc[] =
+{
+    { "POMP2_Atomic_enter",               "POMP2_Atomic_enter",               "rc",    NULL },
+    { "POMP2_Barrier_enter",              "POMP2_Barrier_enter",              "rtc",   NULL },
+    { "POMP2_Flush_enter",                "POMP2_Flush_enter",                "rc",    NULL },
+    { "POMP2_Critical_enter",             "POMP2_Critical_enter",             "rc",    NULL },
+    { "POMP2_Do_enter",                   "POMP2_For_enter",                  "rc",    NULL },
+    { "POMP2_Master_begin",               "POMP2_Master_begin",               "rc",    NULL },
+    { "POMP2_Parallel_fork",              "POMP2_Parallel_fork",              "riitc", NULL },
+    { "POMP2_Section_begin",              "POMP2_Section_begin",              "rc",    NULL },
+    { "POMP2_Sections_enter",             "POMP2_Sections_enter",             "rc",    NULL },
+    { "POMP2_Single_enter",               "POMP2_Single_enter",               "rc",    NULL },
+    { "POMP2_Workshare_enter",            "POMP2_Workshare_enter",            "rc",    NULL },
+    { "POMP2_Ordered_enter",              "POMP2_Ordered_enter",              "rc",    NULL },
+    { "POMP2_Task_create_begin",          "POMP2_Task_create_begin",          "rttic", NULL },
+    { "POMP2_Untied_task_create_begin",   "POMP2_Untied_task_create_begin",   "rttic", NULL },
+    { "POMP2_Taskwait_begin",             "POMP2_Taskwait_begin",             "rtc",   NULL },
+    { "POMP2_Taskloop_enter",             "POMP2_Taskloop_enter",             "rc",    NULL },
+    { "POMP2_Simd_enter",                 "POMP2_Simd_enter",                 "rc",    NULL },
+    { "POMP2_Teams_enter",                "POMP2_Teams_enter",                "rc",    NULL },
+    { "POMP2_Distribute_enter",           "POMP2_Distribute_enter",           "rc",    NULL },
+    { "POMP2_Target_enter",               "POMP2_Target_enter",               "rc",    NULL },
+    { "POMP2_Taskgroup_enter",            "POMP2_Taskgroup_enter",            "rtc",   NULL },
+    { "POMP2_Taskyield_begin",            "POMP2_Taskyield_begin",            "rtc",   NULL },
+    { "POMP2_Cancel_request",             "POMP2_Cancel_request",             "rc",    NULL },
+    { "POMP2_Cancellation_point_check",   "POMP2_Cancellation_point_check",   "rc",    NULL }
+};
+
+/** @brief Events without CTC string for --omp-ctc-at-init */
+static const OPARI2_BindCInterface bind_c_events_no_ctc[] =
+{
+    { "POMP2_Atomic_enter_no_ctc",             "POMP2_Atomic_enter_no_ctc",             "r",    NULL },
+    { "POMP2_Barrier_enter_no_ctc",            "POMP2_Barrier_enter_no_ctc",            "rt",   NULL },
+    { "POMP2_Flush_enter_no_ctc",              "POMP2_Flush_enter_no_ctc",              "r",    NULL },
+    { "POMP2_Critical_enter_no_ctc",           "POMP2_Critical_enter_no_ctc",           "r",    NULL },
+    { "POMP2_Do_enter_no_ctc",                 "POMP2_For_enter_no_ctc",                "r",    NULL },
+    { "POMP2_Master_begin_no_ctc",             "POMP2_Master_begin_no_ctc",             "r",    NULL },
+    { "POMP2_Parallel_fork_no_ctc",            "POMP2_Parallel_fork_no_ctc",            "riit", NULL },
+    { "POMP2_Section_begin_no_ctc",            "POMP2_Section_begin_no_ctc",            "r",    NULL },
+    { "POMP2_Sections_enter_no_ctc",           "POMP2_Sections_enter_no_ctc",           "r",    NULL },
+    { "POMP2_Single_enter_no_ctc",             "POMP2_Single_enter_no_ctc",             "r",    NULL },
+    { "POMP2_Workshare_enter_no_ctc",          "POMP2_Workshare_enter_no_ctc",          "r",    NULL },
+    { "POMP2_Ordered_enter_no_ctc",            "POMP2_Ordered_enter_no_ctc",            "r",    NULL },
+    { "POMP2_Task_create_begin_no_ctc",        "POMP2_Task_create_begin_no_ctc",        "rtti", NULL },
+    { "POMP2_Untied_task_create_begin_no_ctc", "POMP2_Untied_task_create_begin_no_ctc", "rtti", NULL },
+    { "POMP2_Taskwait_begin_no_ctc",           "POMP2_Taskwait_begin_no_ctc",           "rt",   NULL },
+    { "POMP2_Taskloop_enter_no_ctc",           "POMP2_Taskloop_enter_no_ctc",           "r",    NULL },
+    { "POMP2_Simd_enter_no_ctc",               "POMP2_Simd_enter_no_ctc",               "r",    NULL },
+    { "POMP2_Teams_enter_no_ctc",              "POMP2_Teams_enter_no_ctc",              "r",    NULL },
+    { "POMP2_Distribute_enter_no_ctc",         "POMP2_Distribute_enter_no_ctc",         "r",    NULL },
+    { "POMP2_Target_enter_no_ctc",             "POMP2_Target_enter_no_ctc",             "r",    NULL },
+    { "POMP2_Taskgroup_enter_no_ctc",          "POMP2_Taskgroup_enter_no_ctc",          "rt",   NULL },
+    { "POMP2_Taskyield_begin_no_ctc",          "POMP2_Taskyield_begin_no_ctc",          "rt",   NULL },
+    { "POMP2_Cancel_request_no_ctc",           "POMP2_Cancel_request_no_ctc",           "r",    NULL },
+    { "POMP2_Cancellation_point_check_no_ctc", "POMP2_Cancellation_point_check_no_ctc", "r",    NULL }
+};
+
+#define BIND_C_COUNT( table ) ( sizeof( table ) / sizeof( table[ 0 ] ) )
+
+
 void
 OPARI2_DirectiveOpenmp::FinalizeDescrs( ostream& os )
 {
     if ( s_lang & L_FORTRAN )
     {
-        if ( s_lang & L_F77 )
+        if ( s_bind_c )
+        {
+            /* The POMP2 functions are called directly with the
+               interfaces below, only the lock functions still need
+               the Fortran wrappers. */
+            os << "\n      interface\n";
+            for ( size_t i = 0; i < BIND_C_COUNT( bind_c_functions ); ++i )
+            {
+                generate_bind_c_interface( os, bind_c_functions[ i ] );
+            }
+            if ( !s_common_block.empty() )
+            {
+                for ( size_t i = 0; i < BIND_C_COUNT( bind_c_events ); ++i )
+                {
+                    generate_bind_c_interface( os, bind_c_events[ i ] );
+                }
+                if ( s_omp_opt.ctc_at_init )
+                {
+                    for ( size_t i = 0; i < BIND_C_COUNT( bind_c_events_no_ctc ); ++i )
+                    {
+                        generate_bind_c_interface( os, bind_c_events_no_ctc[ i ] );
+                    }
+                }
+                else
+                {
+                    for ( size_t i = 0; i < BIND_C_COUNT( bind_c_events_ctc ); ++i )
+                    {
+                        generate_bind_c_interface( os, bind_c_events_ctc[ i ] );
+                    }
+                }
+            }
+            os << "      end interface\n";
+        }
+        else if ( s_lang & L_F77 )
         {
             os << "\n      integer*4 pomp2_lib_get_max_threads";
+        }
+        else if ( s_lang & L_F90 )
+        {
+            os << "\n      integer ( kind=4 ) :: pomp2_lib_get_max_threads";
+        }
+
+        if ( s_lang & L_F77 )
+        {
             os << "\n      logical pomp2_test_lock";
             os << "\n      integer*4 pomp2_test_nest_lock\n";
         }
         else if ( s_lang & L_F90 )
         {
-            os << "\n      integer ( kind=4 ) :: pomp2_lib_get_max_threads";
             os << "\n      logical :: pomp2_test_lock";
             os << "\n      integer ( kind=4 ) :: pomp2_test_nest_lock\n";
         }
@@ -672,7 +1173,10 @@ OPARI2_DirectiveOpenmp::EndLoopDirective( const int lineno )
 {
     if ( s_lang & L_FORTRAN )
     {
-        FindName();
+        if ( m_name.empty() )
+        {
+            FindName();
+        }
 
         string pragma = "";
         for ( string::size_type c = 0; c < m_indent; c++ )
@@ -690,6 +1194,18 @@ OPARI2_DirectiveOpenmp::EndLoopDirective( const int lineno )
         {
             pragma += " end parallel do ";
         }
+        else if ( m_name == "dosimd" )
+        {
+            pragma += " end do simd ";
+        }
+        else if ( m_name == "paralleldosimd" )
+        {
+            pragma += " end parallel do simd ";
+        }
+        else
+        {
+            pragma += " end " + m_name + m_combined + " ";
+        }
 
         vector<string> lines;
         lines.push_back( pragma );
@@ -701,7 +1217,7 @@ OPARI2_DirectiveOpenmp::EndLoopDirective( const int lineno )
     return NULL;
 }
 
-/** Returns true for enddo and endparalleldo directives */
+/** Returns true for directives ending a loop construct */
 bool
 OPARI2_DirectiveOpenmp::EndsLoopDirective( void )
 {
@@ -712,7 +1228,10 @@ OPARI2_DirectiveOpenmp::EndsLoopDirective( void )
             FindName();
         }
 
-        if ( m_name == "enddo" || m_name == "endparalleldo" )
+        if ( m_name == "enddo"    || m_name == "endparalleldo"     ||
+             m_name == "enddosimd" || m_name == "endparalleldosimd" ||
+             m_name == "endsimd"   ||
+             ( m_name.compare( 0, 3, "end" ) == 0 && m_combined_loop ) )
         {
             return true;
         }
@@ -730,192 +1249,6 @@ OPARI2_DirectiveOpenmp::EndsLoopDirective( void )
 #define OPARI2_STR_( str ) #str
 #define OPARI2_STR( str ) OPARI2_STR_( str )
 
-/**
- *  @brief Creates pairs of directive keywords that can be combined
- *         and are split by OPARI2.
- *
- *  This function is called during initialiazation of static
- *  variables, so the language is not yet set in s_lang.
- */
-static OPARI2_StrVStr_map_t
-make_directive_clauses( void )
-{
-    OPARI2_StrVStr_map_t dc;
-
-    vector<string> clauses;
-
-    clauses.push_back( "if" );
-    clauses.push_back( "num_threads" );
-    clauses.push_back( "default" );
-    clauses.push_back( "private" );
-    clauses.push_back( "firstprivate" );
-    clauses.push_back( "shared" );
-    clauses.push_back( "copyin" );
-    clauses.push_back( "reduction" );
-    clauses.push_back( "proc_bind" );
-    dc[ "parallel" ] = clauses;
-
-    clauses.clear();
-    clauses.push_back( "private" );
-    clauses.push_back( "firstprivate" );
-    clauses.push_back( "lastprivate" );
-    clauses.push_back( "reduction" );
-    clauses.push_back( "schedule" );
-    clauses.push_back( "collapse" );
-    clauses.push_back( "ordered" );
-    clauses.push_back( "nowait" );
-    dc[ "for" ] = clauses;
-
-    clauses.clear();
-    clauses.push_back( "private" );
-    clauses.push_back( "firstprivate" );
-    clauses.push_back( "astprivate" );
-    clauses.push_back( "reduction" );
-    clauses.push_back( "schedule" );
-    clauses.push_back( "collapse" );
-    clauses.push_back( "ordered" );
-    dc[ "do" ] = clauses;
-
-    clauses.clear();
-    clauses.push_back( "private" );
-    clauses.push_back( "firstprivate" );
-    clauses.push_back( "lastprivate" );
-    clauses.push_back( "reduction" );
-    clauses.push_back( "nowait" );
-    dc[ "sections" ] = clauses;
-
-    clauses.clear();
-    clauses.push_back( "private" );
-    clauses.push_back( "firstprivate" );
-    clauses.push_back( "copyprivate" );
-    clauses.push_back( "nowait" );
-    dc[ "single" ] = clauses;
-
-    clauses.clear();
-    clauses.push_back( "nowait" );
-    clauses.push_back( "copyprivate" );
-    dc[ "end single" ] = clauses;
-    dc[ "endsingle" ]  = clauses;
-
-    clauses.clear();
-    clauses.push_back( "nowait" );
-    dc[ "end do" ]        = clauses;
-    dc[ "enddo" ]         = clauses;
-    dc[ "end sections" ]  = clauses;
-    dc[ "endsections" ]   = clauses;
-    dc[ "end workshare" ] = clauses;
-    dc[ "endworkshare" ]  = clauses;
-
-    /** Commented out are the ones that are new with the OpenMP 4.0
-        specification */
-    clauses.clear();
-    clauses.push_back( "if" );
-    //clauses.push_back( "final" );
-    clauses.push_back( "untied" );
-    clauses.push_back( "default" );
-    //clauses.push_back( "mergeable" );
-    clauses.push_back( "private" );
-    clauses.push_back( "firstprivate" );
-    clauses.push_back( "shared" );
-    //clauses.push_back( "depend" );
-    dc[ "task" ] = clauses;
-
-    dc[ "parallelfor" ] = dc[ "parallel" ];
-    dc[ "parallelfor" ].insert( dc[ "parallelfor" ].end(),
-                                dc[ "for" ].begin(), dc[ "for" ].end() );
-
-    dc[ "paralleldo" ] = dc[ "parallel" ];
-    dc[ "paralleldo" ].insert( dc[ "paralleldo" ].end(),
-                               dc[ "do" ].begin(), dc[ "do" ].end() );
-
-    dc[ "parallelsections" ] = dc[ "parallel" ];
-    dc[ "parallelsections" ].insert( dc[ "parallelsections" ].end(),
-                                     dc[ "sections" ].begin(), dc[ "sections" ].end() );
-
-    dc[ "parallelworkshare" ] = dc[ "parallel" ];
-    dc[ "parallelworkshare" ].insert( dc[ "parallelworkshare" ].end(),
-                                      dc[ "workshare" ].begin(), dc[ "workshare" ].end() );
-
-    /** Doing the work anyway and usintg the OpenMP 4.0 specification, I
-        went ahead and added these clauses too */
-    // clauses.clear();
-    // clauses.push_back( "safelen" );
-    // clauses.push_back( "linear" );
-    // clauses.push_back( "aligned" );
-    // clauses.push_back( "private" );
-    // clauses.push_back( "lastprivate" );
-    // clauses.push_back( "reduction" );
-    // clauses.push_back( "collapse" );
-    // dc[ "simd" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "simdlen" );
-    // clauses.push_back( "linear" );
-    // clauses.push_back( "aligned" );
-    // clauses.push_back( "uniform" );
-    // clauses.push_back( "inbranch" );
-    // clauses.push_back( "notinbranch" );
-    // dc[ "declare simd" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "device" );
-    // clauses.push_back( "map" );
-    // clauses.push_back( "if" );
-    // dc[ "target data" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "device" );
-    // clauses.push_back( "map" );
-    // clauses.push_back( "if" );
-    // dc[ "target" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "to" );
-    // clauses.push_back( "from" );
-    // clauses.push_back( "device" );
-    // clauses.push_back( "if" );
-    // dc[ "target update" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "num_teams" );
-    // clauses.push_back( "thread_limit" );
-    // clauses.push_back( "default" );
-    // clauses.push_back( "private" );
-    // clauses.push_back( "firstprivate" );
-    // clauses.push_back( "shared" );
-    // clauses.push_back( "reduction" );
-    // dc[ "teams" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "private" );
-    // clauses.push_back( "firstprivate" );
-    // clauses.push_back( "collapse" );
-    // clauses.push_back( "dist_schedule" );
-    // dc[ "distribute" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "parallel" );
-    // clauses.push_back( "sections" );
-    // clauses.push_back( "for" );
-    // clauses.push_back( "do" );
-    // clauses.push_back( "taskgroup" );
-    // clauses.push_back( "if  " );
-    // dc[ "cancel" ] = clauses;
-
-    // clauses.clear();
-    // clauses.push_back( "parallel" );
-    // clauses.push_back( "sections" );
-    // clauses.push_back( "for" );
-    // clauses.push_back( "do" );
-    // clauses.push_back( "taskgroup" );
-    // dc[ "cancellation point" ] = clauses;
-
-    return dc;
-}
-
-OPARI2_StrVStr_map_t OPARI2_DirectiveOpenmp::s_directive_clauses = make_directive_clauses();
-
-
 /**
  *  @brief Creates pairs of directive keywords that can be combined
  *         and are split by OPARI2.
@@ -928,6 +1261,12 @@ make_outer_inner( void )
 {
     OPARI2_StrStr_pairs_t oi;
 
+    /* The simd keyword of 'parallel do/for simd' moves with the
+       worksharing-loop, so these pairs need to be processed before
+       the loop keyword is removed from the outer directive. */
+    oi.push_back( make_pair( string( "do" ), string( "simd" ) ) );
+    oi.push_back( make_pair( string( "for" ), string( "simd" ) ) );
+
     oi.push_back( make_pair( string( "parallel" ), string( "sections" ) ) );
 
     /* These are Fortran specific */
@@ -961,17 +1300,58 @@ make_inner_clauses( void )
     ic.push_back( make_pair( string( "lastprivate" ), true ) );
     ic.push_back( make_pair( string( "schedule" ), true ) );
     ic.push_back( make_pair( string( "collapse" ), true ) );
+    ic.push_back( make_pair( string( "linear" ), true ) );
+    ic.push_back( make_pair( string( "safelen" ), true ) );
+    ic.push_back( make_pair( string( "simdlen" ), true ) );
+    ic.push_back( make_pair( string( "aligned" ), true ) );
 
     return ic;
 }
 
 OPARI2_StrBool_pairs_t OPARI2_DirectiveOpenmp::s_inner_clauses = make_inner_clauses();
 
+
+/**
+ * @brief Specifies the clauses that belong to the inner 'for/do simd'
+ *        directive of a combined 'parallel for/do simd' directive.
+ *
+ * A reduction has to be known to the simd part of the loop, so it is
+ * moved to the inner directive, where it still applies to the whole
+ * parallel region.
+ */
+static OPARI2_StrBool_pairs_t
+make_inner_clauses_simd( void )
+{
+    OPARI2_StrBool_pairs_t ic = make_inner_clauses();
+
+    ic.push_back( make_pair( string( "reduction" ), true ) );
+
+    return ic;
+}
+
+OPARI2_StrBool_pairs_t OPARI2_DirectiveOpenmp::s_inner_clauses_simd = make_inner_clauses_simd();
+
 #define POMP_TPD_MANGLED FORTRAN_MANGLED( pomp_tpd )
-opari2_omp_option OPARI2_DirectiveOpenmp::s_omp_opt = { true,  false,  false,
-                                                        false, false,  false,
-                                                        false, false,  false,
-                                                        OPARI2_STR( POMP_TPD_MANGLED ) };
+static opari2_omp_option
+make_omp_option( void )
+{
+    opari2_omp_option omp_opt = { true,  false,  false,
+                                  false, false,  false,
+                                  false, false,  false,
+                                  false, false,
+                                  OPARI2_STR( POMP_TPD_MANGLED ),
+                                  vector<string>() };
+
+    return omp_opt;
+}
+
+opari2_omp_option OPARI2_DirectiveOpenmp::s_omp_opt = make_omp_option();
+
+void
+OPARI2_DirectiveOpenmp::ResetOptions( void )
+{
+    s_omp_opt = make_omp_option();
+}
 
 stringstream OPARI2_DirectiveOpenmp:: s_init_handle_calls;
 int          OPARI2_DirectiveOpenmp::          s_num_regions = 0;
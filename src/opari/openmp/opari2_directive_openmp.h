@@ -29,22 +29,26 @@ using std::ostream;
 
 #include "opari2.h"
 #include "opari2_directive.h"
+#include "opari2_directive_entry_openmp.h"
 
 /** @brief Anonymous namespace including structure definition for OpenMP specific cmd line options. */
 
 /** @brief Structure for OpenMP specific cmd line options. */
 typedef struct
 {
-    bool   add_shared_decl;
-    bool   copytpd;
-    bool   task_abort;
-    bool   task_warn;
-    bool   task_remove;
-    bool   untied_abort;
-    bool   untied_keep;
-    bool   untied_nowarn;
-    bool   tpd_in_extern_block;
-    string pomp_tpd;
+    bool           add_shared_decl;
+    bool           copytpd;
+    bool           task_abort;
+    bool           task_warn;
+    bool           task_remove;
+    bool           untied_abort;
+    bool           untied_keep;
+    bool           untied_nowarn;
+    bool           tpd_in_extern_block;
+    bool           ctc_at_init;
+    bool           barrier_timestamp;
+    string         pomp_tpd;
+    vector<string> barrier_timestamp_constructs;
 } opari2_omp_option;
 
 
@@ -62,10 +66,13 @@ public:
     {
         m_type = OPARI2_PT_OMP;
 
-        m_nowait_added = false;
-        m_has_untied   = false;
-        m_has_ordered  = false;
-        m_num_sections = 0;
+        m_nowait_added  = false;
+        m_has_untied    = false;
+        m_has_ordered   = false;
+        m_combined_loop = false;
+        m_num_sections  = 0;
+        m_num_depend    = 0;
+        m_clause_set    = 0;
 
         if ( lines.empty() )
         {
@@ -96,6 +103,10 @@ public:
     static OPARI2_ErrorCode
     ProcessOption( string option );
 
+    /** @brief Restore the default values of 's_omp_opt'. */
+    static void
+    ResetOptions( void );
+
     /** @brief Set value for 'opt.omp_pomp_tpd'. */
     static void
     SetOptPomptpd( string str );
@@ -111,6 +122,14 @@ public:
     virtual void
     FindName( void );
 
+    /** @brief Returns whether a clause is present */
+    bool
+    HasClause( OPARI2_OmpClause clause );
+
+    /** @brief Returns the argument of a clause, "" if it is not present */
+    string
+    GetClauseArg( OPARI2_OmpClause clause );
+
     /** is the default data sharing changed,
      *  i.e. is default(none) or default(private) present?
      */
@@ -133,6 +152,13 @@ public:
     string&
     GetReduction( void );
 
+    /** true for cancel and cancellation point directives */
+    bool
+    IsCancelDirective( void );
+
+    string&
+    GetCancelConstruct( void );
+
     /** split compined constructs in two seperate statement */
     virtual OPARI2_DirectiveOpenmp*
     SplitCombined( void );
@@ -158,6 +184,10 @@ public:
     GenerateInitHandleCalls( ostream&     os,
                              const string incfile = "" );
 
+    /** @brief Forget the regions of the previous file */
+    static void
+    ResetRegions( void );
+
     /** add a nowait to a directive*/
     virtual void
     AddNowait( void );
@@ -169,7 +199,7 @@ public:
     virtual OPARI2_Directive*
     EndLoopDirective( const int lineno );
 
-    /** Returns true for enddo and endparalleldo directives */
+    /** Returns true for directives ending a loop construct */
     virtual bool
     EndsLoopDirective( void );
 
@@ -180,6 +210,18 @@ private:
     virtual void
     identify_clauses( void );
 
+    /**
+     * @brief Stores the constructs combined with @a first
+     */
+    void
+    find_combined( const string& first );
+
+    /**
+     * @brief Counts the list items of a depend clause
+     */
+    static int
+    count_depend_items( const string& arguments );
+
 private:
     string m_arg_num_threads; /**< argument of the 'num_threads' clause */
     string m_arg_if;          /**< argument of the 'if' clause */
@@ -190,6 +232,18 @@ private:
     bool   m_has_untied;      /**< true if has 'untied' clause */
     bool   m_has_ordered;     /**< true if hase 'ordered' clause */
     int    m_num_sections;    /**< number of sections */
+    string m_combined;        /**< constructs combined with target, teams, ... */
+    bool   m_combined_loop;   /**< true if a combined construct is a loop */
+    int    m_num_depend;      /**< number of list items in depend clauses */
+    string m_cancel_construct; /**< construct type of cancel directives */
+
+    /** set of clauses present on the directive, see C_OMP_BIT */
+    uint32_t m_clause_set;
+    /** arguments of all clauses, one after the other */
+    string   m_clause_args;
+    /** start and length of the argument of each present clause in
+        m_clause_args */
+    pair<string::size_type, string::size_type> m_clause_arg_spans[ C_OMP_NUM_CLAUSES ];
 
     string::size_type m_indent;
     bool              m_nowait_added;
@@ -204,8 +258,8 @@ private:
     static int               s_num_regions;
     static const string      s_paradigm_prefix;
 
-    static OPARI2_StrVStr_map_t   s_directive_clauses;
     static OPARI2_StrStr_pairs_t  s_outer_inner;
     static OPARI2_StrBool_pairs_t s_inner_clauses;
+    static OPARI2_StrBool_pairs_t s_inner_clauses_simd;
 };
 #endif
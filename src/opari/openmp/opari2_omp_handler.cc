@@ -79,8 +79,8 @@ using std::ostream;
 #include "opari2_directive_openmp.h"
 #include "opari2_directive_manager.h"
 
-extern OPARI2_Option_t opt;
-
+namespace opari2
+{
 namespace
 {
 bool in_workshare = false;
@@ -89,7 +89,7 @@ void
 generate_num_threads( ostream&                os,
                       OPARI2_DirectiveOpenmp* d )
 {
-    string num_threads = d->GetClauseArg( "num_threads" );
+    string num_threads = d->GetClauseArg( C_OMP_NUM_THREADS );
 
     if ( opt.lang & L_FORTRAN )
     {
@@ -119,7 +119,7 @@ void
 generate_if( ostream&                os,
              OPARI2_DirectiveOpenmp* d )
 {
-    string if_clause = d->GetClauseArg( "if" );
+    string if_clause = d->GetClauseArg( C_OMP_IF );
 
     if ( opt.lang & L_FORTRAN )
     {
@@ -145,6 +145,33 @@ generate_if( ostream&                os,
     }
 }
 
+/** @brief Returns true if the CTC string of @a d is passed to the event.
+ *
+ * With --omp-ctc-at-init the CTC string is only passed to
+ * POMP2_Assign_handle and the event is called by handle alone. */
+bool
+pass_ctc( OPARI2_DirectiveOpenmp* d )
+{
+    return d != NULL && !OPARI2_DirectiveOpenmp::GetOpenmpOpt()->ctc_at_init;
+}
+
+/** @brief Suffix of the event function that omits the CTC string. */
+const char*
+ctc_suffix( OPARI2_DirectiveOpenmp* d )
+{
+    return ( d != NULL && !pass_ctc( d ) ) ? "_no_ctc" : "";
+}
+
+/** @brief Returns the if flag as passed to the event.
+ *
+ * With --fortran-bind-c the logical pomp2_if is converted to the int
+ * the C function expects. */
+string
+if_argument( void )
+{
+    return opt.fortran_bind_c ? "merge( 1, 0, pomp2_if )" : "pomp2_if";
+}
+
 void
 generate_call( const char*             event,
                const char*             type,
@@ -162,15 +189,16 @@ generate_call( const char*             event,
             os << "      if (pomp2_if) then\n";
         }
         os << "      call POMP2_" << c1 << ( type + 1 )
-           << "_" << event << "(" << region_id_prefix << id;
+           << "_" << event << ctc_suffix( d ) << "(" << region_id_prefix << id;
         if ( strstr( type, "task" ) != NULL &&
              strcmp( type, "taskwait" ) != 0 &&
+             strcmp( type, "taskgroup" ) != 0 &&
              strcmp( event, "begin" ) == 0 )
         {
             os << ", pomp2_new_task";
         }
 
-        if ( d != NULL )
+        if ( pass_ctc( d ) )
         {
             if ( opt.form == F_FIX )
             {
@@ -200,16 +228,17 @@ generate_call( const char*             event,
         }
 
         os << "  POMP2_" << c1 << ( type + 1 )
-           << "_" << event << "( &" << region_id_prefix << id;
+           << "_" << event << ctc_suffix( d ) << "( &" << region_id_prefix << id;
 
         if ( strstr( type, "task" ) != NULL &&
              strcmp( type, "taskwait" ) != 0 &&
+             strcmp( type, "taskgroup" ) != 0 &&
              strcmp( event, "begin" ) == 0 )
         {
             os << ", pomp2_new_task";
         }
 
-        if ( d != NULL )
+        if ( pass_ctc( d ) )
         {
             os << ", " << d->GetCTCStringVariable() << " ";
         }
@@ -243,7 +272,7 @@ generate_call_save_task_id( const char*             event,
             os << "      if (pomp2_if) then\n";
         }
         os << "      call POMP2_" << c1 << ( type + 1 )
-           << "_" << event << "(" << region_id_prefix << id;
+           << "_" << event << ctc_suffix( d ) << "(" << region_id_prefix << id;
         if ( ( strcmp( type, "task_create" ) == 0 ) || ( strcmp( type, "untied_task_create" ) == 0 )  )
         {
             if ( opt.form == F_FIX )
@@ -269,17 +298,23 @@ generate_call_save_task_id( const char*             event,
             {
                 if ( d->GetName() == "task" )
                 {
-                    os << ", \n     &pomp2_if";
+                    os << ", \n     &" << if_argument();
+                }
+                if ( pass_ctc( d ) )
+                {
+                    os << ",\n     &" << d->GetCTCStringVariable() << " ";
                 }
-                os << ",\n     &" << d->GetCTCStringVariable() << " ";
             }
             else
             {
                 if ( d->GetName() == "task" )
                 {
-                    os << ", pomp2_if";
+                    os << ", " << if_argument();
+                }
+                if ( pass_ctc( d ) )
+                {
+                    os << ", " << d->GetCTCStringVariable() << " ";
                 }
-                os << ", " << d->GetCTCStringVariable() << " ";
             }
         }
         os << ")\n";
@@ -300,7 +335,7 @@ generate_call_save_task_id( const char*             event,
             os << "if (pomp2_if)";
         }
         os << "  POMP2_" << c1 << ( type + 1 )
-           << "_" << event << "( &" << region_id_prefix << id;
+           << "_" << event << ctc_suffix( d ) << "( &" << region_id_prefix << id;
         if ( ( strcmp( type, "task_create" ) == 0 ) || ( strcmp( type, "untied_task_create" ) == 0 )  )
         {
             os << ", &pomp2_new_task";
@@ -312,7 +347,10 @@ generate_call_save_task_id( const char*             event,
             {
                 os << ", pomp2_if";
             }
-            os << ", " << d->GetCTCStringVariable() << " ";
+            if ( pass_ctc( d ) )
+            {
+                os << ", " << d->GetCTCStringVariable() << " ";
+            }
         }
         os << " );\n";
     }
@@ -387,19 +425,19 @@ generate_fork_call( const char*             event,
     if ( opt.lang & L_FORTRAN )
     {
         os << "      call POMP2_" << c1 << ( type + 1 )
-           << "_" << event << "(" << region_id_prefix << id;
+           << "_" << event << ctc_suffix( d ) << "(" << region_id_prefix << id;
         if ( opt.form == F_FIX )
         {
-            os << ",\n     &pomp2_if, pomp2_num_threads, pomp2_old_task";
-            if ( d != NULL )
+            os << ",\n     &" << if_argument() << ", pomp2_num_threads, pomp2_old_task";
+            if ( pass_ctc( d ) )
             {
                 os << ",\n     &" << d->GetCTCStringVariable() << " ";
             }
         }
         else
         {
-            os << ",&\n      pomp2_if, pomp2_num_threads, pomp2_old_task";
-            if ( d != NULL )
+            os << ",&\n      " << if_argument() << ", pomp2_num_threads, pomp2_old_task";
+            if ( pass_ctc( d ) )
             {
                 os << ", &\n      " << d->GetCTCStringVariable() << " ";
             }
@@ -409,10 +447,10 @@ generate_fork_call( const char*             event,
     else
     {
         os << "  POMP2_Task_handle pomp2_old_task;\n";
-        os << "  POMP2_" << c1 << ( type + 1 ) << "_" << event
+        os << "  POMP2_" << c1 << ( type + 1 ) << "_" << event << ctc_suffix( d )
            << "(&" << region_id_prefix << id << ", pomp2_if, pomp2_num_threads, "
            << "&pomp2_old_task";
-        if ( d != NULL )
+        if ( pass_ctc( d ) )
         {
             os << ", " << d->GetCTCStringVariable() << " ";
         }
@@ -443,19 +481,61 @@ generate_directive( const char* p,
     }
 }
 
+/** @brief Returns true if the implicit barrier of @a construct is
+ *         only recorded by its arrival (--omp-barrier-timestamp). */
+bool
+barrier_timestamp_only( const string& construct )
+{
+    opari2_omp_option* omp_opt = OPARI2_DirectiveOpenmp::GetOpenmpOpt();
+
+    if ( !omp_opt->barrier_timestamp )
+    {
+        return false;
+    }
+    if ( omp_opt->barrier_timestamp_constructs.empty() )
+    {
+        return true;
+    }
+    for ( vector<string>::iterator it = omp_opt->barrier_timestamp_constructs.begin();
+          it != omp_opt->barrier_timestamp_constructs.end(); ++it )
+    {
+        if ( *it == construct )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void
-generate_barrier( int         n,
-                  ostream&    os,
-                  const char* filename )
+generate_barrier( int           n,
+                  ostream&      os,
+                  const char*   filename,
+                  const string& construct )
 {
-    generate_call_save_task_id( "enter", "implicit_barrier", n, os, NULL );
-    generate_directive( "barrier", 0, filename, os );
-    generate_call_restore_task_id( "exit", "implicit_barrier", n, os );
+    if ( barrier_timestamp_only( construct ) )
+    {
+        if ( opt.lang & L_FORTRAN )
+        {
+            os << "      call POMP2_Implicit_barrier_arrive(" << region_id_prefix << n << ")\n";
+        }
+        else
+        {
+            os << "  POMP2_Implicit_barrier_arrive( &" << region_id_prefix << n << " );\n";
+        }
+        generate_directive( "barrier", 0, filename, os );
+    }
+    else
+    {
+        generate_call_save_task_id( "enter", "implicit_barrier", n, os, NULL );
+        generate_directive( "barrier", 0, filename, os );
+        generate_call_restore_task_id( "exit", "implicit_barrier", n, os );
+    }
 }
 } //end-of-namespace
 
 
-OPARI2_DirectiveOpenmp*
+static OPARI2_DirectiveOpenmp*
 cast2omp( OPARI2_Directive* d_base )
 {
     OPARI2_DirectiveOpenmp* d = dynamic_cast<OPARI2_DirectiveOpenmp*>( d_base );
@@ -473,7 +553,7 @@ cast2omp( OPARI2_Directive* d_base )
  * @brief Print the directive's lines, together with additional
  *                statements to support OpenMP task.
  */
-void
+static void
 print_directive_parallel( OPARI2_DirectiveOpenmp* d,
                           ostream&                os )
 {
@@ -485,7 +565,7 @@ print_directive_parallel( OPARI2_DirectiveOpenmp* d,
         if ( opt.form == F_FIX )     // fix source form
         {
             adds << "\n!$omp& firstprivate(pomp2_old_task) private(pomp2_new_task)\n!$omp&";
-            if ( d->HasClause( "if" ) )
+            if ( d->HasClause( C_OMP_IF ) )
             {
                 adds << " if(pomp2_if)";
             }
@@ -505,7 +585,7 @@ print_directive_parallel( OPARI2_DirectiveOpenmp* d,
         {
             adds << " &\n  !$omp firstprivate(pomp2_old_task) private(pomp2_new_task) &\n";
             adds << "  !$omp";
-            if ( d->HasClause( "if" ) )
+            if ( d->HasClause( C_OMP_IF ) )
             {
                 adds << " if(pomp2_if)";
             }
@@ -527,7 +607,7 @@ print_directive_parallel( OPARI2_DirectiveOpenmp* d,
         adds << " firstprivate(pomp2_old_task)";
         if ( omp_opt->copytpd )
         {
-            if ( d->HasClause( "if" ) )
+            if ( d->HasClause( C_OMP_IF ) )
             {
                 adds << " if(pomp2_if)";
             }
@@ -535,7 +615,7 @@ print_directive_parallel( OPARI2_DirectiveOpenmp* d,
         }
         else
         {
-            if ( d->HasClause( "if" ) )
+            if ( d->HasClause( C_OMP_IF ) )
             {
                 adds << " if(pomp2_if)";
             }
@@ -556,7 +636,7 @@ print_directive_parallel( OPARI2_DirectiveOpenmp* d,
     d->PrintPlainDirective( os, adds.str() );
 }
 
-void
+static void
 enter_handler_notransform( OPARI2_DirectiveOpenmp* d,
                            ostream&                os )
 {
@@ -564,12 +644,60 @@ enter_handler_notransform( OPARI2_DirectiveOpenmp* d,
     d->PrintPlainDirective( os );
 }
 
-void
+static void
 exit_handler_notransform( OPARI2_DirectiveOpenmp* d )
 {
     DirectiveStackPop();
 }
 
+/**
+ * @brief Enter handler for constructs that are only framed by an
+ *        enter and an exit event, without an implicit barrier.
+ */
+static void
+enter_handler_enter_exit( OPARI2_DirectiveOpenmp* d,
+                          const char*             type,
+                          ostream&                os )
+{
+    if ( InstrumentationDisabled( D_USER ) )
+    {
+        enter_handler_notransform( d, os );
+    }
+    else
+    {
+        d->EnterRegion();
+
+        generate_call( "enter", type, d->GetID(), os, d );
+        d->PrintDirective( os );
+    }
+}
+
+/**
+ * @brief Exit handler matching enter_handler_enter_exit().
+ */
+static void
+exit_handler_enter_exit( OPARI2_DirectiveOpenmp* d,
+                         const char*             type,
+                         ostream&                os )
+{
+    if ( InstrumentationDisabled( D_USER ) )
+    {
+        d->PrintPlainDirective( os );
+        exit_handler_notransform( d );
+    }
+    else
+    {
+        int id = d->ExitRegion( false );
+
+        d->PrintDirective( os );
+        generate_call( "exit", type, id, os, NULL );
+        if ( opt.keep_src_info )
+        {
+            d->ResetSourceInfo( os );
+        }
+    }
+}
+
 /**
  * @brief OpenMP pragma transformation functions.
  *
@@ -624,7 +752,7 @@ h_end_omp_parallel( OPARI2_Directive* d_base,
         int id =  d->ExitRegion( true );
         if ( !InstrumentationDisabled( D_USER ) && DirectiveActive( OPARI2_PT_OMP, "barrier" ) )
         {
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "parallel" );
         }
         generate_call( "end", "parallel", id, os, NULL );
         d->PrintDirective( os );
@@ -651,7 +779,7 @@ h_omp_for( OPARI2_Directive* d_base,
     {
         d->EnterRegion();
 
-        if ( !d->HasClause( "nowait" ) )
+        if ( !d->HasClause( C_OMP_NOWAIT ) )
         {
             d->AddNowait();
         }
@@ -677,7 +805,7 @@ h_end_omp_for( OPARI2_Directive* d_base,
 
         if ( d_top->IsNowaitAdded() )
         {
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "for" );
         }
         generate_call( "exit", "for", id, os, NULL );
         if ( opt.keep_src_info )
@@ -720,7 +848,7 @@ h_end_omp_do( OPARI2_Directive* d_base,
     else
     {
         int id = d->ExitRegion( false );
-        if ( d->HasClause( "nowait" ) )
+        if ( d->HasClause( C_OMP_NOWAIT ) )
         {
             d->PrintDirective( os );
         }
@@ -728,7 +856,7 @@ h_end_omp_do( OPARI2_Directive* d_base,
         {
             d->AddNowait();
             d->PrintDirective( os );
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "do" );
         }
         generate_call( "exit", "do", id, os, NULL );
         if ( opt.keep_src_info )
@@ -738,7 +866,7 @@ h_end_omp_do( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_sections_c( OPARI2_Directive* d_base,
                   ostream&          os )
 {
@@ -752,7 +880,7 @@ h_omp_sections_c( OPARI2_Directive* d_base,
     {
         d->EnterRegion();
 
-        if ( !d->HasClause( "nowait" ) )
+        if ( !d->HasClause( C_OMP_NOWAIT ) )
         {
             d->AddNowait();
         }
@@ -761,7 +889,7 @@ h_omp_sections_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_section_c( OPARI2_Directive* d_base,
                  ostream&          os )
 {
@@ -799,7 +927,7 @@ h_omp_section_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_section_c( OPARI2_Directive* d_base,
                      ostream&          os )
 {
@@ -833,7 +961,7 @@ h_end_omp_section( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_sections_c( OPARI2_Directive* d_base,
                       ostream&          os )
 {
@@ -850,7 +978,7 @@ h_end_omp_sections_c( OPARI2_Directive* d_base,
 
         if ( d_top->IsNowaitAdded() )
         {
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "sections" );
         }
         generate_call( "exit", "sections", id, os, NULL );
         if ( opt.keep_src_info )
@@ -860,7 +988,7 @@ h_end_omp_sections_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_sections_f( OPARI2_Directive* d_base,
                   ostream&          os )
 {
@@ -892,7 +1020,7 @@ h_omp_sections( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_section_f( OPARI2_Directive* d_base,
                  ostream&          os )
 {
@@ -937,7 +1065,7 @@ h_omp_section( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_sections_f( OPARI2_Directive* d_base,
                       ostream&          os )
 {
@@ -952,7 +1080,7 @@ h_end_omp_sections_f( OPARI2_Directive* d_base,
     {
         int id = d->ExitRegion( false );
         generate_call( "end", "section", id, os, NULL );
-        if ( d->HasClause( "nowait" ) )
+        if ( d->HasClause( C_OMP_NOWAIT ) )
         {
             d->PrintDirective( os );
         }
@@ -960,7 +1088,7 @@ h_end_omp_sections_f( OPARI2_Directive* d_base,
         {
             d->AddNowait();
             d->PrintDirective( os );
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "sections" );
         }
         generate_call( "exit", "sections", id, os, NULL );
         if ( opt.keep_src_info )
@@ -984,7 +1112,7 @@ h_end_omp_sections( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_single_c( OPARI2_Directive* d_base,
                 ostream&          os )
 {
@@ -998,7 +1126,7 @@ h_omp_single_c( OPARI2_Directive* d_base,
     {
         d->EnterRegion();
 
-        if ( !d->HasClause( "nowait" ) && !d->HasClause( "copyprivate" ) )
+        if ( !d->HasClause( C_OMP_NOWAIT ) && !d->HasClause( C_OMP_COPYPRIVATE ) )
         {
             d->AddNowait();
         }
@@ -1014,7 +1142,7 @@ h_omp_single_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_single_c( OPARI2_Directive* d_base,
                     ostream&          os )
 {
@@ -1032,7 +1160,7 @@ h_end_omp_single_c( OPARI2_Directive* d_base,
         generate_call( "end", "single", id, os, NULL );
         if ( d_top->IsNowaitAdded() )
         {
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "single" );
         }
         generate_call( "exit", "single", id, os, NULL );
         if ( opt.keep_src_info )
@@ -1042,7 +1170,7 @@ h_end_omp_single_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_single_f( OPARI2_Directive* d_base,
                 ostream&          os )
 {
@@ -1081,7 +1209,7 @@ h_omp_single( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_single_f( OPARI2_Directive* d_base,
                     ostream&          os )
 {
@@ -1096,20 +1224,20 @@ h_end_omp_single_f( OPARI2_Directive* d_base,
     {
         int id = d->ExitRegion( false );
         generate_call( "end", "single", id, os, NULL );
-        if ( d->HasClause( "nowait" ) )
+        if ( d->HasClause( C_OMP_NOWAIT ) )
         {
             d->PrintDirective( os );
         }
         else
         {
-            if ( !d->HasClause( "copyprivate" ) )
+            if ( !d->HasClause( C_OMP_COPYPRIVATE ) )
             {
                 d->AddNowait();
             }
             d->PrintDirective( os );
             if ( d->IsNowaitAdded() )
             {
-                generate_barrier( id, os, d->GetFilename().c_str() );
+                generate_barrier( id, os, d->GetFilename().c_str(), "single" );
             }
         }
         generate_call( "exit", "single", id, os, NULL );
@@ -1160,7 +1288,7 @@ h_omp_master( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_master_c( OPARI2_Directive* d_base,
                     ostream&          os )
 {
@@ -1182,7 +1310,7 @@ h_end_omp_master_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_master_f( OPARI2_Directive* d_base,
                     ostream&          os )
 {
@@ -1344,7 +1472,7 @@ h_end_omp_parallelfor( OPARI2_Directive* d_base,
 
         if ( !InstrumentationDisabled( D_USER ) && ( d->active ) )
         {
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "for" );
             generate_call( "exit", "for", id, os, NULL );
         }
 
@@ -1405,18 +1533,20 @@ h_end_omp_paralleldo( OPARI2_Directive* d_base,
     }
     else
     {
-        int     id       = d->ExitRegion( true );
-        string& filename = d->GetFilename();
-        int     lineno   = d->GetLineno();
+        OPARI2_DirectiveOpenmp* d_top    = cast2omp( DirectiveStackTop( d ) );
+        string                  end_loop = d_top->GetName() == "paralleldosimd" ? "end do simd" : "end do";
+        int                     id       = d->ExitRegion( true );
+        string&                 filename = d->GetFilename();
+        int                     lineno   = d->GetLineno();
 
         if ( InstrumentationDisabled( D_USER ) || !( d->active ) )
         {
-            generate_directive( "end do", lineno, filename.c_str(), os );
+            generate_directive( end_loop.c_str(), lineno, filename.c_str(), os );
         }
         else
         {
-            generate_directive( "end do nowait", lineno, filename.c_str(), os );
-            generate_barrier( id, os, filename.c_str() );
+            generate_directive( ( end_loop + " nowait" ).c_str(), lineno, filename.c_str(), os );
+            generate_barrier( id, os, filename.c_str(), "do" );
             generate_call( "exit", "do", id, os, NULL );
         }
 
@@ -1432,7 +1562,7 @@ h_end_omp_paralleldo( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_parallelsections_c( OPARI2_Directive* d_base,
                           ostream&          os )
 {
@@ -1470,7 +1600,7 @@ h_omp_parallelsections_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_omp_parallelsections_f( OPARI2_Directive* d_base,
                           ostream&          os )
 {
@@ -1494,7 +1624,7 @@ h_omp_parallelsections_f( OPARI2_Directive* d_base,
 
         if ( !InstrumentationDisabled( D_USER ) && ( d->active ) )
         {
-            generate_call( "enter", "sections", id, os, NULL );
+            generate_call( "enter", "sections", id, os, d );
         }
 
         sec_directive->PrintDirective( os ); // #omp sections
@@ -1517,7 +1647,7 @@ h_omp_parallelsections( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_parallelsections_c( OPARI2_Directive* d_base,
                               ostream&          os )
 {
@@ -1534,7 +1664,7 @@ h_end_omp_parallelsections_c( OPARI2_Directive* d_base,
 
         if ( !InstrumentationDisabled( D_USER ) && ( d->active ) )
         {
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "sections" );
             generate_call( "exit", "sections", id, os, NULL );
         }
 
@@ -1547,7 +1677,7 @@ h_end_omp_parallelsections_c( OPARI2_Directive* d_base,
     }
 }
 
-void
+static void
 h_end_omp_parallelsections_f( OPARI2_Directive* d_base,
                               ostream&          os )
 {
@@ -1573,7 +1703,7 @@ h_end_omp_parallelsections_f( OPARI2_Directive* d_base,
         {
             generate_call( "end", "section", id, os, NULL );
             generate_directive( "end sections nowait", lineno, filename.c_str(), os );
-            generate_barrier( id, os, filename.c_str() );
+            generate_barrier( id, os, filename.c_str(), "sections" );
             generate_call( "exit", "sections", id, os, NULL );
         }
         generate_call( "end", "parallel", id, os, NULL );
@@ -1770,7 +1900,7 @@ h_end_omp_workshare( OPARI2_Directive* d_base,
     {
         int id = d->ExitRegion( false );
 
-        if ( d->HasClause( "nowait" ) )
+        if ( d->HasClause( C_OMP_NOWAIT ) )
         {
             d->PrintDirective( os );
             generate_call( "exit", "workshare", id, os, NULL );
@@ -1779,7 +1909,7 @@ h_end_omp_workshare( OPARI2_Directive* d_base,
         {
             d->AddNowait();
             d->PrintDirective( os );
-            generate_barrier( id, os, d->GetFilename().c_str() );
+            generate_barrier( id, os, d->GetFilename().c_str(), "workshare" );
             generate_call( "exit", "workshare", id, os, NULL );
         }
 
@@ -1849,7 +1979,7 @@ h_end_omp_parallelworkshare( OPARI2_Directive* d_base,
         else
         {
             generate_directive( "end workshare nowait", lineno, filename.c_str(), os );
-            generate_barrier( id, os, filename.c_str() );
+            generate_barrier( id, os, filename.c_str(), "workshare" );
             generate_call( "exit", "workshare", id, os, NULL );
         }
         generate_call( "end", "parallel", id, os, NULL );
@@ -1957,7 +2087,7 @@ h_omp_task( OPARI2_Directive* d_base,
                  << "WARNING: Tasks may not be supported by the measurement system." << std::endl;
         }
 
-        if ( d->HasClause( "untied" ) )
+        if ( d->HasClause( C_OMP_UNTIED ) )
         {
             if ( omp_opt->untied_abort )
             {
@@ -2049,7 +2179,7 @@ h_end_omp_task( OPARI2_Directive* d_base,
         const char*             inner_call, * outer_call;
         opari2_omp_option*      omp_opt = OPARI2_DirectiveOpenmp::GetOpenmpOpt();
 
-        if ( d_top->HasClause( "untied" ) && omp_opt->untied_keep )
+        if ( d_top->HasClause( C_OMP_UNTIED ) && omp_opt->untied_keep )
         {
             outer_call = "untied_task_create";
             inner_call = "untied_task";
@@ -2105,6 +2235,308 @@ h_omp_taskwait( OPARI2_Directive* d_base,
     }
 }
 
+/*3.1*/
+void
+h_omp_taskyield( OPARI2_Directive* d_base,
+                 ostream&          os )
+{
+    OPARI2_DirectiveOpenmp* d = cast2omp( d_base );
+
+    if ( InstrumentationDisabled( D_USER ) )
+    {
+        d->PrintPlainDirective( os );
+    }
+    else
+    {
+        d->InitRegion();
+        SaveForInit( d );
+
+        int id = d->GetID();
+        generate_call_save_task_id( "begin", "taskyield", id, os, d );
+        d->PrintDirective( os );
+        generate_call_restore_task_id( "end", "taskyield", id, os );
+
+        if ( opt.keep_src_info )
+        {
+            d->ResetSourceInfo( os );
+        }
+    }
+}
+
+/*4.0*/
+void
+h_omp_taskgroup( OPARI2_Directive* d_base,
+                 ostream&          os )
+{
+    OPARI2_DirectiveOpenmp* d = cast2omp( d_base );
+
+    if ( InstrumentationDisabled( D_USER ) )
+    {
+        enter_handler_notransform( d, os );
+    }
+    else
+    {
+        d->EnterRegion();
+
+        int id = d->GetID();
+        generate_call_save_task_id( "enter", "taskgroup", id, os, d );
+        d->PrintDirective( os );
+        generate_call( "begin", "taskgroup", id, os, NULL );
+
+        if ( opt.keep_src_info )
+        {
+            d->ResetSourceInfo( os );
+        }
+    }
+}
+
+/*4.0*/
+void
+h_end_omp_taskgroup( OPARI2_Directive* d_base,
+                     ostream&          os )
+{
+    OPARI2_DirectiveOpenmp* d = cast2omp( d_base );
+
+    if ( InstrumentationDisabled( D_USER ) )
+    {
+        d->PrintPlainDirective( os );
+        exit_handler_notransform( d );
+    }
+    else
+    {
+        int id = d->ExitRegion( false );
+
+        generate_call( "end", "taskgroup", id, os, NULL );
+        d->PrintDirective( os );
+        generate_call_restore_task_id( "exit", "taskgroup", id, os );
+
+        if ( opt.keep_src_info )
+        {
+            d->ResetSourceInfo( os );
+        }
+    }
+}
+
+/**
+ * @brief Instruments cancel and cancellation point directives.
+ *
+ * Only an event before the directive is generated, as the thread
+ * continues at the end of the cancelled region if cancellation is
+ * activated.
+ */
+static void
+handler_cancel( OPARI2_DirectiveOpenmp* d,
+                const char*             type,
+                const char*             event,
+                ostream&                os )
+{
+    if ( InstrumentationDisabled( D_USER ) )
+    {
+        d->PrintPlainDirective( os );
+    }
+    else
+    {
+        string& construct = d->GetCancelConstruct();
+
+        /* The nowait clause and the explicit barrier added to
+           worksharing constructs are not compatible with their
+           cancellation. */
+        if ( ( construct == "for" || construct == "do" ||
+               construct == "sections" ) &&
+             DirectiveActive( OPARI2_PT_OMP, construct ) )
+        {
+            cerr << d->GetFilename() << ":" << d->GetLineno() << ":\n"
+                 << "WARNING: Cancellation of an instrumented " << construct
+                 << " construct is not supported.\n"
+                 << "         Please consider using --disable=omp:" << construct << std::endl;
+        }
+
+        d->InitRegion();
+        SaveForInit( d );
+
+        int id = d->GetID();
+        generate_call( event, type, id, os, d );
+        d->PrintDirective( os );
+
+        if ( opt.keep_src_info )
+        {
+            d->ResetSourceInfo( os );
+        }
+    }
+}
+
+/*4.0*/
+void
+h_omp_cancel( OPARI2_Directive* d_base,
+              ostream&          os )
+{
+    handler_cancel( cast2omp( d_base ), "cancel", "request", os );
+}
+
+/*4.0*/
+void
+h_omp_cancellationpoint( OPARI2_Directive* d_base,
+                         ostream&          os )
+{
+    handler_cancel( cast2omp( d_base ), "cancellation_point", "check", os );
+}
+
+/*4.0*/
+void
+h_omp_simd( OPARI2_Directive* d_base,
+            ostream&          os )
+{
+    enter_handler_enter_exit( cast2omp( d_base ), "simd", os );
+}
+
+/*4.0*/
+void
+h_end_omp_simd( OPARI2_Directive* d_base,
+                ostream&          os )
+{
+    exit_handler_enter_exit( cast2omp( d_base ), "simd", os );
+}
+
+/*4.0*/
+void
+h_omp_forsimd( OPARI2_Directive* d_base,
+               ostream&          os )
+{
+    h_omp_for( d_base, os );
+}
+
+/*4.0*/
+void
+h_end_omp_forsimd( OPARI2_Directive* d_base,
+                   ostream&          os )
+{
+    h_end_omp_for( d_base, os );
+}
+
+/*4.0*/
+void
+h_omp_dosimd( OPARI2_Directive* d_base,
+              ostream&          os )
+{
+    h_omp_do( d_base, os );
+}
+
+/*4.0*/
+void
+h_end_omp_dosimd( OPARI2_Directive* d_base,
+                  ostream&          os )
+{
+    h_end_omp_do( d_base, os );
+}
+
+/*4.0*/
+void
+h_omp_parallelforsimd( OPARI2_Directive* d_base,
+                       ostream&          os )
+{
+    h_omp_parallelfor( d_base, os );
+}
+
+/*4.0*/
+void
+h_end_omp_parallelforsimd( OPARI2_Directive* d_base,
+                           ostream&          os )
+{
+    h_end_omp_parallelfor( d_base, os );
+}
+
+/*4.0*/
+void
+h_omp_paralleldosimd( OPARI2_Directive* d_base,
+                      ostream&          os )
+{
+    h_omp_paralleldo( d_base, os );
+}
+
+/*4.0*/
+void
+h_end_omp_paralleldosimd( OPARI2_Directive* d_base,
+                          ostream&          os )
+{
+    h_end_omp_paralleldo( d_base, os );
+}
+
+/**
+ * Note: Only the host side of a target region is instrumented. There
+ * is no measurement system on the device, so the instrumentation of
+ * the region itself is disabled like for offload regions.
+ */
+/*4.0*/
+void
+h_omp_target( OPARI2_Directive* d_base,
+              ostream&          os )
+{
+    enter_handler_enter_exit( cast2omp( d_base ), "target", os );
+    DisableInstrumentation( D_FULL );
+}
+
+/*4.0*/
+void
+h_end_omp_target( OPARI2_Directive* d_base,
+                  ostream&          os )
+{
+    EnableInstrumentation( D_FULL );
+    exit_handler_enter_exit( cast2omp( d_base ), "target", os );
+}
+
+/*4.0*/
+void
+h_omp_teams( OPARI2_Directive* d_base,
+             ostream&          os )
+{
+    enter_handler_enter_exit( cast2omp( d_base ), "teams", os );
+}
+
+/*4.0*/
+void
+h_end_omp_teams( OPARI2_Directive* d_base,
+                 ostream&          os )
+{
+    exit_handler_enter_exit( cast2omp( d_base ), "teams", os );
+}
+
+/*4.0*/
+void
+h_omp_distribute( OPARI2_Directive* d_base,
+                  ostream&          os )
+{
+    enter_handler_enter_exit( cast2omp( d_base ), "distribute", os );
+}
+
+/*4.0*/
+void
+h_end_omp_distribute( OPARI2_Directive* d_base,
+                      ostream&          os )
+{
+    exit_handler_enter_exit( cast2omp( d_base ), "distribute", os );
+}
+
+/**
+ * Note: The taskloop region is instrumented for the encountering task
+ * only, the tasks generated for the loop chunks are created by the
+ * runtime and cannot be instrumented.
+ */
+/*4.5*/
+void
+h_omp_taskloop( OPARI2_Directive* d_base,
+                ostream&          os )
+{
+    enter_handler_enter_exit( cast2omp( d_base ), "taskloop", os );
+}
+
+/*4.5*/
+void
+h_end_omp_taskloop( OPARI2_Directive* d_base,
+                    ostream&          os )
+{
+    exit_handler_enter_exit( cast2omp( d_base ), "taskloop", os );
+}
+
 void
 h_omp_threadprivate( OPARI2_Directive* d_base,
                      ostream&          os )
@@ -2113,3 +2545,11 @@ h_omp_threadprivate( OPARI2_Directive* d_base,
 
     d->PrintDirective( os );
 }
+
+void
+reset_omp_handler( void )
+{
+    in_workshare = false;
+}
+
+} /* namespace opari2 */
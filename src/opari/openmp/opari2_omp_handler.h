@@ -52,6 +52,8 @@
 #include <iostream>
 using std::ostream;
 
+namespace opari2
+{
 
 void
 h_omp_parallel( OPARI2_Directive* d,
@@ -221,6 +223,99 @@ void
 h_omp_taskwait( OPARI2_Directive* d,
                 ostream&          os );
 
+void
+h_omp_taskyield( OPARI2_Directive* d,
+                 ostream&          os );
+
+void
+h_omp_taskgroup( OPARI2_Directive* d,
+                 ostream&          os );
+
+void
+h_end_omp_taskgroup( OPARI2_Directive* d,
+                     ostream&          os );
+
+void
+h_omp_cancel( OPARI2_Directive* d,
+              ostream&          os );
+
+void
+h_omp_cancellationpoint( OPARI2_Directive* d,
+                         ostream&          os );
+
+void
+h_omp_simd( OPARI2_Directive* d,
+            ostream&          os );
+
+void
+h_end_omp_simd( OPARI2_Directive* d,
+                ostream&          os );
+
+void
+h_omp_forsimd( OPARI2_Directive* d,
+               ostream&          os );
+
+void
+h_end_omp_forsimd( OPARI2_Directive* d,
+                   ostream&          os );
+
+void
+h_omp_dosimd( OPARI2_Directive* d,
+              ostream&          os );
+
+void
+h_end_omp_dosimd( OPARI2_Directive* d,
+                  ostream&          os );
+
+void
+h_omp_parallelforsimd( OPARI2_Directive* d,
+                       ostream&          os );
+
+void
+h_end_omp_parallelforsimd( OPARI2_Directive* d,
+                           ostream&          os );
+
+void
+h_omp_paralleldosimd( OPARI2_Directive* d,
+                      ostream&          os );
+
+void
+h_end_omp_paralleldosimd( OPARI2_Directive* d,
+                          ostream&          os );
+
+void
+h_omp_target( OPARI2_Directive* d,
+              ostream&          os );
+
+void
+h_end_omp_target( OPARI2_Directive* d,
+                  ostream&          os );
+
+void
+h_omp_teams( OPARI2_Directive* d,
+             ostream&          os );
+
+void
+h_end_omp_teams( OPARI2_Directive* d,
+                 ostream&          os );
+
+void
+h_omp_distribute( OPARI2_Directive* d,
+                  ostream&          os );
+
+void
+h_end_omp_distribute( OPARI2_Directive* d,
+                      ostream&          os );
+
+void
+h_omp_taskloop( OPARI2_Directive* d,
+                ostream&          os );
+
+void
+h_end_omp_taskloop( OPARI2_Directive* d,
+                    ostream&          os );
+
+
 void
 h_omp_threadprivate( OPARI2_Directive* d,
                      ostream&          os );
@@ -234,4 +329,10 @@ extra_openmp_atomic_handler( OPARI2_Directive* d,
 void
 finalize_handler( ostream& os );
 
+/** @brief Reset the handler state before the next file */
+void
+reset_omp_handler( void );
+
+} /* namespace opari2 */
+
 #endif
@@ -37,7 +37,7 @@ typedef struct
     const string mGroupName;
 } OPARI2_POMPGroupStringMapEntry;
 
-OPARI2_POMPGroupStringMapEntry pompGroupStringMap[] =
+static OPARI2_POMPGroupStringMapEntry pompGroupStringMap[] =
 {
     { G_POMP_REGION, "userRegion" },
     { G_POMP_ALL,    "pomp"       },
@@ -123,6 +123,34 @@ OPARI2_DirectivePomp::GenerateDescr( ostream& os )
     }
 }
 
+/** @brief Functions of the POMP2 user library called by instrumented
+    Fortran code */
+static const OPARI2_BindCInterface bind_c_functions[] =
+{
+    { "POMP2_Init",               "POMP2_Init",               "",   NULL },
+    { "POMP2_Finalize",           "POMP2_Finalize",           "",   NULL },
+    { "POMP2_On",                 "POMP2_On",                 "",   NULL },
+    { "POMP2_Off",                "POMP2_Off",                "",   NULL },
+    { "POMP2_Begin",              "POMP2_Begin",              "rc", NULL },
+    { "POMP2_End",                "POMP2_End",                "r",  NULL },
+    { "POMP2_USER_Assign_handle", "POMP2_USER_Assign_handle", "rc", NULL }
+};
+
+
+void
+OPARI2_DirectivePomp::FinalizeDescrs( ostream& os )
+{
+    if ( s_bind_c && ( s_lang & L_FORTRAN ) )
+    {
+        os << "\n      interface\n";
+        for ( size_t i = 0; i < sizeof( bind_c_functions ) / sizeof( bind_c_functions[ 0 ] ); ++i )
+        {
+            generate_bind_c_interface( os, bind_c_functions[ i ] );
+        }
+        os << "      end interface\n";
+    }
+}
+
 /**
  * @brief Generate a function to allow initialization of all region handles for Fortran.
  *
@@ -137,6 +165,14 @@ OPARI2_DirectivePomp::GenerateInitHandleCalls( ostream&     os,
     return;
 }
 
+void
+OPARI2_DirectivePomp::ResetRegions( void )
+{
+    s_init_handle_calls.str( "" );
+    s_init_handle_calls.clear();
+    s_num_regions = 0;
+}
+
 
 void
 OPARI2_DirectivePomp::FindName( void )
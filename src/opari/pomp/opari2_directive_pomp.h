@@ -67,6 +67,15 @@ public:
     GenerateInitHandleCalls( ostream&     os,
                              const string incfile = "" );
 
+    /** @brief Declare the user instrumentation functions in the
+     *         Fortran include file, see --fortran-bind-c */
+    static void
+    FinalizeDescrs( ostream& os );
+
+    /** @brief Forget the regions of the previous file */
+    static void
+    ResetRegions( void );
+
     virtual void
     FindName( void );
 
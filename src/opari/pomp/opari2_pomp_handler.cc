@@ -29,9 +29,10 @@ using std::cerr;
 #include "opari2_directive_pomp.h"
 #include "opari2_directive_manager.h"
 
-extern OPARI2_Option_t opt;
+namespace opari2
+{
 
-OPARI2_DirectivePomp*
+static OPARI2_DirectivePomp*
 cast2pomp( OPARI2_Directive* d_base )
 {
     OPARI2_DirectivePomp* d = dynamic_cast<OPARI2_DirectivePomp*>( d_base );
@@ -267,3 +268,5 @@ h_pomp_instend( OPARI2_Directive* d_base,
         d->ResetSourceInfo( os );
     }
 }
+
+} /* namespace opari2 */
@@ -23,6 +23,8 @@
 #include <iostream>
 using std::ostream;
 
+namespace opari2
+{
 
 void
 h_pomp_inst( OPARI2_Directive* ptr,
@@ -72,4 +74,6 @@ void
 h_end_pomp_instbegin( OPARI2_Directive* ptr,
                       ostream&          os );
 
+} /* namespace opari2 */
+
 #endif
@@ -0,0 +1,273 @@
+# This file is part of the Score-P software (http://www.score-p.org)
+#
+# Copyright (c) 2009-2011,
+#    *    RWTH Aachen University, Germany
+#    *    Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+#    *    Technische Universitaet Dresden, Germany
+#    *    University of Oregon, Eugene, USA
+#    *    Forschungszentrum Juelich GmbH, Germany
+#    *    German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+#    *    Technische Universitaet Muenchen, Germany
+#
+# See the COPYING file in the package base directory for details.
+
+# Generates a synthetic OpenMP source file for throughput measurements
+# of opari2. Usage:
+#
+#   awk -f generate_source.awk -v lang=c|c++|f90|f -v lines=<n> \
+#       [-v density=<percent>] [-v continuations=<n>] [-v nesting=<n>]
+#
+# The file consists of functions, each holding one kernel of <nesting>
+# nested parallel regions around a worksharing loop, a critical and an
+# atomic construct, followed by plain statements. The number of plain
+# statements is chosen so that about <density> percent of all lines are
+# directive lines. Every parallel directive is continued over
+# <continuations> additional lines. Generation stops after the function
+# that exceeds <lines> lines; Fortran files end with a main program.
+
+BEGIN {
+    if ( lang == "" )          lang = "c"
+    if ( lines == "" )         lines = 10000
+    if ( density == "" )       density = 5
+    if ( continuations == "" ) continuations = 2
+    if ( nesting == "" )       nesting = 2
+    if ( density <= 0 || density > 100 || nesting < 1 || continuations < 0 )
+    {
+        print "generate_source.awk: invalid parameters" > "/dev/stderr"
+        exit 1
+    }
+
+    fortran = ( lang == "f90" || lang == "f" )
+    fixed   = ( lang == "f" )
+    comment = fortran ? "!" : "//"
+
+    written = 0
+    header()
+    for ( f = 0; written < lines; ++f )
+    {
+        function_begin( f )
+        directives = kernel( f )
+        # plain statements to reach the requested directive density
+        filler = int( directives * 100 / density ) - directives
+        for ( i = 0; i < filler; ++i )
+        {
+            statement( f, i )
+        }
+        function_end( f )
+    }
+    footer( f )
+}
+
+function emit( text )
+{
+    print text
+    written++
+}
+
+# Fortran fixed form statements start in column 7
+function stmt( indent, text )
+{
+    if ( fixed )
+    {
+        emit( "      " sprintf( "%" indent "s", "" ) text )
+    }
+    else
+    {
+        emit( sprintf( "%" ( indent + 4 ) "s", "" ) text )
+    }
+}
+
+# Emits a directive with <cont> continuation lines, returns the lines
+function directive( indent, name, clauses, cont,    i, n )
+{
+    if ( fortran )
+    {
+        if ( cont == 0 )
+        {
+            emit( "!$omp " name " " clauses[ 0 ] )
+            return 1
+        }
+        emit( "!$omp " name ( fixed ? "" : " &" ) )
+        for ( i = 0; i < cont; ++i )
+        {
+            n = clauses[ i % 3 ] ( i < cont - 1 && !fixed ? " &" : "" )
+            emit( fixed ? "!$omp+ " n : "!$omp& " n )
+        }
+        return cont + 1
+    }
+    if ( cont == 0 )
+    {
+        emit( sprintf( "%" indent "s", "" ) "#pragma omp " name " " clauses[ 0 ] )
+        return 1
+    }
+    emit( sprintf( "%" indent "s", "" ) "#pragma omp " name " \\" )
+    for ( i = 0; i < cont; ++i )
+    {
+        emit( sprintf( "%" ( indent + 4 ) "s", "" ) clauses[ i % 3 ] ( i < cont - 1 ? " \\" : "" ) )
+    }
+    return cont + 1
+}
+
+function header()
+{
+    if ( fortran )
+    {
+        emit( "! generated by generate_source.awk" )
+        return
+    }
+    emit( "/* generated by generate_source.awk */" )
+    emit( "#include <stdio.h>" )
+    emit( "" )
+}
+
+function function_begin( f )
+{
+    if ( fortran )
+    {
+        stmt( 0, "subroutine kernel_" f "( a, n )" )
+        stmt( 4, "integer :: n, i, k" )
+        stmt( 4, "real(8) :: a(n), s" )
+        stmt( 4, "s = 0" )
+        return
+    }
+    emit( "void" )
+    emit( "kernel_" f "( double* a, int n )" )
+    emit( "{" )
+    emit( "    int    i, k;" )
+    emit( "    double s = 0.0;" )
+}
+
+function function_end( f )
+{
+    if ( fortran )
+    {
+        stmt( 0, "end subroutine kernel_" f )
+        emit( "" )
+        return
+    }
+    emit( "}" )
+    emit( "" )
+}
+
+# Emits the nested OpenMP constructs, returns the number of directive lines
+function kernel( f,    d, n, indent, clauses )
+{
+    n = 0
+    clauses[ 0 ] = "private( i, k )"
+    clauses[ 1 ] = "shared( a, n )"
+    clauses[ 2 ] = "firstprivate( s )"
+    if ( fortran )
+    {
+        clauses[ 0 ] = "private(i, k)"
+        clauses[ 1 ] = "shared(a, n)"
+        clauses[ 2 ] = "firstprivate(s)"
+    }
+    for ( d = 0; d < nesting; ++d )
+    {
+        indent = 4 * ( d + 1 )
+        n     += directive( indent, "parallel", clauses, continuations )
+        if ( !fortran )
+        {
+            emit( sprintf( "%" indent "s", "" ) "{" )
+        }
+    }
+    indent = 4 * ( nesting + 1 )
+    if ( fortran )
+    {
+        emit( "!$omp do reduction(+:s)" )
+        stmt( indent, "do i = 1, n" )
+        stmt( indent + 3, "s = s + a(i)" )
+        stmt( indent, "end do" )
+        emit( "!$omp end do" )
+        emit( "!$omp critical (kernel_" f ")" )
+        stmt( indent, "a(1) = a(1) + s" )
+        emit( "!$omp end critical (kernel_" f ")" )
+        emit( "!$omp atomic" )
+        stmt( indent, "a(2) = a(2) + 1" )
+        n += 5
+        for ( d = 0; d < nesting; ++d )
+        {
+            emit( "!$omp end parallel" )
+            n++
+        }
+        return n
+    }
+    emit( sprintf( "%" indent "s", "" ) "#pragma omp for reduction( + : s )" )
+    emit( sprintf( "%" indent "s", "" ) "for ( i = 0; i < n; i++ )" )
+    emit( sprintf( "%" indent "s", "" ) "{" )
+    emit( sprintf( "%" ( indent + 4 ) "s", "" ) "s += a[ i ];" )
+    emit( sprintf( "%" indent "s", "" ) "}" )
+    emit( sprintf( "%" indent "s", "" ) "#pragma omp critical ( kernel_" f " )" )
+    emit( sprintf( "%" indent "s", "" ) "a[ 0 ] += s;" )
+    emit( sprintf( "%" indent "s", "" ) "#pragma omp atomic" )
+    emit( sprintf( "%" indent "s", "" ) "a[ 1 ] += 1.0;" )
+    n += 3
+    for ( d = nesting - 1; d >= 0; --d )
+    {
+        emit( sprintf( "%" ( 4 * ( d + 1 ) ) "s", "" ) "}" )
+    }
+    return n
+}
+
+# Plain statements, comments and strings the parsers have to skip
+function statement( f, i )
+{
+    if ( i % 4 == 0 )
+    {
+        if ( lang == "c" )
+        {
+            stmt( 0, "/* statement " i ": #pragma omp parallel in a comment */" )
+        }
+        else
+        {
+            stmt( 0, comment " statement " i ": !$omp parallel in a comment" )
+        }
+    }
+    else if ( i % 4 == 1 )
+    {
+        if ( fortran )
+        {
+            stmt( 0, "print *, \"!$omp barrier in a string\", " i )
+        }
+        else
+        {
+            stmt( 0, "printf( \"#pragma omp barrier in a string %d\\n\", " i " );" )
+        }
+    }
+    else if ( fortran )
+    {
+        stmt( 0, "a(" ( i % 7 + 1 ) ") = a(" ( i % 5 + 1 ) ") * 0.5 + " i )
+    }
+    else
+    {
+        stmt( 0, "a[ " ( i % 7 ) " ] = a[ " ( i % 5 ) " ] * 0.5 + " i ";" )
+    }
+}
+
+function footer( f,    k )
+{
+    if ( !fortran )
+    {
+        emit( "int" )
+        emit( "main( void )" )
+        emit( "{" )
+        emit( "    double a[ 8 ] = { 0 };" )
+        for ( k = 0; k < f && k < 16; ++k )
+        {
+            emit( "    kernel_" k "( a, 8 );" )
+        }
+        emit( "    printf( \"%f\\n\", a[ 0 ] );" )
+        emit( "    return 0;" )
+        emit( "}" )
+        return
+    }
+    stmt( 0, "program main" )
+    stmt( 4, "real(8) :: a(8)" )
+    stmt( 4, "a = 0" )
+    for ( k = 0; k < f && k < 16; ++k )
+    {
+        stmt( 4, "call kernel_" k "( a, 8 )" )
+    }
+    stmt( 4, "print *, a(1)" )
+    stmt( 0, "end program main" )
+}
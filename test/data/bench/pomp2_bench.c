@@ -0,0 +1,344 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2011,
+ *    RWTH Aachen University, Germany
+ *    Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *    Technische Universitaet Dresden, Germany
+ *    University of Oregon, Eugene, USA
+ *    Forschungszentrum Juelich GmbH, Germany
+ *    German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *    Technische Universitaet Muenchen, Germany
+ *
+ * See the COPYING file in the package base directory for details.
+ *
+ */
+/**
+ * @file        pomp2_bench.c
+ *
+ * @brief       Measures the cost per call of the POMP2 events of the
+ *              linked measurement library for thread counts from 1 to
+ *              the number of processors.
+ *
+ *              The events are called directly, without the OpenMP
+ *              constructs they usually surround, so the numbers are the
+ *              pure library overhead. Tracing output of the library is
+ *              switched off with POMP2_Off(); profiling modes enabled
+ *              via the environment stay active and are measured as
+ *              well. The parallel region is measured as a whole,
+ *              instrumented as by opari2 and uninstrumented.
+ *
+ *              Usage: pomp2_bench [calls per thread]
+ */
+
+#include <opari2/pomp2_lib.h>
+#include <opari2/pomp2_user_lib.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_CALLS   200000
+#define BENCH_REGIONS 2000
+
+#define BENCH_CTC( type, line ) \
+    "0*regionType=" type "*sscl=pomp2_bench.c:" line ":" line "*escl=pomp2_bench.c:" line ":" line "**"
+
+static POMP2_Region_handle bench_parallel = NULL;
+static POMP2_Region_handle bench_atomic   = NULL;
+static POMP2_Region_handle bench_barrier  = NULL;
+static POMP2_Region_handle bench_critical = NULL;
+static POMP2_Region_handle bench_flush    = NULL;
+static POMP2_Region_handle bench_for      = NULL;
+static POMP2_Region_handle bench_master   = NULL;
+static POMP2_Region_handle bench_single   = NULL;
+static POMP2_Region_handle bench_task     = NULL;
+
+#define bench_parallel_ctc BENCH_CTC( "parallel", "1" )
+#define bench_atomic_ctc   BENCH_CTC( "atomic", "2" )
+#define bench_barrier_ctc  BENCH_CTC( "barrier", "3" )
+#define bench_critical_ctc BENCH_CTC( "critical", "4" )
+#define bench_flush_ctc    BENCH_CTC( "flush", "5" )
+#define bench_for_ctc      "0*regionType=for*sscl=pomp2_bench.c:6:6*escl=pomp2_bench.c:6:6*hasSchedule=static**"
+#define bench_master_ctc   BENCH_CTC( "master", "7" )
+#define bench_single_ctc   BENCH_CTC( "single", "8" )
+#define bench_task_ctc     BENCH_CTC( "task", "9" )
+
+/** Found by the awk script of opari2-config like the initialization
+ *  functions in instrumented include files */
+void
+POMP2_Init_reg_pomp2bench_9( void )
+{
+    POMP2_Assign_handle( &bench_parallel, bench_parallel_ctc );
+    POMP2_Assign_handle( &bench_atomic, bench_atomic_ctc );
+    POMP2_Assign_handle( &bench_barrier, bench_barrier_ctc );
+    POMP2_Assign_handle( &bench_critical, bench_critical_ctc );
+    POMP2_Assign_handle( &bench_flush, bench_flush_ctc );
+    POMP2_Assign_handle( &bench_for, bench_for_ctc );
+    POMP2_Assign_handle( &bench_master, bench_master_ctc );
+    POMP2_Assign_handle( &bench_single, bench_single_ctc );
+    POMP2_Assign_handle( &bench_task, bench_task_ctc );
+}
+
+/** Written in the measured parallel regions, so that they are not
+ *  optimized away */
+static volatile int bench_sink;
+
+/** One lock per thread, so the lock events are not contended */
+static omp_lock_t* bench_locks;
+
+static void
+bench_empty( int thread )
+{
+}
+
+static void
+bench_atomic_events( int thread )
+{
+    POMP2_Atomic_enter( &bench_atomic, bench_atomic_ctc );
+    POMP2_Atomic_exit( &bench_atomic );
+}
+
+static void
+bench_barrier_events( int thread )
+{
+    POMP2_Task_handle pomp2_old_task;
+
+    POMP2_Barrier_enter( &bench_barrier, &pomp2_old_task, bench_barrier_ctc );
+    POMP2_Barrier_exit( &bench_barrier, pomp2_old_task );
+}
+
+static void
+bench_critical_events( int thread )
+{
+    POMP2_Critical_enter( &bench_critical, bench_critical_ctc );
+    POMP2_Critical_begin( &bench_critical );
+    POMP2_Critical_end( &bench_critical );
+    POMP2_Critical_exit( &bench_critical );
+}
+
+static void
+bench_flush_events( int thread )
+{
+    POMP2_Flush_enter( &bench_flush, bench_flush_ctc );
+    POMP2_Flush_exit( &bench_flush );
+}
+
+static void
+bench_for_events( int thread )
+{
+    POMP2_For_enter( &bench_for, bench_for_ctc );
+    POMP2_For_exit( &bench_for );
+}
+
+static void
+bench_master_events( int thread )
+{
+    POMP2_Master_begin( &bench_master, bench_master_ctc );
+    POMP2_Master_end( &bench_master );
+}
+
+static void
+bench_single_events( int thread )
+{
+    POMP2_Single_enter( &bench_single, bench_single_ctc );
+    POMP2_Single_begin( &bench_single );
+    POMP2_Single_end( &bench_single );
+    POMP2_Single_exit( &bench_single );
+}
+
+static void
+bench_task_events( int thread )
+{
+    POMP2_Task_handle pomp2_old_task;
+    POMP2_Task_handle pomp2_new_task;
+
+    POMP2_Task_create_begin( &bench_task, &pomp2_new_task, &pomp2_old_task, 1, bench_task_ctc );
+    POMP2_Task_begin( &bench_task, pomp2_new_task );
+    POMP2_Task_end( &bench_task );
+    POMP2_Task_create_end( &bench_task, pomp2_old_task );
+}
+
+static void
+bench_lock_events( int thread )
+{
+    POMP2_Set_lock( &bench_locks[ thread ] );
+    POMP2_Unset_lock( &bench_locks[ thread ] );
+}
+
+static void
+bench_plain_lock( int thread )
+{
+    omp_set_lock( &bench_locks[ thread ] );
+    omp_unset_lock( &bench_locks[ thread ] );
+}
+
+/** @brief A sequence of events measured as a unit */
+typedef struct
+{
+    /** name printed in the report */
+    const char* name;
+    /** number of POMP2 calls per execution of the kernel */
+    int         calls;
+    void ( * kernel )( int thread );
+} bench_event;
+
+static const bench_event bench_events[] =
+{
+    { "empty",    1, bench_empty           },
+    { "atomic",   2, bench_atomic_events   },
+    { "barrier",  2, bench_barrier_events  },
+    { "critical", 4, bench_critical_events },
+    { "flush",    2, bench_flush_events    },
+    { "for",      2, bench_for_events      },
+    { "master",   2, bench_master_events   },
+    { "single",   4, bench_single_events   },
+    { "task",     4, bench_task_events     },
+    { "lock",     2, bench_lock_events     },
+    { "omp_lock", 2, bench_plain_lock      }
+};
+
+/** Returns the mean time in seconds per call of the POMP2 functions of
+ *  @a event, executed concurrently by @a threads threads */
+static double
+measure_event( const bench_event* event,
+               int                threads,
+               long               repetitions )
+{
+    double time = 0.0;
+
+#pragma omp parallel num_threads( threads ) reduction( + : time )
+    {
+        int    thread = omp_get_thread_num();
+        double start;
+        long   i;
+
+#pragma omp barrier
+        start = omp_get_wtime();
+        for ( i = 0; i < repetitions; ++i )
+        {
+            event->kernel( thread );
+        }
+        time = omp_get_wtime() - start;
+    }
+    return time / ( threads * repetitions * event->calls );
+}
+
+/** Returns the mean time in seconds of an instrumented parallel region */
+static double
+measure_instrumented_parallel( int  threads,
+                               long repetitions )
+{
+    double start = omp_get_wtime();
+    long   i;
+
+    for ( i = 0; i < repetitions; ++i )
+    {
+        POMP2_Task_handle pomp2_old_task;
+
+        POMP2_Parallel_fork( &bench_parallel, 1, threads, &pomp2_old_task, bench_parallel_ctc );
+#pragma omp parallel firstprivate( pomp2_old_task ) num_threads( threads )
+        {
+            POMP2_Parallel_begin( &bench_parallel );
+            bench_sink = 0;
+            {
+                POMP2_Task_handle pomp2_old_task;
+                POMP2_Implicit_barrier_enter( &bench_parallel, &pomp2_old_task );
+#pragma omp barrier
+                POMP2_Implicit_barrier_exit( &bench_parallel, pomp2_old_task );
+            }
+            POMP2_Parallel_end( &bench_parallel );
+        }
+        POMP2_Parallel_join( &bench_parallel, pomp2_old_task );
+    }
+    return ( omp_get_wtime() - start ) / repetitions;
+}
+
+/** Returns the thread count measured after @a threads: powers of two,
+ *  followed by the number of processors */
+static int
+next_thread_count( int threads,
+                   int max_threads )
+{
+    if ( threads < max_threads && 2 * threads > max_threads )
+    {
+        return max_threads;
+    }
+    return 2 * threads;
+}
+
+/** Returns the mean time in seconds of an uninstrumented parallel region */
+static double
+measure_plain_parallel( int  threads,
+                        long repetitions )
+{
+    double start = omp_get_wtime();
+    long   i;
+
+    for ( i = 0; i < repetitions; ++i )
+    {
+#pragma omp parallel num_threads( threads )
+        {
+            bench_sink = 0;
+        }
+    }
+    return ( omp_get_wtime() - start ) / repetitions;
+}
+
+int
+main( int argc, char** argv )
+{
+    const size_t n_events    = sizeof( bench_events ) / sizeof( bench_events[ 0 ] );
+    long         calls       = BENCH_CALLS;
+    int          max_threads = omp_get_num_procs();
+    int          threads;
+    size_t       i;
+
+    if ( argc > 1 )
+    {
+        calls = atol( argv[ 1 ] );
+        if ( calls <= 0 )
+        {
+            fprintf( stderr, "Usage: %s [calls per thread]\n", argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    omp_set_dynamic( 0 );
+    POMP2_Init();
+    POMP2_Off();
+
+    bench_locks = malloc( max_threads * sizeof( omp_lock_t ) );
+    if ( !bench_locks )
+    {
+        fprintf( stderr, "Out of memory\n" );
+        return 1;
+    }
+    for ( threads = 0; threads < max_threads; ++threads )
+    {
+        omp_init_lock( &bench_locks[ threads ] );
+    }
+
+    printf( "# %-18s %7s %12s\n", "event", "threads", "ns/call" );
+    for ( threads = 1; threads <= max_threads; threads = next_thread_count( threads, max_threads ) )
+    {
+        double instrumented, plain;
+
+        for ( i = 0; i < n_events; ++i )
+        {
+            printf( "  %-18s %7d %12.1f\n", bench_events[ i ].name, threads,
+                    1e9 * measure_event( &bench_events[ i ], threads, calls ) );
+        }
+        instrumented = measure_instrumented_parallel( threads, BENCH_REGIONS );
+        plain        = measure_plain_parallel( threads, BENCH_REGIONS );
+        printf( "  %-18s %7d %12.1f\n", "parallel", threads, 1e9 * instrumented );
+        printf( "  %-18s %7d %12.1f\n", "omp_parallel", threads, 1e9 * plain );
+        fflush( stdout );
+    }
+
+    for ( threads = 0; threads < max_threads; ++threads )
+    {
+        omp_destroy_lock( &bench_locks[ threads ] );
+    }
+    free( bench_locks );
+    return 0;
+}
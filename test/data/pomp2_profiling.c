@@ -0,0 +1,100 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2011,
+ *    RWTH Aachen University, Germany
+ *    Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *    Technische Universitaet Dresden, Germany
+ *    University of Oregon, Eugene, USA
+ *    Forschungszentrum Juelich GmbH, Germany
+ *    German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *    Technische Universitaet Muenchen, Germany
+ *
+ * See the COPYING file in the package base directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ *
+ * @brief Exercises the profiling modes of the dummy POMP2 library.
+ *
+ * Run with four threads, every construct executes a fixed number of
+ * times, so the counts in the profile summaries are deterministic, see
+ * test/pomp2_lib_test.sh.in.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+static int
+work( int n )
+{
+  int j;
+  int local = 0;
+  for(j=0; j<n; ++j) {
+    local += j % 7;
+  }
+  return local;
+}
+
+int main() {
+  int i, k;
+  int sum = 0;
+  omp_lock_t lock;
+
+  omp_init_lock(&lock);
+ #pragma omp parallel private(i)
+ {
+   for(i=0; i<100; ++i) {
+     omp_set_lock(&lock);
+     sum += work(100);
+     omp_unset_lock(&lock);
+   }
+ }
+  omp_destroy_lock(&lock);
+
+ #pragma omp parallel private(i)
+ {
+   for(i=0; i<100; ++i) {
+     #pragma omp critical(profiled)
+     sum += work(100);
+   }
+ }
+
+ #pragma omp parallel
+ {
+   #pragma omp single
+   {
+     for(i=0; i<64; ++i) {
+       #pragma omp task firstprivate(i) shared(sum)
+       {
+         int local = work(1000 * (i % 4));
+         #pragma omp atomic
+         sum += local;
+       }
+     }
+     for(i=0; i<16; ++i) {
+       #pragma omp task untied firstprivate(i) shared(sum)
+       {
+         int local = work(1000 * (i % 4));
+         #pragma omp atomic
+         sum += local;
+       }
+     }
+   }
+ }
+
+  for(k=0; k<10; ++k) {
+   #pragma omp parallel
+   {
+     #pragma omp for schedule(static) reduction(+:sum)
+     for(i=0; i<400; ++i) {
+       sum += work(i);
+     }
+   }
+  }
+
+  printf("sum %d\n", sum);
+  return 0;
+}
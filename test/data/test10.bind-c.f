@@ -0,0 +1,30 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests --fortran-bind-c for fixed form files.
+
+      program test10
+      integer i, s
+
+      s = 0
+!$pomp inst begin(user_region)
+!$omp parallel sections if(s .eq. 0)
+!$omp section
+      write(*,*) "section 1"
+!$omp section
+      write(*,*) "section 2"
+!$omp end parallel sections
+!$omp parallel do reduction(+:s)
+      do i = 1, 10
+         s = s + i
+      end do
+!$omp end parallel do
+!$pomp inst end(user_region)
+      write(*,*) s
+      end program test10
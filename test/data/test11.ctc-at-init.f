@@ -0,0 +1,40 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests --omp-ctc-at-init for fixed form files.
+
+      program test11
+      integer i, s
+
+      s = 0
+!$omp parallel sections if(s .eq. 0)
+!$omp section
+      write(*,*) "section 1"
+!$omp section
+      write(*,*) "section 2"
+!$omp end parallel sections
+!$omp parallel do reduction(+:s)
+      do i = 1, 10
+         s = s + i
+      end do
+!$omp end parallel do
+!$omp parallel
+!$omp single
+!$omp task
+      write(*,*) "task"
+!$omp end task
+!$omp taskwait
+!$omp end single
+!$omp barrier
+!$omp critical
+      s = s + 1
+!$omp end critical
+!$omp end parallel
+      write(*,*) s
+      end program test11
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests the instrumentation of simd, taskloop, target, teams
+ *        and distribute constructs.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+int
+main()
+{
+    int    i;
+    double a[ 100 ], s = 0.0;
+
+#pragma omp parallel for simd reduction(+:s) safelen(8) schedule(static)
+    for ( i = 0; i < 100; ++i )
+        s += a[ i ];
+
+#pragma omp parallel
+    {
+#pragma omp for simd linear(i) nowait
+        for ( i = 0; i < 100; ++i )
+        {
+            a[ i ] = i;
+        }
+
+#pragma omp single
+        {
+#pragma omp taskloop grainsize(10)
+            for ( i = 0; i < 100; ++i )
+            {
+                a[ i ] *= 2.0;
+            }
+        }
+
+#pragma omp simd aligned(a)
+        for ( i = 0; i < 100; ++i )
+            a[ i ] += 1.0;
+    }
+
+#pragma omp target map(tofrom:a)
+    {
+#pragma omp parallel for
+        for ( i = 0; i < 100; ++i )
+        {
+            a[ i ] += 1.0;
+        }
+    }
+
+#pragma omp target teams distribute parallel for map(tofrom:a)
+    for ( i = 0; i < 100; ++i )
+        a[ i ] -= 1.0;
+
+#pragma omp target data map(tofrom:a)
+    {
+#pragma omp target update to(a)
+    }
+
+#pragma omp teams
+    {
+#pragma omp distribute
+        for ( i = 0; i < 100; ++i )
+        {
+            a[ i ] -= 1.0;
+        }
+    }
+
+    printf( "%f %f\n", s, a[ 0 ] );
+    return 0;
+}
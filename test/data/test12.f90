@@ -0,0 +1,73 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests the instrumentation of simd, taskloop, target, teams
+! *        and distribute constructs.
+
+program test12
+  integer :: i
+  real :: a(100), s
+
+  s = 0.0
+  !$omp parallel do simd reduction(+:s) safelen(8) schedule(static)
+  do i = 1, 100
+     s = s + a(i)
+  end do
+
+  !$omp parallel do simd
+  do i = 1, 100
+     a(i) = i
+  end do
+  !$omp end parallel do simd
+
+  !$omp parallel
+  !$omp do simd linear(i)
+  do i = 1, 100
+     a(i) = a(i) * 2.0
+  end do
+
+  !$omp single
+  !$omp taskloop grainsize(10)
+  do i = 1, 100
+     a(i) = a(i) + 1.0
+  end do
+  !$omp end taskloop
+  !$omp end single
+
+  !$omp simd
+  do i = 1, 100
+     a(i) = a(i) - 1.0
+  end do
+  !$omp end parallel
+
+  !$omp target map(tofrom:a)
+  !$omp parallel do
+  do i = 1, 100
+     a(i) = a(i) + 1.0
+  end do
+  !$omp end target
+
+  !$omp target teams distribute parallel do map(tofrom:a)
+  do i = 1, 100
+     a(i) = a(i) - 1.0
+  end do
+
+  !$omp target data map(tofrom:a)
+  !$omp target update to(a)
+  !$omp end target data
+
+  !$omp teams
+  !$omp distribute
+  do i = 1, 100
+     a(i) = a(i) - 1.0
+  end do
+  !$omp end teams
+
+  write(*,*) s, a(1)
+end program test12
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests the instrumentation of task dependencies, taskgroup,
+ *        taskyield and cancellation constructs.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+int
+main()
+{
+    int a = 0, b = 0, c[ 10 ], i;
+
+#pragma omp parallel
+    {
+#pragma omp single
+        {
+#pragma omp taskgroup
+            {
+#pragma omp task depend(out: a) shared(a)
+                a = 1;
+#pragma omp task depend(out: b) depend(inout: c[0:5], c[5]) shared(b, c)
+                {
+                    b    = 2;
+                    c[ 0 ] = 3;
+                }
+#pragma omp task depend(in: a, b) \
+                 depend(iterator(j=0:5), in: c[j]) shared(a, b)
+                {
+#pragma omp taskyield
+                    printf( "%d\n", a + b );
+                }
+            }
+        }
+
+#pragma omp cancellation point parallel
+#pragma omp cancel parallel if(a > 1)
+        printf( "not cancelled\n" );
+    }
+
+#pragma omp parallel
+    {
+#pragma omp taskgroup
+        {
+#pragma omp task
+            {
+#pragma omp cancellation point taskgroup
+#pragma omp cancel taskgroup
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests the instrumentation of task dependencies, taskgroup,
+! *        taskyield and cancellation constructs.
+
+program test13
+  integer :: a, b, c(10)
+
+  a = 0
+  b = 0
+  !$omp parallel
+  !$omp single
+  !$omp taskgroup
+  !$omp task depend(out: a) shared(a)
+  a = 1
+  !$omp end task
+  !$omp task depend(out: b) depend(inout: c(1:5), c(6)) &
+  !$omp shared(b, c)
+  b = 2
+  c(1) = 3
+  !$omp end task
+  !$omp task depend(in: a, b) shared(a, b)
+  !$omp taskyield
+  write(*,*) a + b
+  !$omp end task
+  !$omp end taskgroup
+  !$omp end single
+
+  !$omp cancellation point parallel
+  !$omp cancel parallel if(a > 1)
+  write(*,*) "not cancelled"
+  !$omp end parallel
+
+  !$omp parallel
+  !$omp taskgroup
+  !$omp task
+  !$omp cancellation point taskgroup
+  !$omp cancel taskgroup
+  !$omp end task
+  !$omp end taskgroup
+  !$omp end parallel
+end program test13
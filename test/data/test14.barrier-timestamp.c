@@ -0,0 +1,61 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2009-2011,
+ *    RWTH Aachen University, Germany
+ *    Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
+ *    Technische Universitaet Dresden, Germany
+ *    University of Oregon, Eugene, USA
+ *    Forschungszentrum Juelich GmbH, Germany
+ *    German Research School for Simulation Sciences GmbH, Juelich/Aachen, Germany
+ *    Technische Universitaet Muenchen, Germany
+ *
+ * See the COPYING file in the package base directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ *
+ * @brief Tasks executed in an implicit barrier instrumented with
+ *        --omp-barrier-timestamp=for,single.
+ *
+ * The tasks created in the single construct are executed by the threads
+ * waiting in its implicit barrier. The taskwaits before and after the
+ * construct must report the same implicit task for each thread, see
+ * test/pomp2_lib_test.sh.in.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+int main() {
+  int i;
+  int sum = 0;
+
+ #pragma omp parallel
+ {
+   #pragma omp taskwait
+
+   #pragma omp single
+   {
+     for(i=0; i<64; ++i) {
+       #pragma omp task firstprivate(i) shared(sum)
+       {
+         int j;
+         int local = 0;
+         for(j=0; j<100000; ++j) {
+           local += ( i + j ) % 7;
+         }
+         #pragma omp atomic
+         sum += local;
+       }
+     }
+   }
+
+   #pragma omp taskwait
+ }
+
+  printf("sum %d\n", sum);
+  return 0;
+}
@@ -0,0 +1,72 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests the conditional compilation resolved with
+! *        -DUSE_OMP -DLEVEL=2 -UNO_TASKS, see test/f90_test.sh.in. Dead
+! *        branches are copied unchanged, even if their directives are
+! *        incomplete.
+
+program test14
+  integer :: i, s
+
+  s = 0
+#ifdef USE_OMP
+  !$omp parallel
+  write(*,*) "taken"
+  !$omp end parallel
+#else
+  !$omp parallel
+  write(*,*) "dead"
+#endif
+
+#if defined( NO_TASKS ) || !defined USE_OMP
+  !$omp task
+#endif
+
+#if NO_TASKS + LEVEL == 2
+  !$omp barrier
+#endif
+
+#if LEVEL == 1
+  !$omp critical(level1)
+#elif LEVEL == 2
+  !$omp critical(level2)
+  s = s + 1
+  !$omp end critical(level2)
+#else
+  !$omp critical(other)
+#endif
+
+#ifndef USE_OMP
+#  if LEVEL > 1
+  !$omp single
+#  else
+  !$omp master
+#  endif
+#endif
+
+#define LOCAL_FEATURE 1
+#if LOCAL_FEATURE && !defined( NO_TASKS )
+  !$omp parallel do reduction(+:s)
+  do i = 1, 10
+     s = s + i
+  end do
+  !$omp end parallel do
+#endif
+#undef USE_OMP
+#ifdef USE_OMP
+  !$omp do
+#endif
+
+#ifdef HAVE_FLUSH
+  !$omp flush
+#endif
+
+  write(*,*) s
+end program test14
@@ -0,0 +1,45 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests --fortran-bind-c, which calls the POMP2 C functions
+! *        through bind(C) interfaces declared in the include file.
+
+program test15
+  integer :: i, s
+  integer (kind=8) :: lock
+
+  s = 0
+  !$pomp inst init
+  !$pomp inst begin(user_region)
+  !$omp parallel if(s == 0) num_threads(4)
+  !$omp do reduction(+:s)
+  do i = 1, 10
+     s = s + i
+  end do
+  !$omp end do
+  !$omp sections
+  !$omp section
+  write(*,*) "section 1"
+  !$omp section
+  write(*,*) "section 2"
+  !$omp end sections
+  !$omp critical(bind_c)
+  call omp_set_lock(lock)
+  call omp_unset_lock(lock)
+  !$omp end critical(bind_c)
+  !$omp single
+  !$omp task
+  write(*,*) "task"
+  !$omp end task
+  !$omp end single
+  !$omp end parallel
+  !$pomp inst end(user_region)
+
+  write(*,*) s
+end program test15
@@ -0,0 +1,46 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests the statistics printed with --stats. The time_* lines
+ *        are not compared, see test/c_test.sh.in.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+int
+main()
+{
+    int i, sum = 0;
+
+#pragma pomp inst init
+
+#pragma omp parallel
+    {
+#pragma omp for reduction(+:sum)
+        for ( i = 0; i < 10; ++i )
+        {
+            sum += i;
+        }
+
+#pragma omp critical
+        printf( "%d\n", omp_get_thread_num() );
+    }
+
+#pragma pomp inst begin(user_region)
+    printf( "%d\n", sum );
+#pragma pomp inst end(user_region)
+
+    return 0;
+}
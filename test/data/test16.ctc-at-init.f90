@@ -0,0 +1,53 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests --omp-ctc-at-init, which passes the CTC strings only
+! *        to POMP2_Assign_handle and calls the *_no_ctc functions.
+
+program test16
+  integer :: i, s
+
+  s = 0
+  !$omp parallel if(s == 0) num_threads(4)
+  !$omp do reduction(+:s) ordered
+  do i = 1, 10
+     !$omp ordered
+     s = s + i
+     !$omp end ordered
+  end do
+  !$omp end do
+  !$omp sections
+  !$omp section
+  write(*,*) "section 1"
+  !$omp section
+  write(*,*) "section 2"
+  !$omp end sections
+  !$omp critical(ctc_at_init)
+  s = s + 1
+  !$omp end critical(ctc_at_init)
+  !$omp atomic
+  s = s + 1
+  !$omp master
+  write(*,*) "master"
+  !$omp end master
+  !$omp barrier
+  !$omp flush
+  !$omp single
+  !$omp task
+  write(*,*) "task"
+  !$omp end task
+  !$omp taskwait
+  !$omp end single
+  !$omp workshare
+  s = s + 1
+  !$omp end workshare
+  !$omp end parallel
+
+  write(*,*) s
+end program test16
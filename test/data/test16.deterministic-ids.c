@@ -0,0 +1,37 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests --deterministic-ids and --write-if-changed: the region
+ *        names do not depend on the time or the directory, and output
+ *        files that did not change are not written again, see
+ *        test/c_test.sh.in.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+int
+main()
+{
+    int n = 0;
+
+#pragma omp parallel
+    {
+#pragma omp atomic
+        n++;
+    }
+
+    printf( "%d\n", n );
+    return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests the dependency files written with -MD, -MF and -MP. The
+ *        line directive names a header the depfile must list.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+#line 1 "test17.depfile.h"
+int value = 1;
+#line 24 "test17.depfile.c"
+
+int
+main()
+{
+#pragma omp parallel
+    printf( "%d\n", value );
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests --skip-system-headers on a preprocessed file. The
+ *        directive and the lock call in the system header stay
+ *        unchanged, the ones in the file itself are instrumented.
+ */
+# 1 "test18.input.c"
+# 1 "<built-in>"
+# 1 "<command-line>"
+# 1 "test18.input.c"
+___POMP2_INCLUDE___
+# 1 "test18.skip-system.c"
+# 1 "/usr/include/omp.h" 1 3 4
+typedef struct
+{
+    unsigned char _x[ 4 ];
+} omp_lock_t;
+
+extern void omp_set_lock( omp_lock_t* );
+extern void omp_unset_lock( omp_lock_t* );
+# 1 "/usr/include/omp_inline.h" 1 3 4
+static inline void
+omp_locked_call( omp_lock_t* lock )
+{
+#pragma omp parallel
+    omp_set_lock( lock );
+}
+# 10 "/usr/include/omp.h" 2 3 4
+# 2 "test18.skip-system.c" 2
+
+int
+main()
+{
+    omp_lock_t lock;
+
+#pragma omp parallel
+    {
+        omp_set_lock( &lock );
+        omp_unset_lock( &lock );
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests the conditional compilation resolved with
+ *        -DUSE_OMP -DLEVEL=2 -UNO_TASKS, see test/c_test.sh.in. Dead
+ *        branches are copied unchanged, even if their directives and
+ *        braces are incomplete. Branches depending on other macros are
+ *        instrumented as before.
+ */
+
+#include <stdio.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+int
+main()
+{
+    int i, sum = 0;
+
+#pragma pomp inst init
+
+/* -D */
+#ifdef USE_OMP
+#pragma omp parallel
+    {
+        printf( "taken\n" );
+    }
+#else
+#pragma omp parallel
+    {
+        printf( "dead\n" );
+#endif
+
+/* -U and defined() */
+#if defined( NO_TASKS ) || !defined USE_OMP
+#pragma omp task
+    {
+#endif
+
+/* identifiers that are no macros evaluate to 0 */
+#if NO_TASKS + LEVEL == 2
+#pragma omp barrier
+#endif
+
+/* #elif and #else chains */
+#if LEVEL == 1
+#pragma omp critical( level1 )
+#elif LEVEL == 2
+#pragma omp critical( level2 )
+    sum++;
+#elif LEVEL == 3
+#pragma omp critical( level3 )
+#else
+#pragma omp critical( other )
+#endif
+
+/* nested dead branches */
+#ifndef USE_OMP
+#  if LEVEL > 1
+#pragma omp single
+    {
+#  else
+#pragma omp master
+    {
+#  endif
+#endif
+
+/* #define and #undef in the file */
+#define LOCAL_FEATURE 1
+#if LOCAL_FEATURE && !defined( NO_TASKS )
+#pragma omp parallel for reduction(+:sum)
+    for ( i = 0; i < 10; ++i )
+    {
+        sum += i;
+    }
+#endif
+#undef USE_OMP
+#ifdef USE_OMP
+#pragma omp atomic
+    {
+#endif
+
+/* unknown macros may be set by headers */
+#ifdef HAVE_FLUSH
+#pragma omp flush
+#endif
+
+    printf( "%d\n", sum );
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ * Testfile for automated testing of OPARI2
+ *
+ * @brief Tests the lexing of C++ raw string literals and digit
+ *        separators with --c++. Braces, quotes, comments and directives
+ *        inside of them must not change the instrumentation.
+ */
+
+#include <cstdio>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+static const char* text = R"(a { b " c */ d // e)";
+static const char* delimited = u8R"xy(f )" g } ")xy";
+static const char* lines = R"(
+#pragma omp parallel
+{ "
+)";
+
+int
+main()
+{
+    long     big = 1'000'000;
+    unsigned mask = 0b1010'1010u;
+    double   ratio = 0x1'0p-4 + 3'141.5'9e-3;
+    char     quote = '\'', brace = '{';
+
+#pragma omp parallel
+    {
+        if ( big > 0'0 )
+        {
+            std::printf( R"({ %ld %u %g %c%c })" "\n", big, mask, ratio, quote, brace );
+        }
+    }
+
+#pragma omp parallel for reduction(+:big)
+    for ( int i = 0; i < 1'0; ++i )
+    {
+        big += 1'0;
+    }
+
+    std::printf( "%s %s %s %ld\n", text, delimited, lines, big );
+    return 0;
+}
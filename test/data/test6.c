@@ -25,6 +25,7 @@ int main() {
   omp_nest_lock_t  lock2;
   omp_sched_t      sched;
   int              mod;
+  void*            ptr;
 
   //**************************************************
   //* Should be replaced by wrapper functions        *
@@ -41,12 +42,18 @@ int main() {
   omp_destroy_lock(&lock1);
   omp_destroy_nest_lock(&lock2);
 
+  omp_init_lock_with_hint(&lock1, omp_lock_hint_contended);
+  omp_init_nest_lock_with_hint(&lock2, omp_lock_hint_uncontended);
+  omp_set_num_threads(4);
+  omp_get_wtime();
+  omp_target_memcpy(ptr, ptr, 8, 0, 0, omp_get_initial_device(), omp_get_initial_device());
+  ptr = omp_alloc(64, omp_default_mem_alloc); omp_free(ptr, omp_default_mem_alloc);
+
 
   //**************************************************
   //* Not now, but planned for the future!           *
   //**************************************************
 
-  omp_set_num_threads(4);
   omp_set_dynamic(0);
   omp_set_schedule(omp_sched_static, 1);
   omp_set_nested(0);
@@ -72,7 +79,6 @@ int main() {
   omp_get_team_size(0);
   omp_get_active_level();
 
-  omp_get_wtime();
   omp_get_wtick();
 
   // omp_init_lock(i)
@@ -40,12 +40,12 @@ cP$   mod = omp_test_nest_lock(lock2)
 
       call omp_destroy_lock(lock1)
       call omp_destroy_nest_lock(lock2)
+      call omp_set_num_threads(4)
 
 !     **************************************************
 !     * Not now, but planned for the future!           *
 !     **************************************************
 
-      call omp_set_num_threads(4)
       call omp_set_dynamic(.true.)
       call omp_set_schedule(omp_sched_static, 1)
       call omp_set_nested(.true.)
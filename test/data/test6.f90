@@ -24,6 +24,7 @@ integer (kind=omp_lock_kind)      lock1
 integer (kind=omp_nest_lock_kind) lock2
 integer (kind=omp_sched_kind)     sched
 integer mod
+double precision wtime
 
 ! **************************************************
 ! * Should be replaced by wrapper functions        *
@@ -42,11 +43,14 @@ call omp_unset_nest_lock(lock2)
  call omp_destroy_lock(lock1)
  call omp_destroy_nest_lock(lock2)
 
+call omp_init_lock_with_hint(lock1, omp_lock_hint_contended)
+call omp_init_nest_lock_with_hint(lock2, omp_lock_hint_uncontended)
+call omp_set_num_threads(4)
+
 ! **************************************************
 ! * Not now, but planned for the future!           *
 ! **************************************************
 
-call omp_set_num_threads(4)
 call omp_set_dynamic(.true.)
 call omp_set_schedule(omp_sched_static, 1)
 call omp_set_nested(.true.)
@@ -56,6 +60,8 @@ call omp_set_max_active_levels(2)
 ! * No replacement beyond this point!              *
 ! **************************************************
 
+wtime = omp_get_wtime()
+
 ! call omp_init_lock(i)
 
   write(*,*) "omp_init_lock(i)",  'omp_init_lock(i)'    ! call omp_init_lock(i)
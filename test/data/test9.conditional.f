@@ -0,0 +1,42 @@
+! * This file is part of the Score-P software (http://www.score-p.org)
+! *
+! * Copyright (c) 2026,
+! *    Forschungszentrum Juelich GmbH, Germany
+! *
+! * See the COPYING file in the package base directory for details.
+! *
+! * Testfile for automated testing of OPARI2
+! *
+! * @brief Tests the conditional compilation of fixed form files
+! *        resolved with -DUSE_OMP -DLEVEL=2 -UNO_TASKS, see
+! *        test/f77_test.sh.in.
+
+      program test9
+      integer i, s
+
+      s = 0
+#ifdef USE_OMP
+!$omp parallel
+      write(*,*) "taken"
+!$omp end parallel
+#else
+!$omp parallel
+      write(*,*) "dead"
+#endif
+
+#if defined( NO_TASKS ) || LEVEL != 2
+!$omp single
+#elif LEVEL == 2
+!$omp parallel do reduction(+:s)
+      do i = 1, 10
+         s = s + i
+      end do
+!$omp end parallel do
+#endif
+
+#undef USE_OMP
+#ifdef USE_OMP
+!$omp do
+#endif
+      write(*,*) s
+      end program test9
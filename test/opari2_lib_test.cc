@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2026,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+/**
+ *  @file       opari2_lib_test.cc
+ *
+ *  @brief      Instruments a C file held in memory with libopari2, see
+ *              test/opari2_lib_test.sh.in.
+ *
+ *  Usage: opari2_lib_test <file>
+ *
+ *  Writes <file without .c>.mod.c and <file>.opari.inc like the opari2
+ *  command does. Before that, it checks that a failed call and
+ *  OPARI2_ResetOptions() leave no state behind. It defines some of
+ *  the library's internal names itself to check they do not clash.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <opari2/opari2_lib.h>
+
+using std::string;
+using std::cerr;
+
+/* Names the library used to define itself. A program embedding it must
+   be free to use them, so linking this test fails if one is exported
+   again. */
+int  opt;
+int  api_table;
+int  directive_table;
+int  directive_stack;
+int  header_files_c;
+void
+cleanup_and_exit( void )
+{
+}
+
+static bool
+read_file( const string& name,
+           string&       text )
+{
+    std::ifstream     is( name.c_str() );
+    std::stringstream buffer;
+
+    buffer << is.rdbuf();
+    text = buffer.str();
+    return is.good();
+}
+
+static bool
+write_file( const string& name,
+            const string& text )
+{
+    std::ofstream os( name.c_str() );
+
+    os << text;
+    return os.good();
+}
+
+int
+main( int argc, char** argv )
+{
+    string source, output, include;
+
+    if ( argc != 2 || !read_file( argv[ 1 ], source ) )
+    {
+        cerr << "usage: opari2_lib_test <file>\n";
+        return 1;
+    }
+    string infile = argv[ 1 ];
+    string base   = infile.substr( 0, infile.rfind( ".c" ) );
+
+    /* a region that is never closed aborts the instrumentation */
+    if ( OPARI2_Instrument( "broken.c", "#pragma pomp inst begin(r)\n", output, include ) != 1 )
+    {
+        cerr << "ERROR: unclosed region not reported\n";
+        return 1;
+    }
+
+    /* --nosrc suppresses the initial line directive and --disable the
+       instrumentation of parallel regions until the options are reset */
+    if ( OPARI2_SetOption( "--nosrc" ) != 0 ||
+         OPARI2_SetOption( "--disable=omp:parallel" ) != 0 ||
+         OPARI2_SetOption( "--no-such-option" ) != 2 )
+    {
+        cerr << "ERROR: unexpected result of OPARI2_SetOption()\n";
+        return 1;
+    }
+    if ( OPARI2_Instrument( infile, source, output, include ) != 0 ||
+         output.find( "#line 1 " ) != string::npos ||
+         output.find( "POMP2_Parallel_fork" ) != string::npos )
+    {
+        cerr << "ERROR: options not applied\n";
+        return 1;
+    }
+    OPARI2_ResetOptions();
+
+    /* the options c_test.sh uses for test1.c */
+    if ( OPARI2_SetOption( "--omp-task-untied=keep,no-warn" ) != 0 ||
+         OPARI2_Instrument( infile, source, output, include ) != 0 )
+    {
+        cerr << "ERROR: cannot instrument " << infile << "\n";
+        return 1;
+    }
+    if ( !write_file( base + ".mod.c", output ) ||
+         !write_file( infile + ".opari.inc", include ) )
+    {
+        cerr << "ERROR: cannot write the output files\n";
+        return 1;
+    }
+    return 0;
+}
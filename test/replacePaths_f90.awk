@@ -29,6 +29,11 @@
                     source = source $1
                     sub("\"//&\"", "", source)
                 }
+                # --fortran-bind-c appends a null character
+                terminator = ""
+                if(sub("\"//char\\(0\\)", "\"", source)){
+                    terminator = "//char(0)"
+                }
                 #remove full path
                 gsub("escl=([^/]*/)*","escl=",source)
                 gsub("sscl=([^/]*/)*","sscl=",source)
@@ -36,7 +41,7 @@
                 sub("\"[0-9a-z]*","\"", source)
                 #insert new length
                 sub("\"", "\""length(source)-2, source)
-                line = line " " source
+                line = line " " source terminator
             }
             else{
                 line = line " " $i